@@ -118,6 +118,8 @@ public:
     boost::signal<void (const App::DocumentObject&)> signalDeletedObject;
     /// signal on changed Object
     boost::signal<void (const App::DocumentObject&, const App::Property&)> signalChangedObject;
+    /// signal on changed touched or error state of an Object
+    boost::signal<void (const App::DocumentObject&)> signalChangedObjectStatus;
     /// signal on relabeled Object
     boost::signal<void (const App::DocumentObject&)> signalRelabelObject;
     /// signal on activated Object
@@ -289,7 +289,52 @@ std::vector<PyObject *> DocumentObject::getPySubObjects(const std::vector<std::s
 
 void DocumentObject::touch(void)
 {
+    if (StatusBits.test(0))
+        return;
     StatusBits.set(0);
+    if (_pDoc)
+        _pDoc->signalChangedObjectStatus(*this);
+}
+
+void DocumentObject::purgeTouched(void)
+{
+    bool changed = StatusBits.test(0);
+    StatusBits.reset(0);
+
+    std::vector<Property*> List;
+    getPropertyList(List);
+    for (std::vector<Property*>::const_iterator it = List.begin(); it != List.end(); ++it) {
+        if ((*it)->isTouched()) {
+            (*it)->purgeTouched();
+            changed = true;
+        }
+    }
+
+    if (changed && _pDoc)
+        _pDoc->signalChangedObjectStatus(*this);
+}
+
+void DocumentObject::setError(void)
+{
+    if (StatusBits.test(1))
+        return;
+    StatusBits.set(1);
+    if (_pDoc)
+        _pDoc->signalChangedObjectStatus(*this);
+}
+
+void DocumentObject::resetError(void)
+{
+    if (!StatusBits.test(1))
+        return;
+    StatusBits.reset(1);
+    if (_pDoc)
+        _pDoc->signalChangedObjectStatus(*this);
+}
+
+void DocumentObject::purgeError(void)
+{
+    resetError();
 }
 
 /**
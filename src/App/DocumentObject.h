@@ -109,12 +109,12 @@ public:
     /// test if this feature is touched
     bool isTouched(void) const;
     /// reset this feature touched
-    void purgeTouched(void){StatusBits.reset(0);setPropertyStatus(0,false);}
+    void purgeTouched(void);
     /// set this feature to error
     bool isError(void) const {return  StatusBits.test(1);}
     bool isValid(void) const {return !StatusBits.test(1);}
     /// remove the error from the object
-    void purgeError(void){StatusBits.reset(1);}
+    void purgeError(void);
     /// returns true if this objects is currently recomputing
     bool isRecomputing() const {return StatusBits.test(3);}
     /// returns true if this objects is currently restoring from file
@@ -226,8 +226,8 @@ protected:
      */
     std::bitset<32> StatusBits;
 
-    void setError(void){StatusBits.set(1);}
-    void resetError(void){StatusBits.reset(1);}
+    void setError(void);
+    void resetError(void);
     void setDocument(App::Document* doc);
 
     /// get called before the value is changed
@@ -120,12 +120,19 @@ void DynamicProperty::addDynamicProperties(const PropertyContainer* cont)
     }
 }
 
+DynamicProperty::PropDataIterator DynamicProperty::findProperty(const Property* prop) const
+{
+    std::map<const Property*, PropDataIterator>::const_iterator it = propIndex.find(prop);
+    if (it != propIndex.end())
+        return it->second;
+    return props.end();
+}
+
 const char* DynamicProperty::getPropertyName(const Property* prop) const
 {
-    for (std::map<std::string,PropData>::const_iterator it = props.begin(); it != props.end(); ++it) {
-        if (it->second.property == prop)
-            return it->first.c_str();
-    }
+    PropDataIterator it = findProperty(prop);
+    if (it != props.end())
+        return it->first.c_str();
     
     if(this->pc->isDerivedFrom(App::ExtensionContainer::getClassTypeId()))
         return static_cast<App::ExtensionContainer*>(this->pc)->ExtensionContainer::getPropertyName(prop);
@@ -146,15 +153,14 @@ unsigned int DynamicProperty::getMemSize (void) const
 
 short DynamicProperty::getPropertyType(const Property* prop) const
 {
-    for (std::map<std::string,PropData>::const_iterator it = props.begin(); it != props.end(); ++it) {
-        if (it->second.property == prop) {
-            short attr = it->second.attr;
-            if (it->second.hidden)
-                attr |= Prop_Hidden;
-            if (it->second.readonly)
-                attr |= Prop_ReadOnly;
-            return attr;
-        }
+    PropDataIterator it = findProperty(prop);
+    if (it != props.end()) {
+        short attr = it->second.attr;
+        if (it->second.hidden)
+            attr |= Prop_Hidden;
+        if (it->second.readonly)
+            attr |= Prop_ReadOnly;
+        return attr;
     }
     
     if(this->pc->isDerivedFrom(App::ExtensionContainer::getClassTypeId()))
@@ -183,10 +189,9 @@ short DynamicProperty::getPropertyType(const char *name) const
 
 const char* DynamicProperty::getPropertyGroup(const Property* prop) const
 {
-    for (std::map<std::string,PropData>::const_iterator it = props.begin(); it != props.end(); ++it) {
-        if (it->second.property == prop)
-            return it->second.group.c_str();
-    }
+    PropDataIterator it = findProperty(prop);
+    if (it != props.end())
+        return it->second.group.c_str();
     
     if(this->pc->isDerivedFrom(App::ExtensionContainer::getClassTypeId()))
         return static_cast<App::ExtensionContainer*>(this->pc)->ExtensionContainer::getPropertyGroup(prop);
@@ -208,10 +213,9 @@ const char* DynamicProperty::getPropertyGroup(const char *name) const
 
 const char* DynamicProperty::getPropertyDocumentation(const Property* prop) const
 {
-    for (std::map<std::string,PropData>::const_iterator it = props.begin(); it != props.end(); ++it) {
-        if (it->second.property == prop)
-            return it->second.doc.c_str();
-    }
+    PropDataIterator it = findProperty(prop);
+    if (it != props.end())
+        return it->second.doc.c_str();
     
     if(this->pc->isDerivedFrom(App::ExtensionContainer::getClassTypeId()))
         return static_cast<App::ExtensionContainer*>(this->pc)->ExtensionContainer::getPropertyDocumentation(prop);
@@ -260,7 +264,8 @@ Property* DynamicProperty::addDynamicProperty(const char* type, const char* name
     data.attr = attr;
     data.readonly = ro;
     data.hidden = hidden;
-    props[ObjectName] = data;
+    PropDataIterator it = props.insert(std::make_pair(ObjectName, data)).first;
+    propIndex[pcProperty] = it;
 
     GetApplication().signalAppendDynamicProperty(*pcProperty);
 
@@ -272,6 +277,7 @@ bool DynamicProperty::removeDynamicProperty(const char* name)
     std::map<std::string,PropData>::iterator it = props.find(name);
     if (it != props.end()) {
         GetApplication().signalRemoveDynamicProperty(*it->second.property);
+        propIndex.erase(it->second.property);
         delete it->second.property;
         props.erase(it);
         return true;
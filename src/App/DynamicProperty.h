@@ -132,8 +132,13 @@ private:
         bool hidden;
     };
 
+    typedef std::map<std::string,PropData>::const_iterator PropDataIterator;
+    /// Finds the dynamic property by pointer instead of searching all names
+    PropDataIterator findProperty(const Property* prop) const;
+
     PropertyContainer* pc;
     std::map<std::string,PropData> props;
+    std::map<const Property*, PropDataIterator> propIndex;
 };
 
 } // namespace App
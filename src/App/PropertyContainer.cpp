@@ -276,32 +276,64 @@ void PropertyData::addProperty(OffsetBase offsetBase,const char* PropName, Prope
     temp.Type   = Type;
     temp.Docu   = PropertyDocu;
     propertyData.push_back(temp);
+    buildIndex();
   }
 }
 
-const PropertyData::PropertySpec *PropertyData::findProperty(OffsetBase offsetBase,const char* PropName) const
+void PropertyData::buildIndex()
 {
-  for (vector<PropertyData::PropertySpec>::const_iterator It = propertyData.begin(); It != propertyData.end(); ++It)
-    if(strcmp(It->Name,PropName)==0)
-      return &(*It);
+  std::size_t count = 0;
+  for (const PropertyData* data = this; data; data = data->parentPropertyData)
+    count += data->propertyData.size();
+
+  index.byName.clear();
+  index.byOffset.clear();
+  index.byName.reserve(count);
+  index.byOffset.reserve(count);
+  // a property of a sub-class hides a property of the same name of a base class
+  for (const PropertyData* data = this; data; data = data->parentPropertyData) {
+    for (vector<PropertyData::PropertySpec>::const_iterator It = data->propertyData.begin(); It != data->propertyData.end(); ++It) {
+      index.byName.insert(std::make_pair(It->Name, &(*It)));
+      index.byOffset.insert(std::make_pair(It->Offset, &(*It)));
+    }
+  }
+}
+
+const PropertyData::Index* PropertyData::getIndex() const
+{
+  // a class without own properties uses the tables of its base class
+  const PropertyData* data = this;
+  while (data && data->propertyData.empty())
+    data = data->parentPropertyData;
+  return data ? &data->index : 0;
+}
+
+const PropertyData::PropertySpec *PropertyData::findProperty(OffsetBase /*offsetBase*/,const char* PropName) const
+{
+  if (!PropName)
+    return 0;
+
+  const Index* idx = getIndex();
+  if (!idx)
+    return 0;
+  std::unordered_map<const char*, const PropertySpec*, Base::CStringHash, Base::CStringEqual>::const_iterator It = idx->byName.find(PropName);
+  if (It != idx->byName.end())
+    return It->second;
 
-  if(parentPropertyData)
-      return parentPropertyData->findProperty(offsetBase,PropName);
- 
   return 0;
 }
 
 const PropertyData::PropertySpec *PropertyData::findProperty(OffsetBase offsetBase,const Property* prop) const
 {
-  const int diff = offsetBase.getOffsetTo(prop);
+  const short diff = offsetBase.getOffsetTo(prop);
+
+  const Index* idx = getIndex();
+  if (!idx)
+    return 0;
+  std::unordered_map<short, const PropertySpec*>::const_iterator It = idx->byOffset.find(diff);
+  if (It != idx->byOffset.end())
+    return It->second;
 
-  for (vector<PropertyData::PropertySpec>::const_iterator It = propertyData.begin(); It != propertyData.end(); ++It)
-    if(diff == It->Offset)
-        return &(*It);
-  
-  if(parentPropertyData)
-      return parentPropertyData->findProperty(offsetBase,prop);
-  
   return 0;
 }
 
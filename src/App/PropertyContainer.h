@@ -25,7 +25,10 @@
 #define APP_PROPERTYCONTAINER_H
 
 #include <map>
+#include <cstring>
+#include <unordered_map>
 #include <Base/Persistence.h>
+#include <Base/CStringHash.h>
 
 namespace Base {
 class Writer;
@@ -96,6 +99,22 @@ struct AppExport PropertyData
   Property *getPropertyByName(OffsetBase offsetBase,const char* name) const;
   void getPropertyMap(OffsetBase offsetBase,std::map<std::string,Property*> &Map) const;
   void getPropertyList(OffsetBase offsetBase,std::vector<Property*> &List) const;
+
+private:
+  /** Lookup tables over the whole inheritance chain. The property specs are
+   * added by the constructor of the first object of a class, after the ones
+   * of the base classes, so the tables are rebuilt by addProperty() and the
+   * lookups only read them. This makes concurrent lookups safe.
+   */
+  struct Index
+  {
+    std::unordered_map<const char*, const PropertySpec*, Base::CStringHash, Base::CStringEqual> byName;
+    std::unordered_map<short, const PropertySpec*> byOffset;
+  };
+  Index index;
+
+  void buildIndex();
+  const Index* getIndex() const;
 };
 
 
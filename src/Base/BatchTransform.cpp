@@ -0,0 +1,191 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+#endif
+
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include "BatchTransform.h"
+
+using namespace Base;
+
+namespace {
+// Below this number of points per chunk the thread overhead isn't worth it
+const std::size_t MinChunkSize = 32768;
+}
+
+BatchTransform::BatchTransform(const Matrix4D& mat)
+{
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<4; j++)
+            m[4*i+j] = mat[i][j];
+    }
+
+    translation = (m[0] == 1.0 && m[1] == 0.0 && m[2]  == 0.0 &&
+                   m[4] == 0.0 && m[5] == 1.0 && m[6]  == 0.0 &&
+                   m[8] == 0.0 && m[9] == 0.0 && m[10] == 1.0);
+    identity = translation && m[3] == 0.0 && m[7] == 0.0 && m[11] == 0.0;
+}
+
+void BatchTransform::apply(float* xyz, std::size_t num, std::size_t stride) const
+{
+    Range all = {
+        reinterpret_cast<char*>(xyz),
+        reinterpret_cast<char*>(xyz + 1),
+        reinterpret_cast<char*>(xyz + 2),
+        stride, 0, num
+    };
+    dispatch<float>(all);
+}
+
+void BatchTransform::apply(double* xyz, std::size_t num, std::size_t stride) const
+{
+    Range all = {
+        reinterpret_cast<char*>(xyz),
+        reinterpret_cast<char*>(xyz + 1),
+        reinterpret_cast<char*>(xyz + 2),
+        stride, 0, num
+    };
+    dispatch<double>(all);
+}
+
+void BatchTransform::apply(std::vector<Vector3f>& pts) const
+{
+    if (!pts.empty())
+        apply(&pts[0].x, pts.size(), sizeof(Vector3f));
+}
+
+void BatchTransform::apply(std::vector<Vector3d>& pts) const
+{
+    if (!pts.empty())
+        apply(&pts[0].x, pts.size(), sizeof(Vector3d));
+}
+
+void BatchTransform::apply(float* x, float* y, float* z, std::size_t num) const
+{
+    Range all = {
+        reinterpret_cast<char*>(x),
+        reinterpret_cast<char*>(y),
+        reinterpret_cast<char*>(z),
+        sizeof(float), 0, num
+    };
+    dispatch<float>(all);
+}
+
+void BatchTransform::apply(double* x, double* y, double* z, std::size_t num) const
+{
+    Range all = {
+        reinterpret_cast<char*>(x),
+        reinterpret_cast<char*>(y),
+        reinterpret_cast<char*>(z),
+        sizeof(double), 0, num
+    };
+    dispatch<double>(all);
+}
+
+template <typename Real>
+void BatchTransform::dispatch(const Range& all) const
+{
+    if (identity || all.end <= all.begin)
+        return;
+
+    std::size_t num = all.end - all.begin;
+    std::size_t threads = static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+    std::size_t chunks = std::min(num / MinChunkSize, threads);
+    if (chunks < 2) {
+        Range r(all);
+        run<Real>(r);
+        return;
+    }
+
+    std::vector<Range> ranges(chunks, all);
+    std::size_t step = num / chunks;
+    for (std::size_t i=0; i<chunks; i++) {
+        ranges[i].begin = all.begin + i * step;
+        ranges[i].end = (i + 1 == chunks) ? all.end : ranges[i].begin + step;
+    }
+
+    QFuture<void> future = QtConcurrent::map
+        (ranges, boost::bind(&BatchTransform::run<Real>, this, _1));
+    future.waitForFinished();
+}
+
+template <typename Real>
+void BatchTransform::run(Range& r) const
+{
+    // local copies so that the compiler knows they don't alias the points
+    const double m00 = m[0], m01 = m[1], m02 = m[2],  m03 = m[3];
+    const double m10 = m[4], m11 = m[5], m12 = m[6],  m13 = m[7];
+    const double m20 = m[8], m21 = m[9], m22 = m[10], m23 = m[11];
+
+    if (r.stride == sizeof(Real)) {
+        // separate coordinate arrays: plain indexed loops
+        Real* px = reinterpret_cast<Real*>(r.x);
+        Real* py = reinterpret_cast<Real*>(r.y);
+        Real* pz = reinterpret_cast<Real*>(r.z);
+        if (translation) {
+            for (std::size_t i = r.begin; i < r.end; i++) {
+                px[i] = static_cast<Real>(px[i] + m03);
+                py[i] = static_cast<Real>(py[i] + m13);
+                pz[i] = static_cast<Real>(pz[i] + m23);
+            }
+        }
+        else {
+            for (std::size_t i = r.begin; i < r.end; i++) {
+                double x = px[i], y = py[i], z = pz[i];
+                px[i] = static_cast<Real>(m00*x + m01*y + m02*z + m03);
+                py[i] = static_cast<Real>(m10*x + m11*y + m12*z + m13);
+                pz[i] = static_cast<Real>(m20*x + m21*y + m22*z + m23);
+            }
+        }
+    }
+    else {
+        // interleaved coordinates, possibly with gaps between the points
+        const std::size_t stride = r.stride;
+        char* base = r.x + r.begin * stride;
+        const std::ptrdiff_t dy = r.y - r.x;
+        const std::ptrdiff_t dz = r.z - r.x;
+        for (std::size_t i = r.begin; i < r.end; i++, base += stride) {
+            Real* px = reinterpret_cast<Real*>(base);
+            Real* py = reinterpret_cast<Real*>(base + dy);
+            Real* pz = reinterpret_cast<Real*>(base + dz);
+            double x = *px, y = *py, z = *pz;
+            if (translation) {
+                *px = static_cast<Real>(x + m03);
+                *py = static_cast<Real>(y + m13);
+                *pz = static_cast<Real>(z + m23);
+            }
+            else {
+                *px = static_cast<Real>(m00*x + m01*y + m02*z + m03);
+                *py = static_cast<Real>(m10*x + m11*y + m12*z + m13);
+                *pz = static_cast<Real>(m20*x + m21*y + m22*z + m23);
+            }
+        }
+    }
+}
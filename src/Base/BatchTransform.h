@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_BATCHTRANSFORM_H
+#define BASE_BATCHTRANSFORM_H
+
+#include <cstddef>
+#include <vector>
+#include "Matrix.h"
+
+namespace Base
+{
+
+/**
+ * The BatchTransform class applies a placement matrix to large point arrays.
+ * The affine part of the matrix is copied into a flat coefficient array once
+ * so that the inner loops are free of aliasing and can be vectorized by the
+ * compiler. Pure translations and the identity are detected and handled by
+ * cheaper loops. Arrays with more than a few thousand points are split into
+ * chunks and processed by the global thread pool.
+ *
+ * The arithmetic is carried out in double precision with the same operation
+ * order as Matrix4D::operator*, so the results are identical to transforming
+ * the points one by one.
+ */
+class BaseExport BatchTransform
+{
+public:
+    explicit BatchTransform(const Matrix4D& mat);
+
+    /// True if the matrix doesn't change any point
+    bool isIdentity() const
+    { return identity; }
+    /// True if the matrix is a pure translation
+    bool isTranslation() const
+    { return translation; }
+
+    /** @name Interleaved (AoS) coordinates */
+    //@{
+    /** Transforms \a num points where the first point starts at \a xyz and
+     * consecutive points are \a stride bytes apart. This allows to pass
+     * arrays of structures that have additional members after the coordinates.
+     */
+    void apply(float* xyz, std::size_t num, std::size_t stride = 3*sizeof(float)) const;
+    void apply(double* xyz, std::size_t num, std::size_t stride = 3*sizeof(double)) const;
+    void apply(std::vector<Vector3f>& pts) const;
+    void apply(std::vector<Vector3d>& pts) const;
+    //@}
+
+    /** @name Separate (SoA) coordinates */
+    //@{
+    void apply(float* x, float* y, float* z, std::size_t num) const;
+    void apply(double* x, double* y, double* z, std::size_t num) const;
+    //@}
+
+private:
+    struct Range {
+        char* x;
+        char* y;
+        char* z;
+        std::size_t stride;
+        std::size_t begin, end;
+    };
+    template <typename Real>
+    void run(Range& r) const;
+    template <typename Real>
+    void dispatch(const Range& all) const;
+
+private:
+    double m[12];
+    bool identity;
+    bool translation;
+};
+
+} // namespace Base
+
+#endif // BASE_BATCHTRANSFORM_H
@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <cstring>
+#endif
+
+#include "BufferProtocol.h"
+#include "Exception.h"
+
+using namespace Base;
+
+namespace {
+
+/// Releases the buffer when leaving the scope
+class BufferView
+{
+public:
+    BufferView(PyObject* obj)
+    {
+        if (!PyObject_CheckBuffer(obj))
+            throw Base::TypeError("object doesn't support the buffer protocol");
+        if (PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            PyErr_Clear();
+            throw Base::TypeError("object has no C-contiguous buffer");
+        }
+    }
+    ~BufferView()
+    {
+        PyBuffer_Release(&view);
+    }
+
+    /// returns the struct format character of the items, or 0 if not supported
+    char format() const
+    {
+        const char* fmt = view.format ? view.format : "B";
+        if (*fmt == '@' || *fmt == '=') {
+            fmt++;
+        }
+        else if (*fmt == '<' || *fmt == '>' || *fmt == '!') {
+            const unsigned short one = 1;
+            bool little = *reinterpret_cast<const unsigned char*>(&one) == 1;
+            if ((*fmt == '<') != little)
+                return 0;
+            fmt++;
+        }
+        if (fmt[0] == 0 || fmt[1] != 0)
+            return 0;
+        return fmt[0];
+    }
+
+    std::size_t count() const
+    {
+        return view.itemsize > 0 ? static_cast<std::size_t>(view.len / view.itemsize) : 0;
+    }
+
+    template <typename T>
+    bool read(std::vector<T>& data) const
+    {
+        std::size_t num = count();
+        data.resize(num);
+        const char* buf = static_cast<const char*>(view.buf);
+        switch (format()) {
+        case 'f': return copy<float>(buf, num, data);
+        case 'd': return copy<double>(buf, num, data);
+        default: return readInt(buf, num, data);
+        }
+    }
+
+    template <typename T>
+    bool readInt(const char* buf, std::size_t num, std::vector<T>& data) const
+    {
+        switch (format()) {
+        case 'b': return copy<signed char>(buf, num, data);
+        case 'B': return copy<unsigned char>(buf, num, data);
+        case 'h': return copy<short>(buf, num, data);
+        case 'H': return copy<unsigned short>(buf, num, data);
+        case 'i': return copy<int>(buf, num, data);
+        case 'I': return copy<unsigned int>(buf, num, data);
+        case 'l': return copy<long>(buf, num, data);
+        case 'L': return copy<unsigned long>(buf, num, data);
+        case 'q': return copy<long long>(buf, num, data);
+        case 'Q': return copy<unsigned long long>(buf, num, data);
+        default: return false;
+        }
+    }
+
+private:
+    template <typename S, typename T>
+    bool copy(const char* buf, std::size_t num, std::vector<T>& data) const
+    {
+        if (view.itemsize != static_cast<Py_ssize_t>(sizeof(S)))
+            return false;
+        // the buffer may not be aligned for S
+        for (std::size_t i=0; i<num; i++) {
+            S value;
+            memcpy(&value, buf + i * sizeof(S), sizeof(S));
+            data[i] = static_cast<T>(value);
+        }
+        return true;
+    }
+
+private:
+    Py_buffer view;
+};
+
+}
+
+void BufferProtocol::getDoubles(PyObject* obj, std::size_t components, std::vector<double>& data)
+{
+    BufferView view(obj);
+    if (view.count() % components != 0)
+        throw Base::ValueError("number of values is not a multiple of the number of components");
+    if (!view.read(data))
+        throw Base::TypeError("unsupported number format of buffer");
+}
+
+void BufferProtocol::getIndices(PyObject* obj, std::size_t components, std::vector<unsigned long>& data)
+{
+    BufferView view(obj);
+    if (view.count() % components != 0)
+        throw Base::ValueError("number of values is not a multiple of the number of components");
+
+    // read signed to detect negative numbers
+    std::vector<long long> values;
+    if (view.format() == 'f' || view.format() == 'd' || !view.read(values))
+        throw Base::TypeError("unsupported integer format of buffer");
+
+    data.resize(values.size());
+    for (std::size_t i=0; i<values.size(); i++) {
+        if (values[i] < 0)
+            throw Base::ValueError("negative index");
+        data[i] = static_cast<unsigned long>(values[i]);
+    }
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_BUFFERPROTOCOL_H
+#define BASE_BUFFERPROTOCOL_H
+
+#include <Python.h>
+#include <cstddef>
+#include <vector>
+
+namespace Base
+{
+
+/**
+ * The BufferProtocol class exchanges arrays of numbers with Python objects
+ * that support the buffer protocol, e.g. NumPy arrays. The data are always
+ * copied because the C++ objects keep their coordinates in local space and
+ * may reallocate them at any time. A returned bytes object is therefore a
+ * read-only snapshot, e.g. numpy.frombuffer(data, numpy.float64) gives a
+ * read-only view on it that has to be copied before it can be changed.
+ */
+class BaseExport BufferProtocol
+{
+public:
+    /** Creates a bytes object for \a count numbers of type T and sets \a data
+     * to its memory, which must be filled before the object is passed on.
+     */
+    template <typename T>
+    static PyObject* createArray(std::size_t count, T*& data)
+    {
+        PyObject* bytes = PyBytes_FromStringAndSize(0, static_cast<Py_ssize_t>(count * sizeof(T)));
+        data = bytes ? reinterpret_cast<T*>(PyBytes_AS_STRING(bytes)) : 0;
+        return bytes;
+    }
+
+    /** Reads the numbers of a C-contiguous buffer of floating point or
+     * integer numbers. The number of values must be a multiple of
+     * \a components. Throws Base::TypeError if the object doesn't support
+     * the buffer protocol or has an unsupported format and Base::ValueError
+     * if the number of values doesn't fit.
+     */
+    static void getDoubles(PyObject* obj, std::size_t components, std::vector<double>& data);
+    /** Reads the numbers of a C-contiguous buffer of integer numbers as
+     * getDoubles() does. Throws Base::ValueError for negative numbers.
+     */
+    static void getIndices(PyObject* obj, std::size_t components, std::vector<unsigned long>& data);
+};
+
+} // namespace Base
+
+#endif // BASE_BUFFERPROTOCOL_H
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_CSTRINGHASH_H
+#define BASE_CSTRINGHASH_H
+
+#include <cstddef>
+#include <cstring>
+
+namespace Base
+{
+
+/**
+ * Hash function (FNV-1a) and equality predicate for C strings, to be used
+ * as key of unordered containers whose keys point to persistent names.
+ */
+struct CStringHash
+{
+    std::size_t operator()(const char* s) const
+    {
+        std::size_t h = 2166136261u;
+        for (; *s; ++s)
+            h = (h ^ static_cast<unsigned char>(*s)) * 16777619u;
+        return h;
+    }
+};
+
+struct CStringEqual
+{
+    bool operator()(const char* a, const char* b) const
+    {
+        return strcmp(a, b) == 0;
+    }
+};
+
+} // namespace Base
+
+#endif // BASE_CSTRINGHASH_H
@@ -124,6 +124,9 @@ private:
  * if the thread has to run code in the main thread where Python code may be 
  * executed it must release the GIL to avoid a deadlock. In either case the thread
  * must hold the GIL when instantiating an object of PyGILStateRelease.
+ * While the GIL is released other Python threads may run. So, the code must not
+ * access any Python object and the C++ objects it works on must not be changed
+ * by another thread at the same time.
  * As PyGILStateLocker it's best to create an instance of PyGILStateRelease on the
  * stack.
  */
@@ -43,15 +43,19 @@ struct Base::TypeData
            const Type type = Type::badType(),
            const Type theParent = Type::badType(),
            Type::instantiationMethod method = 0
-          ):name(theName),parent(theParent),type(type),instMethod(method) { }
+          ):name(theName),parent(theParent),type(type),instMethod(method),first(0),last(0) { }
 
   std::string name;
   Type parent;
   Type type;
   Type::instantiationMethod instMethod;
+  /// the directly derived types
+  std::vector<unsigned int> children;
+  /// the interval of the numbers of this type and all types derived from it
+  unsigned int first, last;
 };
 
-map<string,unsigned int> Type::typemap;
+unordered_map<const char*,unsigned int,CStringHash,CStringEqual> Type::typemap;
 vector<TypeData*>        Type::typedata;
 set<string>              Type::loadModuleSet;
 
@@ -145,13 +149,49 @@ const Type Type::createType(const Type parent, const char *name, instantiationMe
   newType.index = Type::typedata.size();
   TypeData * typeData = new TypeData(name, newType, parent,method);
   Type::typedata.push_back(typeData);
+  if (!parent.isBad())
+    Type::typedata[parent.getKey()]->children.push_back(newType.getKey());
 
   // add to dictionary for fast lookup
-  Type::typemap[name] = newType.getKey();
+  Type::typemap[typeData->name.c_str()] = newType.getKey();
+
+  updateNumbering();
 
   return newType;
 }
 
+void Type::updateNumbering(void)
+{
+  // BadType has a number of its own so that it's neither derived from
+  // any type nor any type is derived from it
+  typedata[0]->first = typedata[0]->last = 0;
+  unsigned int number = 0;
+
+  // depth-first traversal of the class trees without recursion,
+  // for each type on the stack the index of its next child is kept
+  std::vector<std::pair<unsigned int, std::size_t> > stack;
+  for (std::size_t i=1; i<typedata.size(); i++) {
+    if (!typedata[i]->parent.isBad())
+      continue;
+    typedata[i]->first = ++number;
+    stack.push_back(std::make_pair(static_cast<unsigned int>(i), std::size_t(0)));
+    while (!stack.empty()) {
+      TypeData* data = typedata[stack.back().first];
+      std::size_t next = stack.back().second;
+      if (next < data->children.size()) {
+        stack.back().second = next + 1;
+        unsigned int child = data->children[next];
+        typedata[child]->first = ++number;
+        stack.push_back(std::make_pair(child, std::size_t(0)));
+      }
+      else {
+        data->last = number;
+        stack.pop_back();
+      }
+    }
+  }
+}
+
 
 void Type::init(void)
 {
@@ -159,7 +199,7 @@ void Type::init(void)
 
 
   Type::typedata.push_back(new TypeData("BadType"));
-  Type::typemap["BadType"] = 0;
+  Type::typemap[Type::typedata[0]->name.c_str()] = 0;
 
 
 }
@@ -175,8 +215,8 @@ void Type::destruct(void)
 
 Type Type::fromName(const char *name)
 {
-  std::map<std::string,unsigned int>::const_iterator pos;
-  
+  unordered_map<const char*,unsigned int,CStringHash,CStringEqual>::const_iterator pos;
+
   pos = typemap.find(name);
   if(pos != typemap.end())
     return typedata[pos->second]->type;
@@ -196,15 +236,10 @@ const Type Type::getParent(void) const
 
 bool Type::isDerivedFrom(const Type type) const
 {
-  
-  Type temp(*this);
-  do {
-    if(temp == type)
-      return true;
-    temp = temp.getParent();
-  } while (temp != badType());
-
-  return false;
+  // the derived types are numbered within the interval of the type
+  unsigned int number = typedata[index]->first;
+  const TypeData* data = typedata[type.index];
+  return number >= data->first && number <= data->last;
 }
 
 int Type::getAllDerivedFrom(const Type type, std::vector<Type> & List)
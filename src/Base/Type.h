@@ -26,10 +26,13 @@
 
 // Std. configurations
 
+#include <cstring>
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
+#include "CStringHash.h"
 
 namespace Base
 {
@@ -73,6 +76,11 @@ struct TypeData;
   One important note about the use of Type to register class
   information: super classes must be registered before any of their
   derived classes are.
+
+  The types are numbered in depth-first order of the class hierarchy
+  whenever a type is registered. All types derived from a type then have
+  their number within the interval of this type, so isDerivedFrom() is
+  done with two comparisons instead of walking up the parent chain.
 */
 class BaseExport Type
 {
@@ -122,12 +130,13 @@ protected:
 
 
 private:
-
+  static void updateNumbering(void);
 
   unsigned int index;
 
 
-  static std::map<std::string,unsigned int> typemap;
+  /// the keys point to the names kept in the type data
+  static std::unordered_map<const char*,unsigned int,CStringHash,CStringEqual> typemap;
   static std::vector<TypeData*>     typedata;
 
   static std::set<std::string>  loadModuleSet;
@@ -61,7 +61,7 @@ using namespace Gui::PropertyEditor;
  * in two tabs.
  */
 PropertyView::PropertyView(QWidget *parent)
-  : QWidget(parent)
+  : QWidget(parent), SelectionObserver(true)
 {
     QGridLayout* pLayout = new QGridLayout( this ); 
     pLayout->setSpacing(0);
@@ -185,7 +185,9 @@ struct PropertyView::PropFind {
 void PropertyView::onSelectionChanged(const SelectionChanges& msg)
 {
     if (msg.Type != SelectionChanges::AddSelection &&
+        msg.Type != SelectionChanges::AddSelections &&
         msg.Type != SelectionChanges::RmvSelection &&
+        msg.Type != SelectionChanges::RmvSelections &&
         msg.Type != SelectionChanges::SetSelection &&
         msg.Type != SelectionChanges::ClrSelection)
         return;
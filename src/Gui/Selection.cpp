@@ -54,7 +54,7 @@
 using namespace Gui;
 using namespace std;
 
-SelectionObserver::SelectionObserver()
+SelectionObserver::SelectionObserver(bool bulk) : bulkMessages(bulk)
 {
     attachSelection();
 }
@@ -83,7 +83,7 @@ void SelectionObserver::attachSelection()
 {
     if (!connectSelection.connected()) {
         connectSelection = Selection().signalSelectionChanged.connect(boost::bind
-            (&SelectionObserver::onSelectionChanged, this, _1));
+            (&SelectionObserver::notifySelectionChanged, this, _1));
     }
 }
 
@@ -94,6 +94,23 @@ void SelectionObserver::detachSelection()
     }
 }
 
+void SelectionObserver::notifySelectionChanged(const SelectionChanges& msg)
+{
+    if (msg.pSubNames && !bulkMessages) {
+        SelectionChanges single(msg);
+        single.Type = (msg.Type == SelectionChanges::AddSelections ?
+            SelectionChanges::AddSelection : SelectionChanges::RmvSelection);
+        single.pSubNames = 0;
+        for (std::vector<std::string>::const_iterator it = msg.pSubNames->begin(); it != msg.pSubNames->end(); ++it) {
+            single.pSubName = it->c_str();
+            onSelectionChanged(single);
+        }
+    }
+    else {
+        onSelectionChanged(msg);
+    }
+}
+
 // -------------------------------------------
 
 std::vector<SelectionObserverPython*> SelectionObserverPython::_instances;
@@ -654,6 +671,46 @@ App::Document* SelectionSingleton::getDocument(const char* pDocName) const
         return App::GetApplication().getActiveDocument();
 }
 
+std::string SelectionSingleton::objectKey(const char* pDocName, const char* pObjectName)
+{
+    // names cannot contain a null character, so it's a safe separator
+    std::string key(pDocName ? pDocName : "");
+    key += '\0';
+    key += pObjectName ? pObjectName : "";
+    return key;
+}
+
+std::string SelectionSingleton::selectionKey(const char* pDocName, const char* pObjectName, const char* pSubName)
+{
+    std::string key = objectKey(pDocName, pObjectName);
+    key += '\0';
+    key += pSubName ? pSubName : "";
+    return key;
+}
+
+void SelectionSingleton::addToIndex(std::list<_SelObj>::iterator it)
+{
+    _SelIndex[selectionKey(it->DocName.c_str(), it->FeatName.c_str(), it->SubName.c_str())] = it;
+    _SelObjCount[objectKey(it->DocName.c_str(), it->FeatName.c_str())]++;
+}
+
+void SelectionSingleton::removeFromIndex(const _SelObj& obj)
+{
+    _SelIndex.erase(selectionKey(obj.DocName.c_str(), obj.FeatName.c_str(), obj.SubName.c_str()));
+    std::unordered_map<std::string, unsigned int>::iterator jt =
+        _SelObjCount.find(objectKey(obj.DocName.c_str(), obj.FeatName.c_str()));
+    if (jt != _SelObjCount.end() && --jt->second == 0)
+        _SelObjCount.erase(jt);
+}
+
+void SelectionSingleton::rebuildIndex()
+{
+    _SelIndex.clear();
+    _SelObjCount.clear();
+    for (std::list<_SelObj>::iterator it = _SelList.begin(); it != _SelList.end(); ++it)
+        addToIndex(it);
+}
+
 bool SelectionSingleton::addSelection(const char* pDocName, const char* pObjectName, const char* pSubName, float x, float y, float z)
 {
     // already in ?
@@ -701,6 +758,7 @@ bool SelectionSingleton::addSelection(const char* pDocName, const char* pObjectN
             temp.TypeName = temp.pObject->getTypeId().getName();
 
         _SelList.push_back(temp);
+        addToIndex(--_SelList.end());
 
         SelectionChanges Chng;
 
@@ -750,12 +808,17 @@ bool SelectionSingleton::addSelection(const char* pDocName, const char* pObjectN
         temp.DocName  = pDocName;
         temp.FeatName = pObjectName ? pObjectName : "";
         for (std::vector<std::string>::const_iterator it = pSubNames.begin(); it != pSubNames.end(); ++it) {
+            // a sub-element can be selected only once
+            if (isSelected(pDocName, pObjectName, it->c_str()))
+                continue;
+
             temp.SubName  = it->c_str();
             temp.x        = 0;
             temp.y        = 0;
             temp.z        = 0;
 
             _SelList.push_back(temp);
+            addToIndex(--_SelList.end());
         }
 
         SelectionChanges Chng;
@@ -783,11 +846,92 @@ bool SelectionSingleton::addSelection(const char* pDocName, const char* pObjectN
     }
 }
 
+bool SelectionSingleton::addSelections(const char* pDocName, const char* pObjectName, const std::vector<std::string>& pSubNames)
+{
+    _SelObj temp;
+
+    temp.pDoc = getDocument(pDocName);
+
+    if (temp.pDoc) {
+        if(pObjectName)
+            temp.pObject = temp.pDoc->getObject(pObjectName);
+        else
+            temp.pObject = 0;
+
+        if (temp.pObject)
+            temp.TypeName = temp.pObject->getTypeId().getName();
+
+        temp.DocName  = pDocName;
+        temp.FeatName = pObjectName ? pObjectName : "";
+
+        std::vector<std::string> added;
+        added.reserve(pSubNames.size());
+        for (std::vector<std::string>::const_iterator it = pSubNames.begin(); it != pSubNames.end(); ++it) {
+            // already in ?
+            if (isSelected(pDocName, pObjectName, it->c_str()))
+                continue;
+            // check for a Selection Gate
+            if (ActiveGate && !ActiveGate->allow(temp.pDoc,temp.pObject,it->c_str())) {
+                ActiveGate->notAllowedReason.clear();
+                continue;
+            }
+
+            temp.SubName  = it->c_str();
+            temp.x        = 0;
+            temp.y        = 0;
+            temp.z        = 0;
+
+            _SelList.push_back(temp);
+            addToIndex(--_SelList.end());
+            added.push_back(*it);
+        }
+
+        if (!added.empty()) {
+            SelectionChanges Chng;
+
+            Chng.pDocName  = pDocName;
+            Chng.pObjectName = pObjectName ? pObjectName : "";
+            Chng.pSubName  = "";
+            Chng.pTypeName = temp.TypeName.c_str();
+            Chng.pSubNames = &added;
+            Chng.Type      = SelectionChanges::AddSelections;
+
+            notifySubElements(Chng);
+            signalSelectionChanged(Chng);
+        }
+
+        // allow selection
+        return true;
+    }
+    else {
+        // neither an existing nor active document available 
+        // this can often happen when importing .iv files
+        Base::Console().Error("Cannot add to selection: no document '%s' found.\n", pDocName);
+        return false;
+    }
+}
+
 void SelectionSingleton::rmvSelection(const char* pDocName, const char* pObjectName, const char* pSubName)
 {
     std::vector<SelectionChanges> rmvList;
 
-    for (std::list<_SelObj>::iterator It = _SelList.begin();It != _SelList.end();) {
+    // avoid to go through the whole list if the index gives the answer
+    std::list<_SelObj>::iterator first = _SelList.begin(), last = _SelList.end();
+    if (pObjectName) {
+        if (pSubName) {
+            std::unordered_map<std::string, std::list<_SelObj>::iterator>::iterator jt =
+                _SelIndex.find(selectionKey(pDocName, pObjectName, pSubName));
+            if (jt == _SelIndex.end())
+                return;
+            first = last = jt->second;
+            ++last;
+        }
+        else if (_SelObjCount.find(objectKey(pDocName, pObjectName)) == _SelObjCount.end()) {
+            return;
+        }
+    }
+
+    for (std::list<_SelObj>::iterator It = first;It != last;) {
         if ((It->DocName == pDocName && !pObjectName) ||
             (It->DocName == pDocName && pObjectName && It->FeatName == pObjectName && !pSubName) ||
             (It->DocName == pDocName && pObjectName && It->FeatName == pObjectName && pSubName && It->SubName == pSubName))
@@ -799,6 +943,7 @@ void SelectionSingleton::rmvSelection(const char* pDocName, const char* pObjectN
             std::string tmpTypName = It->TypeName;
 
             // destroy the _SelObj item
+            removeFromIndex(*It);
             It = _SelList.erase(It);
 
             SelectionChanges Chng;
@@ -815,6 +960,9 @@ void SelectionSingleton::rmvSelection(const char* pDocName, const char* pObjectN
 #ifdef FC_DEBUG
             Base::Console().Log("Sel : Rmv Selection \"%s.%s.%s\"\n",pDocName,pObjectName,pSubName);
 #endif
+            // a sub-element is selected only once
+            if (pObjectName && pSubName)
+                break;
         }
         else {
             ++It;
@@ -822,6 +970,52 @@ void SelectionSingleton::rmvSelection(const char* pDocName, const char* pObjectN
     }
 }
 
+void SelectionSingleton::rmvSelections(const char* pDocName, const char* pObjectName, const std::vector<std::string>& pSubNames)
+{
+    std::string typeName;
+    std::vector<std::string> removed;
+    removed.reserve(pSubNames.size());
+    for (std::vector<std::string>::const_iterator it = pSubNames.begin(); it != pSubNames.end(); ++it) {
+        std::unordered_map<std::string, std::list<_SelObj>::iterator>::iterator jt =
+            _SelIndex.find(selectionKey(pDocName, pObjectName, it->c_str()));
+        if (jt == _SelIndex.end())
+            continue;
+
+        std::list<_SelObj>::iterator sel = jt->second;
+        typeName = sel->TypeName;
+        removed.push_back(sel->SubName);
+
+        removeFromIndex(*sel);
+        _SelList.erase(sel);
+    }
+
+    if (!removed.empty()) {
+        SelectionChanges Chng;
+        Chng.pDocName  = pDocName;
+        Chng.pObjectName = pObjectName ? pObjectName : "";
+        Chng.pSubName  = "";
+        Chng.pTypeName = typeName.c_str();
+        Chng.pSubNames = &removed;
+        Chng.Type      = SelectionChanges::RmvSelections;
+
+        notifySubElements(Chng);
+        signalSelectionChanged(Chng);
+    }
+}
+
+void SelectionSingleton::notifySubElements(const SelectionChanges& Chng)
+{
+    // the observers of the subject get one message per sub-element
+    SelectionChanges single(Chng);
+    single.Type = (Chng.Type == SelectionChanges::AddSelections ?
+        SelectionChanges::AddSelection : SelectionChanges::RmvSelection);
+    single.pSubNames = 0;
+    for (std::vector<std::string>::const_iterator it = Chng.pSubNames->begin(); it != Chng.pSubNames->end(); ++it) {
+        single.pSubName = it->c_str();
+        Notify(single);
+    }
+}
+
 void SelectionSingleton::setSelection(const char* pDocName, const std::vector<App::DocumentObject*>& sel)
 {
     App::Document *pcDoc;
@@ -867,6 +1061,7 @@ void SelectionSingleton::setSelection(const char* pDocName, const std::vector<Ap
         return;
 
     _SelList = temp;
+    rebuildIndex();
 
     SelectionChanges Chng;
     Chng.Type = SelectionChanges::SetSelection;
@@ -901,6 +1096,7 @@ void SelectionSingleton::clearSelection(const char* pDocName)
         }
 
         _SelList = selList;
+        rebuildIndex();
 
         SelectionChanges Chng;
         Chng.Type = SelectionChanges::ClrSelection;
@@ -921,6 +1117,8 @@ void SelectionSingleton::clearSelection(const char* pDocName)
 void SelectionSingleton::clearCompleteSelection()
 {
     _SelList.clear();
+    _SelIndex.clear();
+    _SelObjCount.clear();
 
     SelectionChanges Chng;
     Chng.Type = SelectionChanges::ClrSelection;
@@ -940,32 +1138,25 @@ void SelectionSingleton::clearCompleteSelection()
 
 bool SelectionSingleton::isSelected(const char* pDocName, const char* pObjectName, const char* pSubName) const
 {
-    const char* tmpDocName = pDocName ? pDocName : "";
-    const char* tmpFeaName = pObjectName ? pObjectName : "";
-    const char* tmpSubName = pSubName ? pSubName : "";
-    for (std::list<_SelObj>::const_iterator It = _SelList.begin();It != _SelList.end();++It)
-        if (It->DocName == tmpDocName && It->FeatName == tmpFeaName && It->SubName == tmpSubName)
-            return true;
-    return false;
+    return _SelIndex.find(selectionKey(pDocName, pObjectName, pSubName)) != _SelIndex.end();
 }
 
 bool SelectionSingleton::isSelected(App::DocumentObject* obj, const char* pSubName) const
 {
     if (!obj) return false;
 
-    for(list<_SelObj>::const_iterator It = _SelList.begin();It != _SelList.end();++It) {
-        if (It->pObject == obj) {
-            if (pSubName) {
-                if (It->SubName == pSubName)
-                    return true;
-            }
-            else {
-                return true;
-            }
-        }
+    const char* pObjectName = obj->getNameInDocument();
+    App::Document* pDoc = obj->getDocument();
+    if (!pObjectName || !pDoc)
+        return false;
+
+    if (pSubName) {
+        std::unordered_map<std::string, std::list<_SelObj>::iterator>::const_iterator It =
+            _SelIndex.find(selectionKey(pDoc->getName(), pObjectName, pSubName));
+        return It != _SelIndex.end() && It->second->pObject == obj;
     }
 
-    return false;
+    return _SelObjCount.find(objectKey(pDoc->getName(), pObjectName)) != _SelObjCount.end();
 }
 
 void SelectionSingleton::slotDeletedObject(const App::DocumentObject& Obj)
@@ -1030,9 +1221,11 @@ void SelectionSingleton::destruct (void)
 PyMethodDef SelectionSingleton::Methods[] = {
     {"addSelection",         (PyCFunction) SelectionSingleton::sAddSelection, 1, 
      "addSelection(object,[string,float,float,float]) -- Add an object to the selection\n"
-     "where string is the sub-element name and the three floats represent a 3d point"},
+     "where string is the sub-element name and the three floats represent a 3d point\n"
+     "addSelection(object,list) -- Add several sub-elements of an object at once"},
     {"removeSelection",      (PyCFunction) SelectionSingleton::sRemoveSelection, 1,
-     "removeSelection(object) -- Remove an object from the selection"},
+     "removeSelection(object,[string]) -- Remove an object from the selection\n"
+     "removeSelection(object,list) -- Remove several sub-elements of an object at once"},
     {"clearSelection"  ,     (PyCFunction) SelectionSingleton::sClearSelection, 1,
      "clearSelection([string]) -- Clear the selection\n"
      "Clear the selection to the given document name. If no document is\n"
@@ -1117,12 +1310,13 @@ PyObject *SelectionSingleton::sAddSelection(PyObject * /*self*/, PyObject *args,
         try {
             if (PyTuple_Check(sequence) || PyList_Check(sequence)) {
                 Py::Sequence list(sequence);
-                for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
-                    std::string subname = static_cast<std::string>(Py::String(*it));
-                    Selection().addSelection(docObj->getDocument()->getName(),
-                                             docObj->getNameInDocument(),
-                                             subname.c_str());
-                }
+                std::vector<std::string> subnames;
+                subnames.reserve(list.size());
+                for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it)
+                    subnames.push_back(static_cast<std::string>(Py::String(*it)));
+                Selection().addSelections(docObj->getDocument()->getName(),
+                                          docObj->getNameInDocument(),
+                                          subnames);
 
                 Py_Return;
             }
@@ -1140,21 +1334,52 @@ PyObject *SelectionSingleton::sRemoveSelection(PyObject * /*self*/, PyObject *ar
 {
     PyObject *object;
     char* subname=0;
-    if (!PyArg_ParseTuple(args, "O!|s", &(App::DocumentObjectPy::Type),&object,&subname))
-        return NULL;                             // NULL triggers exception 
+    if (PyArg_ParseTuple(args, "O!|s", &(App::DocumentObjectPy::Type),&object,&subname)) {
+        App::DocumentObjectPy* docObjPy = static_cast<App::DocumentObjectPy*>(object);
+        App::DocumentObject* docObj = docObjPy->getDocumentObjectPtr();
+        if (!docObj || !docObj->getNameInDocument()) {
+            PyErr_SetString(Base::BaseExceptionFreeCADError, "Cannot check invalid object");
+            return NULL;
+        }
 
-    App::DocumentObjectPy* docObjPy = static_cast<App::DocumentObjectPy*>(object);
-    App::DocumentObject* docObj = docObjPy->getDocumentObjectPtr();
-    if (!docObj || !docObj->getNameInDocument()) {
-        PyErr_SetString(Base::BaseExceptionFreeCADError, "Cannot check invalid object");
-        return NULL;
+        Selection().rmvSelection(docObj->getDocument()->getName(),
+                                 docObj->getNameInDocument(),
+                                 subname);
+
+        Py_Return;
     }
 
-    Selection().rmvSelection(docObj->getDocument()->getName(),
-                             docObj->getNameInDocument(),
-                             subname);
+    PyErr_Clear();
+    PyObject *sequence;
+    if (PyArg_ParseTuple(args, "O!O", &(App::DocumentObjectPy::Type),&object,&sequence)) {
+        App::DocumentObjectPy* docObjPy = static_cast<App::DocumentObjectPy*>(object);
+        App::DocumentObject* docObj = docObjPy->getDocumentObjectPtr();
+        if (!docObj || !docObj->getNameInDocument()) {
+            PyErr_SetString(Base::BaseExceptionFreeCADError, "Cannot check invalid object");
+            return NULL;
+        }
 
-    Py_Return;
+        try {
+            if (PyTuple_Check(sequence) || PyList_Check(sequence)) {
+                Py::Sequence list(sequence);
+                std::vector<std::string> subnames;
+                subnames.reserve(list.size());
+                for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it)
+                    subnames.push_back(static_cast<std::string>(Py::String(*it)));
+                Selection().rmvSelections(docObj->getDocument()->getName(),
+                                          docObj->getNameInDocument(),
+                                          subnames);
+
+                Py_Return;
+            }
+        }
+        catch (const Py::Exception&) {
+            // do nothing here
+        }
+    }
+
+    PyErr_SetString(PyExc_ValueError, "type must be 'DocumentObject[,subname]' or 'DocumentObject, list of subnames'");
+    return 0;
 }
 
 PyObject *SelectionSingleton::sClearSelection(PyObject * /*self*/, PyObject *args, PyObject * /*kwd*/)
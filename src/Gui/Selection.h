@@ -30,6 +30,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <CXX/Objects.hxx>
 
 #include <Base/Observer.h>
@@ -68,7 +69,9 @@ public:
         SetSelection,
         ClrSelection,
         SetPreselect,
-        RmvPreselect
+        RmvPreselect,
+        AddSelections,
+        RmvSelections
     };
     SelectionChanges()
     : Type(ClrSelection)
@@ -77,6 +80,7 @@ public:
     , pSubName(0)
     , pTypeName(0)
     , x(0),y(0),z(0)
+    , pSubNames(0)
     {
     }
 
@@ -89,6 +93,8 @@ public:
     float x;
     float y;
     float z;
+    /// the sub-elements of an AddSelections or RmvSelections message
+    const std::vector<std::string>* pSubNames;
 };
 
 } //namespace Gui
@@ -128,8 +134,12 @@ class GuiExport SelectionObserver
 {
 
 public:
-    /// Constructor
-    SelectionObserver();
+    /** Constructor
+     * If \a bulk is true the observer gets a single AddSelections or
+     * RmvSelections message for several sub-elements of an object. Otherwise
+     * it gets an AddSelection or RmvSelection message for each of them.
+     */
+    SelectionObserver(bool bulk = false);
     virtual ~SelectionObserver();
     bool blockConnection(bool block);
     bool isConnectionBlocked() const;
@@ -140,11 +150,13 @@ public:
     void detachSelection();
 
 private:
+    void notifySelectionChanged(const SelectionChanges& msg);
     virtual void onSelectionChanged(const SelectionChanges& msg) = 0;
 
 private:
     typedef boost::signals::connection Connection;
     Connection connectSelection;
+    bool bulkMessages;
 };
 
 /**
@@ -221,8 +233,12 @@ public:
     bool addSelection(const char* pDocName, const char* pObjectName=0, const char* pSubName=0, float x=0, float y=0, float z=0);
     /// Add to selection with several sub-elements
     bool addSelection(const char* pDocName, const char* pObjectName, const std::vector<std::string>& pSubNames);
+    /// Add several sub-elements to selection, observers get a single AddSelections message
+    bool addSelections(const char* pDocName, const char* pObjectName, const std::vector<std::string>& pSubNames);
     /// Remove from selection (for internal use)
     void rmvSelection(const char* pDocName, const char* pObjectName=0, const char* pSubName=0);
+    /// Remove several sub-elements from selection, observers get a single RmvSelections message
+    void rmvSelections(const char* pDocName, const char* pObjectName, const std::vector<std::string>& pSubNames);
     /// Set the selection for a document
     void setSelection(const char* pDocName, const std::vector<App::DocumentObject*>&);
     /// Clear the selection of document \a pDocName. If the document name is not given the selection of the active document is cleared.
@@ -368,6 +384,17 @@ protected:
         float x,y,z;
     };
     std::list<_SelObj> _SelList;
+    /// selection entries keyed by document, object and sub-element name
+    std::unordered_map<std::string, std::list<_SelObj>::iterator> _SelIndex;
+    /// number of selection entries per document and object name
+    std::unordered_map<std::string, unsigned int> _SelObjCount;
+
+    static std::string objectKey(const char* pDocName, const char* pObjectName);
+    static std::string selectionKey(const char* pDocName, const char* pObjectName, const char* pSubName);
+    void addToIndex(std::list<_SelObj>::iterator);
+    void removeFromIndex(const _SelObj&);
+    void notifySubElements(const SelectionChanges&);
+    void rebuildIndex();
 
     static SelectionSingleton* _pcSingleton;
 
@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <Inventor/actions/SoRayPickAction.h>
+#endif
+
+#include "SoFCRayPickTree.h"
+
+using namespace Gui;
+
+namespace {
+// Sorts primitives by the center of their bounding box along one axis
+struct CenterLess
+{
+    CenterLess(const std::vector<SbVec3f>& c, int a)
+        : centers(c), axis(a)
+    {
+    }
+    bool operator()(int i, int j) const
+    {
+        return centers[i][axis] < centers[j][axis];
+    }
+    const std::vector<SbVec3f>& centers;
+    int axis;
+};
+}
+
+SoFCRayPickTree::SoFCRayPickTree()
+{
+}
+
+SoFCRayPickTree::~SoFCRayPickTree()
+{
+}
+
+void SoFCRayPickTree::build(const std::vector<SbBox3f>& boxes)
+{
+    clear();
+    if (boxes.empty())
+        return;
+
+    std::vector<SbVec3f> centers;
+    centers.reserve(boxes.size());
+    for (std::vector<SbBox3f>::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+        centers.push_back(it->getCenter());
+
+    indices.resize(boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); i++)
+        indices[i] = static_cast<int>(i);
+
+    // a binary tree with leaves of up to four primitives has less than this number of nodes
+    nodes.reserve(boxes.size() / 2 + 1);
+    buildNode(boxes, centers, 0, static_cast<int>(boxes.size()));
+}
+
+void SoFCRayPickTree::clear()
+{
+    std::vector<Node>().swap(nodes);
+    std::vector<int>().swap(indices);
+}
+
+bool SoFCRayPickTree::isEmpty() const
+{
+    return nodes.empty();
+}
+
+int SoFCRayPickTree::buildNode(const std::vector<SbBox3f>& boxes, std::vector<SbVec3f>& centers,
+                               int first, int last)
+{
+    const int maxLeafSize = 4;
+
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back(Node());
+
+    SbBox3f box;
+    SbBox3f centerBox;
+    for (int i = first; i < last; i++) {
+        box.extendBy(boxes[indices[i]]);
+        centerBox.extendBy(centers[indices[i]]);
+    }
+    nodes[index].box = box;
+
+    if (last - first <= maxLeafSize) {
+        nodes[index].first = first;
+        nodes[index].count = last - first;
+        return index;
+    }
+
+    // split at the median along the longest axis of the centers
+    float dx, dy, dz;
+    centerBox.getSize(dx, dy, dz);
+    int axis = 0;
+    if (dy > dx && dy >= dz)
+        axis = 1;
+    else if (dz > dx && dz > dy)
+        axis = 2;
+
+    int middle = (first + last) / 2;
+    std::nth_element(indices.begin() + first, indices.begin() + middle, indices.begin() + last,
+                     CenterLess(centers, axis));
+
+    // the left child directly follows its parent
+    buildNode(boxes, centers, first, middle);
+    int right = buildNode(boxes, centers, middle, last);
+    nodes[index].first = right;
+    nodes[index].count = 0;
+    return index;
+}
+
+void SoFCRayPickTree::intersect(SoRayPickAction* action, std::vector<int>& primitives) const
+{
+    if (nodes.empty())
+        return;
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        int index = stack.back();
+        stack.pop_back();
+
+        // use the full view volume to take the pick radius into account for lines and points
+        if (!action->intersect(node.box, TRUE))
+            continue;
+
+        if (node.count > 0) {
+            primitives.insert(primitives.end(), indices.begin() + node.first,
+                              indices.begin() + node.first + node.count);
+        }
+        else {
+            stack.push_back(node.first);
+            stack.push_back(index + 1);
+        }
+    }
+
+    std::sort(primitives.begin(), primitives.end());
+}
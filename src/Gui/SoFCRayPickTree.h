@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef GUI_SOFCRAYPICKTREE_H
+#define GUI_SOFCRAYPICKTREE_H
+
+#include <vector>
+#include <Inventor/SbBox3f.h>
+
+class SoRayPickAction;
+
+namespace Gui {
+
+/**
+ * The SoFCRayPickTree class is a bounding volume hierarchy over the primitives
+ * (triangles, line segments or points) of a shape node. It is used by shape nodes
+ * to only test those primitives against the pick ray whose bounding box is hit,
+ * instead of going through all primitives with generatePrimitives().
+ *
+ * The tree doesn't know anything about the primitives themselves, it only stores
+ * their indices. It's up to the shape node to rebuild the tree when its geometry changes.
+ */
+class GuiExport SoFCRayPickTree
+{
+public:
+    SoFCRayPickTree();
+    ~SoFCRayPickTree();
+
+    /// Builds the tree for the given boxes where the i-th box belongs to the i-th primitive
+    void build(const std::vector<SbBox3f>& boxes);
+    /// Removes all nodes
+    void clear();
+    bool isEmpty() const;
+    /**
+     * Collects the indices of the primitives that may be hit by the pick ray of \a action,
+     * i.e. all primitives of the leaves whose bounding box is hit. The caller must do the
+     * exact intersection test. The ray must already be in object space, i.e.
+     * computeObjectSpaceRay() must have been called by the shape node. The indices are
+     * sorted in ascending order.
+     */
+    void intersect(SoRayPickAction* action, std::vector<int>& primitives) const;
+
+private:
+    struct Node {
+        SbBox3f box;
+        int first;  // first index into 'indices' (leaf) or index of right child (inner node)
+        int count;  // number of primitives of a leaf, 0 for an inner node
+    };
+
+    int buildNode(const std::vector<SbBox3f>& boxes, std::vector<SbVec3f>& centers,
+                  int first, int last);
+
+private:
+    std::vector<Node> nodes;
+    std::vector<int> indices;
+};
+
+} // namespace Gui
+
+#endif // GUI_SOFCRAYPICKTREE_H
@@ -92,7 +92,7 @@ SO_NODE_SOURCE(SoFCUnifiedSelection);
 /*!
   Constructor.
 */
-SoFCUnifiedSelection::SoFCUnifiedSelection() : pcDocument(0)
+SoFCUnifiedSelection::SoFCUnifiedSelection() : pcDocument(0), preSelectionPath(0)
 {
     SO_NODE_CONSTRUCTOR(SoFCUnifiedSelection);
 
@@ -109,6 +109,10 @@ SoFCUnifiedSelection::SoFCUnifiedSelection() : pcDocument(0)
 
     highlighted = false;
     preSelection = -1;
+    preSelectionTime = SbTime::zero();
+    preSelectionDuration = SbTime::zero();
+    preSelectionSensor.setFunction(preselectionTimeout);
+    preSelectionSensor.setData(this);
 }
 
 /*!
@@ -116,6 +120,11 @@ SoFCUnifiedSelection::SoFCUnifiedSelection() : pcDocument(0)
 */
 SoFCUnifiedSelection::~SoFCUnifiedSelection()
 {
+    if (preSelectionSensor.isScheduled())
+        preSelectionSensor.unschedule();
+    if (preSelectionPath)
+        preSelectionPath->unref();
+
     // If we're being deleted and we're the current highlight,
     // NULL out that variable
     if (currenthighlight != NULL) {
@@ -225,6 +234,43 @@ SoFCUnifiedSelection::getPickedPoint(SoHandleEventAction* action) const
     return picked;
 }
 
+void SoFCUnifiedSelection::schedulePreselection(SoHandleEventAction* action)
+{
+    const SoEvent* event = action->getEvent();
+    preSelectionEvent.setPosition(event->getPosition());
+    preSelectionEvent.setTime(event->getTime());
+    preSelectionEvent.setShiftDown(event->wasShiftDown());
+    preSelectionEvent.setCtrlDown(event->wasCtrlDown());
+    preSelectionEvent.setAltDown(event->wasAltDown());
+    preSelectionViewport = action->getViewportRegion();
+
+    // the path to this node includes the camera, but not the other nodes
+    // that have handled the event already
+    if (preSelectionPath)
+        preSelectionPath->unref();
+    preSelectionPath = action->getCurPath()->copy();
+    preSelectionPath->ref();
+
+    if (!preSelectionSensor.isScheduled()) {
+        preSelectionSensor.setTime(preSelectionTime + preSelectionDuration);
+        preSelectionSensor.schedule();
+    }
+}
+
+void SoFCUnifiedSelection::preselectionTimeout(void * data, SoSensor * /*sensor*/)
+{
+    SoFCUnifiedSelection* self = static_cast<SoFCUnifiedSelection*>(data);
+    SoPath* path = self->preSelectionPath;
+    if (!path)
+        return;
+    self->preSelectionPath = 0;
+
+    SoHandleEventAction action(self->preSelectionViewport);
+    action.setEvent(&self->preSelectionEvent);
+    action.apply(path);
+    path->unref();
+}
+
 void SoFCUnifiedSelection::doAction(SoAction *action)
 {
     if (action->getTypeId() == SoFCEnableHighlightAction::getClassTypeId()) {
@@ -346,9 +392,29 @@ SoFCUnifiedSelection::handleEvent(SoHandleEventAction * action)
         // NOTE: If preselection is off then we do not check for a picked point because otherwise this search may slow
         // down extremely the system on really big data sets. In this case we just check for a picked point if the data
         // set has been selected.
+        // On very big scenes picking may take longer than the time between two mouse move
+        // events. In this case the events that arrive while the last pick would still be
+        // running are skipped, so that the preselection doesn't lag behind the cursor.
+        // The last skipped event is picked when the time window has ended, otherwise the
+        // highlight would stay at an old position once the cursor stops.
+        SbTime now = SbTime::getTimeOfDay();
+        if ((mymode == AUTO || mymode == ON) &&
+            preSelectionDuration.getMsecValue() > 30 &&
+            now - preSelectionTime < preSelectionDuration) {
+            schedulePreselection(action);
+            inherited::handleEvent(action);
+            return;
+        }
+
+        // a pending event is obsolete now
+        if (preSelectionSensor.isScheduled())
+            preSelectionSensor.unschedule();
+
         if (mymode == AUTO || mymode == ON) {
             // check to see if the mouse is over our geometry...
             const SoPickedPoint * pp = this->getPickedPoint(action);
+            preSelectionTime = SbTime::getTimeOfDay();
+            preSelectionDuration = preSelectionTime - now;
             SoFullPath *pPath = (pp != NULL) ? (SoFullPath *) pp->getPath() : NULL;
             ViewProvider *vp = 0;
             ViewProviderDocumentObject* vpd = 0;
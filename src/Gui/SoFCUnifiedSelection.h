@@ -40,10 +40,15 @@
 #include <Inventor/fields/SoSFEnum.h>
 #include <Inventor/fields/SoSFString.h>
 #include <Inventor/nodes/SoLightModel.h>
+#include <Inventor/SbTime.h>
+#include <Inventor/SbViewportRegion.h>
+#include <Inventor/events/SoLocation2Event.h>
+#include <Inventor/sensors/SoAlarmSensor.h>
 #include "View3DInventorViewer.h"
 #include <list>
 
 class SoFullPath;
+class SoPath;
 class SoPickedPoint;
 class SoDetail;
 
@@ -104,6 +109,8 @@ private:
     //SbBool preRender(SoGLRenderAction *act, GLint &oldDepthFunc);
     static int getPriority(const SoPickedPoint* p);
     const SoPickedPoint* getPickedPoint(SoHandleEventAction*) const;
+    void schedulePreselection(SoHandleEventAction*);
+    static void preselectionTimeout(void * data, SoSensor * sensor);
     Gui::Document       *pcDocument;
 
     static SoFullPath * currenthighlight;
@@ -112,6 +119,14 @@ private:
     // -1 = not handled, 0 = not selected, 1 = selected
     int32_t preSelection;
     SoColorPacker colorpacker;
+    // end and duration of the last pick for preselection
+    SbTime preSelectionTime;
+    SbTime preSelectionDuration;
+    // the last skipped mouse move, picked when the time window has ended
+    SoAlarmSensor preSelectionSensor;
+    SoLocation2Event preSelectionEvent;
+    SbViewportRegion preSelectionViewport;
+    SoPath* preSelectionPath;
 };
 
 /**
@@ -35,6 +35,7 @@
 # include <QContextMenuEvent>
 # include <QMenu>
 # include <QPixmap>
+# include <QThread>
 # include <QTimer>
 # include <QToolTip>
 # include <QHeaderView>
@@ -65,7 +66,7 @@ const int TreeWidget::ObjectType = 1001;
 
 /* TRANSLATOR Gui::TreeWidget */
 TreeWidget::TreeWidget(QWidget* parent)
-    : QTreeWidget(parent), contextItem(0), fromOutside(false)
+    : QTreeWidget(parent), SelectionObserver(true), contextItem(0), fromOutside(false)
 {
     this->setDragEnabled(true);
     this->setAcceptDrops(true);
@@ -110,6 +111,7 @@ TreeWidget::TreeWidget(QWidget* parent)
     Application::Instance->signalRenameDocument.connect(boost::bind(&TreeWidget::slotRenameDocument, this, _1));
     Application::Instance->signalActiveDocument.connect(boost::bind(&TreeWidget::slotActiveDocument, this, _1));
     Application::Instance->signalRelabelDocument.connect(boost::bind(&TreeWidget::slotRelabelDocument, this, _1));
+    connectChangedViewObj = Application::Instance->signalChangedObject.connect(boost::bind(&TreeWidget::slotChangedViewObject, this, _1, _2));
 
     QStringList labels;
     labels << tr("Labels & Attributes");
@@ -133,7 +135,10 @@ TreeWidget::TreeWidget(QWidget* parent)
     this->setMouseTracking(true); // needed for itemEntered() to work
 #endif
 
+    // the status of the items is only checked for objects that have been changed
+    // and the checks of several changes are bundled by this single-shot timer
     this->statusTimer = new QTimer(this);
+    this->statusTimer->setSingleShot(true);
 
     connect(this->statusTimer, SIGNAL(timeout()),
             this, SLOT(onTestStatus()));
@@ -146,13 +151,12 @@ TreeWidget::TreeWidget(QWidget* parent)
     connect(this, SIGNAL(itemSelectionChanged()),
             this, SLOT(onItemSelectionChanged()));
 
-    this->statusTimer->setSingleShot(true);
-    this->statusTimer->start(300);
     documentPixmap = new QPixmap(Gui::BitmapFactory().pixmap("Document"));
 }
 
 TreeWidget::~TreeWidget()
 {
+    connectChangedViewObj.disconnect();
 }
 
 void TreeWidget::contextMenuEvent (QContextMenuEvent * e)
@@ -390,6 +394,13 @@ bool TreeWidget::event(QEvent *e)
     return QTreeWidget::event(e);
 }
 
+void TreeWidget::showEvent(QShowEvent *event)
+{
+    // changes that happened while the tree was hidden are still pending
+    scheduleStatusUpdate();
+    QTreeWidget::showEvent(event);
+}
+
 void TreeWidget::keyPressEvent(QKeyEvent *event)
 {
 #if 0
@@ -719,17 +730,57 @@ void TreeWidget::slotActiveDocument(const Gui::Document& Doc)
 }
 
 
+void TreeWidget::slotChangedViewObject(const Gui::ViewProvider& vp, const App::Property& prop)
+{
+    if (!vp.isDerivedFrom(ViewProviderDocumentObject::getClassTypeId()))
+        return;
+    const ViewProviderDocumentObject& vpd = static_cast<const ViewProviderDocumentObject&>(vp);
+    if (&prop != &vpd.Visibility)
+        return;
+    // the signal is already emitted while the view provider gets initialized
+    App::DocumentObject* obj = vpd.getObject();
+    if (!obj || !obj->getNameInDocument())
+        return;
+
+    for (std::map<const Gui::Document*,DocumentItem*>::iterator pos = DocumentMap.begin();
+         pos != DocumentMap.end(); ++pos) {
+        if (pos->first->getDocument() == obj->getDocument()) {
+            pos->second->markStatusChanged(*obj);
+            break;
+        }
+    }
+}
+
+void TreeWidget::scheduleStatusUpdate()
+{
+    if (!this->statusTimer->isActive())
+        this->statusTimer->start(300);
+}
+
+void TreeWidget::onStatusObject(const QByteArray& docName, const QByteArray& objName)
+{
+    std::map<const Gui::Document*,DocumentItem*>::iterator pos;
+    for (pos = DocumentMap.begin();pos!=DocumentMap.end();++pos) {
+        App::Document* doc = pos->first->getDocument();
+        if (docName == doc->getName()) {
+            App::DocumentObject* obj = doc->getObject(objName.constData());
+            if (obj)
+                pos->second->markStatusChanged(*obj);
+            break;
+        }
+    }
+}
+
 void TreeWidget::onTestStatus(void)
 {
+    // as long as the tree is hidden the changed items are kept until
+    // the next show event
     if (isVisible()) {
         std::map<const Gui::Document*,DocumentItem*>::iterator pos;
         for (pos = DocumentMap.begin();pos!=DocumentMap.end();++pos) {
             pos->second->testStatus();
         }
     }
-
-    this->statusTimer->setSingleShot(true);
-    this->statusTimer->start(300);
 }
 
 void TreeWidget::onItemEntered(QTreeWidgetItem * item)
@@ -820,6 +871,7 @@ void TreeWidget::onSelectionChanged(const SelectionChanges& msg)
     switch (msg.Type)
     {
     case SelectionChanges::AddSelection:
+    case SelectionChanges::AddSelections:
         {
             Gui::Document* pDoc = Application::Instance->getDocument(msg.pDocName);
             std::map<const Gui::Document*, DocumentItem*>::iterator it;
@@ -830,6 +882,7 @@ void TreeWidget::onSelectionChanged(const SelectionChanges& msg)
             this->blockConnection(lock);
         }   break;
     case SelectionChanges::RmvSelection:
+    case SelectionChanges::RmvSelections:
         {
             Gui::Document* pDoc = Application::Instance->getDocument(msg.pDocName);
             std::map<const Gui::Document*, DocumentItem*>::iterator it;
@@ -939,6 +992,7 @@ DocumentItem::DocumentItem(const Gui::Document* doc, QTreeWidgetItem * parent)
     connectResObject = doc->signalResetEdit.connect(boost::bind(&DocumentItem::slotResetEdit, this, _1));
     connectHltObject = doc->signalHighlightObject.connect(boost::bind(&DocumentItem::slotHighlightObject, this, _1,_2,_3));
     connectExpObject = doc->signalExpandObject.connect(boost::bind(&DocumentItem::slotExpandObject, this, _1,_2));
+    connectStaObject = doc->getDocument()->signalChangedObjectStatus.connect(boost::bind(&DocumentItem::slotStatusObject, this, _1));
 
     setFlags(Qt::ItemIsEnabled/*|Qt::ItemIsEditable*/);
 }
@@ -954,6 +1008,7 @@ DocumentItem::~DocumentItem()
     connectResObject.disconnect();
     connectHltObject.disconnect();
     connectExpObject.disconnect();
+    connectStaObject.disconnect();
 }
 
 void DocumentItem::slotInEdit(const Gui::ViewProviderDocumentObject& v)
@@ -986,6 +1041,7 @@ void DocumentItem::slotNewObject(const Gui::ViewProviderDocumentObject& obj)
             item->setIcon(0, obj.getIcon());
             item->setText(0, QString::fromUtf8(displayName.c_str()));
             ObjectMap[objectName] = item;
+            markStatusChanged(*obj.getObject());
 
             // it may be possible that the new object claims already existing objects. If this is the 
             // case we need to make sure this is shown by the tree
@@ -1034,6 +1090,7 @@ void DocumentItem::slotDeleteObject(const Gui::ViewProviderDocumentObject& view)
         parent->takeChild(parent->indexOfChild(it->second));
         delete it->second;
         ObjectMap.erase(it);
+        ChangedStatus.erase(objectName);
     }
 }
 
@@ -1045,6 +1102,9 @@ void DocumentItem::slotChangeObject(const Gui::ViewProviderDocumentObject& view)
     std::string objectName = obj->getNameInDocument();
     std::map<std::string, DocumentObjectItem*>::iterator it = ObjectMap.find(objectName);
     if (it != ObjectMap.end()) {
+        // a changed property may affect the touched state
+        markStatusChanged(*obj);
+
          // use new grouping style
             DocumentObjectItem* parent_of_group = it->second;
             std::set<QTreeWidgetItem*> children;
@@ -1240,10 +1300,67 @@ const Gui::Document* DocumentItem::document() const
 //    }
 //}
 
+void DocumentItem::slotStatusObject(const App::DocumentObject& obj)
+{
+    // the status may also change in a worker thread but the items must
+    // only be accessed in the GUI thread
+    if (QThread::currentThread() != QApplication::instance()->thread()) {
+        const char* name = obj.getNameInDocument();
+        QTreeWidget* tree = treeWidget();
+        if (name && tree) {
+            QMetaObject::invokeMethod(tree, "onStatusObject", Qt::QueuedConnection,
+                Q_ARG(QByteArray, QByteArray(obj.getDocument()->getName())),
+                Q_ARG(QByteArray, QByteArray(name)));
+        }
+        return;
+    }
+
+    markStatusChanged(obj);
+}
+
+void DocumentItem::markStatusChanged(const App::DocumentObject& obj)
+{
+    const char* name = obj.getNameInDocument();
+    if (!name)
+        return;
+    ChangedStatus.insert(name);
+    QTreeWidget* tree = treeWidget();
+    if (tree)
+        static_cast<TreeWidget*>(tree)->scheduleStatusUpdate();
+}
+
 void DocumentItem::testStatus(void)
 {
-    for (std::map<std::string,DocumentObjectItem*>::iterator pos = ObjectMap.begin();pos!=ObjectMap.end();++pos) {
-        pos->second->testStatus();
+    std::set<std::string> changed;
+    changed.swap(ChangedStatus);
+    if (changed.empty())
+        return;
+
+    // The mustExecute() of the dependent objects may check the touched
+    // state of a changed object, so their icons must be tested as well.
+    // The dependents of the whole batch are collected in a single pass
+    // over the out-lists because getInList() scans the whole document.
+    std::vector<std::string> dependents;
+    std::vector<App::DocumentObject*> objs = pDocument->getDocument()->getObjects();
+    for (std::vector<App::DocumentObject*>::iterator it = objs.begin(); it != objs.end(); ++it) {
+        const char* name = (*it)->getNameInDocument();
+        if (!name || changed.find(name) != changed.end())
+            continue;
+        std::vector<App::DocumentObject*> outList = (*it)->getOutList();
+        for (std::vector<App::DocumentObject*>::iterator jt = outList.begin(); jt != outList.end(); ++jt) {
+            const char* dep = *jt ? (*jt)->getNameInDocument() : 0;
+            if (dep && changed.find(dep) != changed.end()) {
+                dependents.push_back(name);
+                break;
+            }
+        }
+    }
+    changed.insert(dependents.begin(), dependents.end());
+
+    for (std::set<std::string>::iterator jt = changed.begin(); jt != changed.end(); ++jt) {
+        std::map<std::string,DocumentObjectItem*>::iterator pos = ObjectMap.find(*jt);
+        if (pos != ObjectMap.end())
+            pos->second->testStatus();
     }
 }
 
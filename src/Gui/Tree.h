@@ -24,6 +24,7 @@
 #ifndef GUI_TREE_H
 #define GUI_TREE_H
 
+#include <set>
 #include <QTreeWidget>
 
 #include <App/Document.h>
@@ -35,6 +36,7 @@
 
 namespace Gui {
 
+class ViewProvider;
 class ViewProviderDocumentObject;
 class DocumentObjectItem;
 class DocumentItem;
@@ -73,6 +75,8 @@ public:
     static const int ObjectType;
 
     void markItem(const App::DocumentObject* Obj,bool mark);
+    /// Schedules a status check of all items that have been marked as changed
+    void scheduleStatusUpdate();
 
 protected:
     /// Observer message from the Selection
@@ -92,6 +96,7 @@ protected:
     void dropEvent(QDropEvent *event);
     //@}
     bool event(QEvent *e);
+    void showEvent(QShowEvent *event);
     void keyPressEvent(QKeyEvent *event);
     void mouseDoubleClickEvent(QMouseEvent * event);
 
@@ -110,6 +115,7 @@ private Q_SLOTS:
     void onItemCollapsed(QTreeWidgetItem * item);
     void onItemExpanded(QTreeWidgetItem * item);
     void onTestStatus(void);
+    void onStatusObject(const QByteArray&, const QByteArray&);
 
 private:
     void slotNewDocument(const Gui::Document&);
@@ -117,6 +123,7 @@ private:
     void slotRenameDocument(const Gui::Document&);
     void slotActiveDocument(const Gui::Document&);
     void slotRelabelDocument(const Gui::Document&);
+    void slotChangedViewObject(const Gui::ViewProvider&, const App::Property&);
 
     void changeEvent(QEvent *e);
 
@@ -133,6 +140,9 @@ private:
     static QPixmap* documentPixmap;
     std::map<const Gui::Document*,DocumentItem*> DocumentMap;
     bool fromOutside;
+
+    typedef boost::BOOST_SIGNALS_NAMESPACE::connection Connection;
+    Connection connectChangedViewObj;
 };
 
 /** The link between the tree and a document.
@@ -152,7 +162,10 @@ public:
     void clearSelection(void);
     void updateSelection(void);
     void selectItems(void);
+    /// Updates the status of all items that have been marked as changed
     void testStatus(void);
+    /// Marks the item of the given object to get its status updated
+    void markStatusChanged(const App::DocumentObject&);
     void setData(int column, int role, const QVariant & value);
 
 protected:
@@ -171,11 +184,13 @@ protected:
     void slotResetEdit       (const Gui::ViewProviderDocumentObject&);
     void slotHighlightObject (const Gui::ViewProviderDocumentObject&,const Gui::HighlightMode&,bool);
     void slotExpandObject    (const Gui::ViewProviderDocumentObject&,const Gui::TreeItemMode&);
+    void slotStatusObject    (const App::DocumentObject&);
     std::vector<DocumentObjectItem*> getAllParents(DocumentObjectItem*) const;
 
 private:
     const Gui::Document* pDocument;
     std::map<std::string,DocumentObjectItem*> ObjectMap;
+    std::set<std::string> ChangedStatus;
 
     typedef boost::BOOST_SIGNALS_NAMESPACE::connection Connection;
     Connection connectNewObject;
@@ -187,6 +202,7 @@ private:
     Connection connectResObject;
     Connection connectHltObject;
     Connection connectExpObject;
+    Connection connectStaObject;
 };
 
 /** The link between the tree and a document object.
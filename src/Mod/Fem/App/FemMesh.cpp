@@ -35,6 +35,7 @@
 # include <gp_Pnt.hxx>
 #endif
 
+#include <Base/BatchTransform.h>
 #include <Base/Writer.h>
 #include <Base/Reader.h>
 #include <Base/Stream.h>
@@ -63,6 +64,8 @@
 #include <SMESHDS_Group.hxx>
 #include <SMDS_PolyhedralVolumeOfNodes.hxx>
 #include <SMDS_VolumeTool.hxx>
+#include <SMDS_VtkVolume.hxx>
+#include <SMDS_BallElement.hxx>
 #include <StdMeshers_MaxLength.hxx>
 #include <StdMeshers_LocalLength.hxx>
 #include <StdMeshers_MaxElementArea.hxx>
@@ -81,6 +84,8 @@
 //to simplify parsing input files we use the boost lib
 #include <boost/tokenizer.hpp>
 
+#include <QMutex>
+
 
 using namespace Fem;
 using namespace Base;
@@ -538,6 +543,9 @@ void FemMesh::setStandardHypotheses()
 
 void FemMesh::compute()
 {
+    // the generator and its algorithms are shared by all meshes
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
     getGenerator()->Compute(*myMesh, myMesh->GetShapeToMesh());
 }
 
@@ -1376,7 +1384,7 @@ void FemMesh::Save (Base::Writer &writer) const
     if (!writer.isForceXML()) {
         //See SaveDocFile(), RestoreDocFile()
         writer.Stream() << writer.ind() << "<FemMesh file=\"" ;
-        writer.Stream() << writer.addFile("FemMesh.unv", this) << "\"";
+        writer.Stream() << writer.addFile("FemMesh.bin", this) << "\"";
         writer.Stream() << " a11=\"" <<  _Mtrx[0][0] << "\" a12=\"" <<  _Mtrx[0][1] << "\" a13=\"" <<  _Mtrx[0][2] << "\" a14=\"" <<  _Mtrx[0][3] << "\"";
         writer.Stream() << " a21=\"" <<  _Mtrx[1][0] << "\" a22=\"" <<  _Mtrx[1][1] << "\" a23=\"" <<  _Mtrx[1][2] << "\" a24=\"" <<  _Mtrx[1][3] << "\"";
         writer.Stream() << " a31=\"" <<  _Mtrx[2][0] << "\" a32=\"" <<  _Mtrx[2][1] << "\" a33=\"" <<  _Mtrx[2][2] << "\" a34=\"" <<  _Mtrx[2][3] << "\"";
@@ -1425,31 +1433,163 @@ void FemMesh::Restore(Base::XMLReader &reader)
     }
 }
 
+namespace Fem {
+// Binary mesh format, all numbers are stored in little endian byte order:
+//   magic "FCFEMBIN", uint32 version
+//   uint32 number of nodes, int32 node ids, double coordinates
+//   uint32 number of element blocks, for each block:
+//     int32 element type, uint8 polygon/quadratic flags, uint32 nodes per element, uint32 number of elements,
+//     int32 element ids, uint32 connectivity as indices into the node arrays
+//   uint32 number of polyhedra, for each one:
+//     int32 id, uint32 number of nodes, uint32 node indices, uint32 number of faces, int32 quantities
+//   uint32 number of balls, for each one: int32 id, uint32 node index, double diameter
+//   uint32 number of groups, for each group:
+//     uint32 name length, name, int32 group type, uint32 number of elements, int32 element ids
+static const char FemMeshBinaryMagic[8] = {'F','C','F','E','M','B','I','N'};
+static const uint32_t FemMeshBinaryVersion = 1;
+
+struct FemMeshBlock
+{
+    std::vector<int32_t> ids;
+    std::vector<uint32_t> connectivity;
+};
+
+// element type, polygon/quadratic flags and number of nodes
+typedef std::pair<std::pair<int32_t, uint8_t>, uint32_t> FemMeshBlockKey;
+static const uint8_t FemMeshPolyFlag = 1;
+static const uint8_t FemMeshQuadFlag = 2;
+}
+
 void FemMesh::SaveDocFile (Base::Writer &writer) const
 {
-    // create a temporary file and copy the content to the zip stream
-    Base::FileInfo fi(App::Application::getTempFileName().c_str());
+    Base::TimeInfo Start;
+    SMESHDS_Mesh* meshDS = myMesh->GetMeshDS();
+    Base::OutputStream str(writer.Stream());
+    writer.Stream().write(FemMeshBinaryMagic, sizeof(FemMeshBinaryMagic));
+    str << FemMeshBinaryVersion;
+
+    // nodes, the connectivity refers to the position in this array
+    std::vector<uint32_t> nodeIndex(meshDS->MaxNodeID() + 1, 0);
+    uint32_t numNodes = static_cast<uint32_t>(meshDS->NbNodes());
+    std::vector<int32_t> nodeIds;
+    std::vector<double> coords;
+    nodeIds.reserve(numNodes);
+    coords.reserve(3 * numNodes);
+
+    SMDS_NodeIteratorPtr aNodeIter = meshDS->nodesIterator();
+    while (aNodeIter->more()) {
+        const SMDS_MeshNode* aNode = aNodeIter->next();
+        nodeIndex[aNode->GetID()] = static_cast<uint32_t>(nodeIds.size());
+        nodeIds.push_back(aNode->GetID());
+        coords.push_back(aNode->X());
+        coords.push_back(aNode->Y());
+        coords.push_back(aNode->Z());
+    }
 
-    myMesh->ExportUNV(fi.filePath().c_str());
+    str << static_cast<uint32_t>(nodeIds.size());
+    for (std::vector<int32_t>::iterator it = nodeIds.begin(); it != nodeIds.end(); ++it)
+        str << *it;
+    for (std::vector<double>::iterator it = coords.begin(); it != coords.end(); ++it)
+        str << *it;
+
+    // elements with the same type and number of nodes are grouped in blocks
+    std::map<FemMeshBlockKey, FemMeshBlock> blocks;
+    std::vector<const SMDS_MeshElement*> polyhedra;
+    std::vector<const SMDS_MeshElement*> balls;
+
+    SMDS_ElemIteratorPtr aElemIter = meshDS->elementsIterator();
+    while (aElemIter->more()) {
+        const SMDS_MeshElement* aElem = aElemIter->next();
+        if (aElem->GetType() == SMDSAbs_Node)
+            continue;
+        if (aElem->GetEntityType() == SMDSEntity_Polyhedra) {
+            polyhedra.push_back(aElem);
+            continue;
+        }
+        if (aElem->GetEntityType() == SMDSEntity_Ball) {
+            balls.push_back(aElem);
+            continue;
+        }
 
-    Base::ifstream file(fi, std::ios::in | std::ios::binary);
-    if (file){
-        std::streambuf* buf = file.rdbuf();
-        writer.Stream() << buf;
+        uint8_t flags = 0;
+        if (aElem->IsPoly())
+            flags |= FemMeshPolyFlag;
+        if (aElem->IsQuadratic())
+            flags |= FemMeshQuadFlag;
+        uint32_t numElemNodes = static_cast<uint32_t>(aElem->NbNodes());
+        FemMeshBlockKey key(std::make_pair(static_cast<int32_t>(aElem->GetType()), flags), numElemNodes);
+        FemMeshBlock& block = blocks[key];
+        block.ids.push_back(aElem->GetID());
+        SMDS_ElemIteratorPtr nIt = aElem->nodesIterator();
+        while (nIt->more())
+            block.connectivity.push_back(nodeIndex[nIt->next()->GetID()]);
     }
 
-    file.close();
-    // remove temp file
-    fi.deleteFile();
+    str << static_cast<uint32_t>(blocks.size());
+    for (std::map<FemMeshBlockKey, FemMeshBlock>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        str << it->first.first.first << it->first.first.second << it->first.second;
+        str << static_cast<uint32_t>(it->second.ids.size());
+        for (std::vector<int32_t>::iterator jt = it->second.ids.begin(); jt != it->second.ids.end(); ++jt)
+            str << *jt;
+        for (std::vector<uint32_t>::iterator jt = it->second.connectivity.begin(); jt != it->second.connectivity.end(); ++jt)
+            str << *jt;
+    }
+
+    str << static_cast<uint32_t>(polyhedra.size());
+    for (std::vector<const SMDS_MeshElement*>::iterator it = polyhedra.begin(); it != polyhedra.end(); ++it) {
+        str << static_cast<int32_t>((*it)->GetID());
+        str << static_cast<uint32_t>((*it)->NbNodes());
+        SMDS_ElemIteratorPtr nIt = (*it)->nodesIterator();
+        while (nIt->more())
+            str << nodeIndex[nIt->next()->GetID()];
+        std::vector<int> quantities = static_cast<const SMDS_VtkVolume*>(*it)->GetQuantities();
+        str << static_cast<uint32_t>(quantities.size());
+        for (std::vector<int>::iterator jt = quantities.begin(); jt != quantities.end(); ++jt)
+            str << static_cast<int32_t>(*jt);
+    }
+
+    str << static_cast<uint32_t>(balls.size());
+    for (std::vector<const SMDS_MeshElement*>::iterator it = balls.begin(); it != balls.end(); ++it) {
+        str << static_cast<int32_t>((*it)->GetID());
+        str << nodeIndex[(*it)->GetNode(0)->GetID()];
+        str << static_cast<double>(static_cast<const SMDS_BallElement*>(*it)->GetDiameter());
+    }
+
+    // groups
+    std::list<int> grpIds = myMesh->GetGroupIds();
+    str << static_cast<uint32_t>(grpIds.size());
+    for (std::list<int>::iterator it = grpIds.begin(); it != grpIds.end(); ++it) {
+        SMESHDS_GroupBase* groupDS = myMesh->GetGroup(*it)->GetGroupDS();
+        std::string name = groupDS->GetStoreName();
+        str << static_cast<uint32_t>(name.size());
+        writer.Stream().write(name.c_str(), name.size());
+        str << static_cast<int32_t>(groupDS->GetType());
+        str << static_cast<uint32_t>(groupDS->Extent());
+        SMDS_ElemIteratorPtr eIt = groupDS->GetElements();
+        while (eIt->more())
+            str << static_cast<int32_t>(eIt->next()->GetID());
+    }
+
+    Base::Console().Log("FemMesh::SaveDocFile: %f s\n", Base::TimeInfo::diffTimeF(Start, Base::TimeInfo()));
 }
 
 void FemMesh::RestoreDocFile(Base::Reader &reader)
 {
+    char magic[sizeof(FemMeshBinaryMagic)];
+    reader.read(magic, sizeof(magic));
+    std::streamsize numRead = reader.gcount();
+    if (numRead == sizeof(magic) && std::equal(magic, magic + sizeof(magic), FemMeshBinaryMagic)) {
+        readBinary(reader);
+        return;
+    }
+
+    // Older project files contain the mesh in UNV format
     // create a temporary file and copy the content from the zip stream
     Base::FileInfo fi(App::Application::getTempFileName().c_str());
 
     // read in the ASCII file and write back to the file stream
     Base::ofstream file(fi, std::ios::out | std::ios::binary);
+    file.write(magic, numRead);
     if (reader)
         reader >> file.rdbuf();
     file.close();
@@ -1461,18 +1601,156 @@ void FemMesh::RestoreDocFile(Base::Reader &reader)
     fi.deleteFile();
 }
 
+void FemMesh::readBinary(std::istream &in)
+{
+    Base::TimeInfo Start;
+    Base::InputStream str(in);
+    uint32_t version = 0;
+    str >> version;
+    if (version > FemMeshBinaryVersion)
+        throw Base::FileException("Unsupported version of binary FEM mesh data");
+
+    SMESHDS_Mesh* meshDS = myMesh->GetMeshDS();
+    meshDS->ClearMesh();
+    SMESH_MeshEditor editor(myMesh);
+
+    uint32_t numNodes = 0;
+    str >> numNodes;
+    std::vector<int32_t> nodeIds(numNodes);
+    for (std::vector<int32_t>::iterator it = nodeIds.begin(); it != nodeIds.end(); ++it)
+        str >> *it;
+
+    std::vector<const SMDS_MeshNode*> nodes(numNodes);
+    for (uint32_t i = 0; i < numNodes; i++) {
+        double x, y, z;
+        str >> x >> y >> z;
+        nodes[i] = meshDS->AddNodeWithID(x, y, z, nodeIds[i]);
+    }
+
+    std::vector<const SMDS_MeshNode*> elemNodes;
+    uint32_t numBlocks = 0;
+    str >> numBlocks;
+    for (uint32_t i = 0; i < numBlocks; i++) {
+        int32_t type;
+        uint8_t flags;
+        uint32_t numElemNodes, numElems;
+        str >> type >> flags >> numElemNodes >> numElems;
+
+        std::vector<int32_t> ids(numElems);
+        for (std::vector<int32_t>::iterator it = ids.begin(); it != ids.end(); ++it)
+            str >> *it;
+
+        elemNodes.resize(numElemNodes);
+        SMESH_MeshEditor::ElemFeatures elemFeat(static_cast<SMDSAbs_ElementType>(type),
+                                                (flags & FemMeshPolyFlag) != 0,
+                                                (flags & FemMeshQuadFlag) != 0);
+        for (uint32_t j = 0; j < numElems; j++) {
+            for (uint32_t k = 0; k < numElemNodes; k++) {
+                uint32_t index;
+                str >> index;
+                elemNodes[k] = nodes.at(index);
+            }
+            elemFeat.SetID(ids[j]);
+            editor.AddElement(elemNodes, elemFeat);
+        }
+    }
+
+    uint32_t numPolyhedra = 0;
+    str >> numPolyhedra;
+    for (uint32_t i = 0; i < numPolyhedra; i++) {
+        int32_t id;
+        uint32_t numElemNodes, numFaces;
+        str >> id >> numElemNodes;
+        elemNodes.resize(numElemNodes);
+        for (uint32_t k = 0; k < numElemNodes; k++) {
+            uint32_t index;
+            str >> index;
+            elemNodes[k] = nodes.at(index);
+        }
+        str >> numFaces;
+        std::vector<int> quantities(numFaces);
+        for (uint32_t k = 0; k < numFaces; k++) {
+            int32_t q;
+            str >> q;
+            quantities[k] = q;
+        }
+        meshDS->AddPolyhedralVolumeWithID(elemNodes, quantities, id);
+    }
+
+    uint32_t numBalls = 0;
+    str >> numBalls;
+    for (uint32_t i = 0; i < numBalls; i++) {
+        int32_t id;
+        uint32_t index;
+        double diameter;
+        str >> id >> index >> diameter;
+        meshDS->AddBallWithID(nodes.at(index), diameter, id);
+    }
+
+    uint32_t numGroups = 0;
+    str >> numGroups;
+    for (uint32_t i = 0; i < numGroups; i++) {
+        uint32_t length;
+        str >> length;
+        std::string name(length, ' ');
+        if (length > 0)
+            in.read(&name[0], length);
+
+        int32_t type;
+        uint32_t numElems;
+        str >> type >> numElems;
+
+        int aId;
+        SMDSAbs_ElementType groupType = static_cast<SMDSAbs_ElementType>(type);
+        SMESH_Group* group = myMesh->AddGroup(groupType, name.c_str(), aId);
+        SMESHDS_Group* groupDS = group ? dynamic_cast<SMESHDS_Group*>(group->GetGroupDS()) : 0;
+        for (uint32_t j = 0; j < numElems; j++) {
+            int32_t id;
+            str >> id;
+            if (!groupDS)
+                continue;
+            const SMDS_MeshElement* aElem = (groupType == SMDSAbs_Node)
+                ? static_cast<const SMDS_MeshElement*>(meshDS->FindNode(id))
+                : meshDS->FindElement(id);
+            if (aElem)
+                groupDS->SMDSGroup().Add(aElem);
+        }
+    }
+
+    meshDS->Modified();
+    Base::Console().Log("FemMesh::RestoreDocFile: %f s\n", Base::TimeInfo::diffTimeF(Start, Base::TimeInfo()));
+}
+
 void FemMesh::transformGeometry(const Base::Matrix4D& rclTrf)
 {
     //We perform a translation and rotation of the current active Mesh object
-    Base::Matrix4D clMatrix(rclTrf);
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    Base::Vector3d current_node;
+    Base::BatchTransform trf(rclTrf);
+    if (trf.isIdentity())
+        return;
+
+    // gather the coordinates, transform them in one go and move the nodes
+    SMESHDS_Mesh* meshDS = myMesh->GetMeshDS();
+    std::vector<const SMDS_MeshNode*> nodes;
+    nodes.reserve(meshDS->NbNodes());
+    std::vector<double> x, y, z;
+    x.reserve(meshDS->NbNodes());
+    y.reserve(meshDS->NbNodes());
+    z.reserve(meshDS->NbNodes());
+
+    SMDS_NodeIteratorPtr aNodeIter = meshDS->nodesIterator();
     for (;aNodeIter->more();) {
         const SMDS_MeshNode* aNode = aNodeIter->next();
-        current_node.Set(aNode->X(),aNode->Y(),aNode->Z());
-        current_node = clMatrix * current_node;
-        myMesh->GetMeshDS()->MoveNode(aNode,current_node.x,current_node.y,current_node.z);
+        nodes.push_back(aNode);
+        x.push_back(aNode->X());
+        y.push_back(aNode->Y());
+        z.push_back(aNode->Z());
     }
+
+    if (nodes.empty())
+        return;
+    trf.apply(&x[0], &y[0], &z[0], nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); i++)
+        meshDS->MoveNode(nodes[i], x[i], y[i], z[i]);
 }
 
 void FemMesh::setTransform(const Base::Matrix4D& rclTrf)
@@ -149,6 +149,7 @@ public:
 private:
     void copyMeshData(const FemMesh&);
     void readNastran(const std::string &Filename);
+    void readBinary(std::istream&);
 
 private:
     /// positioning matrix
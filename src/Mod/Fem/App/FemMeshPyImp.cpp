@@ -40,6 +40,9 @@
 #include <Base/MatrixPy.h>
 #include <Base/PlacementPy.h>
 #include <Base/QuantityPy.h>
+#include <Base/Interpreter.h>
+#include <Base/BatchTransform.h>
+#include <Base/BufferProtocol.h>
 
 #include <Mod/Part/App/TopoShapePy.h>
 #include <Mod/Part/App/TopoShapeSolidPy.h>
@@ -177,6 +180,7 @@ PyObject* FemMeshPy::compute(PyObject *args)
         return 0;
 
     try {
+        Base::PyGILStateRelease unlock;
         getFemMeshPtr()->compute();
     }
     catch (const std::exception& e) {
@@ -226,6 +230,46 @@ PyObject* FemMeshPy::addNode(PyObject *args)
     return 0;
 }
 
+PyObject* FemMeshPy::addNodes(PyObject *args)
+{
+    PyObject *obj, *idObj=0;
+    if (!PyArg_ParseTuple(args, "O|O",&obj,&idObj))
+        return 0;
+
+    try {
+        std::vector<double> coords;
+        std::vector<unsigned long> ids;
+        Base::BufferProtocol::getDoubles(obj, 3, coords);
+        if (idObj) {
+            Base::BufferProtocol::getIndices(idObj, 1, ids);
+            if (ids.size() * 3 != coords.size())
+                throw std::runtime_error("Number of node IDs doesn't match number of nodes");
+        }
+
+        SMESH_Mesh* mesh = getFemMeshPtr()->getSMesh();
+        SMESHDS_Mesh* meshDS = mesh->GetMeshDS();
+        std::size_t numNodes = coords.size() / 3;
+        Py::Tuple tuple(numNodes);
+        for (std::size_t i = 0; i < numNodes; i++) {
+            const double* p = &coords[3*i];
+            SMDS_MeshNode* node = idObj ? meshDS->AddNodeWithID(p[0],p[1],p[2],(int)ids[i])
+                                        : meshDS->AddNode(p[0],p[1],p[2]);
+            if (!node)
+                throw std::runtime_error("Failed to add node");
+            tuple.setItem(i, Py::Int(node->GetID()));
+        }
+        return Py::new_reference_to(tuple);
+    }
+    catch (const Base::Exception& e) {
+        PyErr_SetString(Base::BaseExceptionFreeCADError, e.what());
+        return 0;
+    }
+    catch (const std::exception& e) {
+        PyErr_SetString(Base::BaseExceptionFreeCADError, e.what());
+        return 0;
+    }
+}
+
 PyObject* FemMeshPy::addEdge(PyObject *args)
 {
     SMESH_Mesh* mesh = getFemMeshPtr()->getSMesh();
@@ -768,6 +812,37 @@ PyObject* FemMeshPy::getNodeById(PyObject *args)
     }
 }
 
+PyObject* FemMeshPy::getNodeArray(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return 0;
+
+    SMESHDS_Mesh* meshDS = getFemMeshPtr()->getSMesh()->GetMeshDS();
+    std::size_t numNodes = meshDS->NbNodes();
+    int32_t* ids;
+    double* coords;
+    Py::Object idArray(Base::BufferProtocol::createArray(numNodes, ids), true);
+    Py::Object coordArray(Base::BufferProtocol::createArray(3 * numNodes, coords), true);
+
+    double* ptr = coords;
+    SMDS_NodeIteratorPtr aNodeIter = meshDS->nodesIterator();
+    while (aNodeIter->more()) {
+        const SMDS_MeshNode* aNode = aNodeIter->next();
+        *ids++ = aNode->GetID();
+        *ptr++ = aNode->X();
+        *ptr++ = aNode->Y();
+        *ptr++ = aNode->Z();
+    }
+
+    // Apply the matrix to hold the nodes in absolute space.
+    Base::BatchTransform(getFemMeshPtr()->getTransform()).apply(coords, numNodes);
+
+    Py::Tuple tuple(2);
+    tuple.setItem(0, idArray);
+    tuple.setItem(1, coordArray);
+    return Py::new_reference_to(tuple);
+}
+
 PyObject* FemMeshPy::getNodesBySolid(PyObject *args)
 {
     PyObject *pW;
@@ -25,6 +25,7 @@
 
 #ifndef _PreComp_
 # include <cstdlib>
+# include <cstring>
 # include <memory>
 # include <cmath>
 
@@ -132,7 +133,7 @@ void FemVTKTools::importVTKMesh(vtkSmartPointer<vtkDataSet> dataset, FemMesh* me
     for(vtkIdType iCell=0; iCell<nCells; iCell++)
     {
         idlist->Reset();
-        idlist = dataset->GetCell(iCell)->GetPointIds();
+        dataset->GetCellPoints(iCell, idlist);
         vtkIdType *ids = idlist->GetPointer(0);
         // 3D cells first
         switch(dataset->GetCellType(iCell))
@@ -206,178 +207,71 @@ FemMesh* FemVTKTools::readVTKMesh(const char* filename, FemMesh* mesh)
     return mesh;
 }
 
-void exportFemMeshFaces(vtkSmartPointer<vtkUnstructuredGrid> grid, const SMDS_FaceIteratorPtr& aFaceIter)
+int vtkCellTypeOfFace(int numNodes)
 {
-
-    vtkSmartPointer<vtkCellArray> triangleArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> quadTriangleArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> quadArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> quadQuadArray = vtkSmartPointer<vtkCellArray>::New();
-
-    for (;aFaceIter->more();)
-    {
-        const SMDS_MeshFace* aFace = aFaceIter->next();
-
-        //triangle
-        if(aFace->NbNodes() == 3)
-        {
-            vtkSmartPointer<vtkTriangle> tria = vtkSmartPointer<vtkTriangle>::New();
-            tria->GetPointIds()->SetId(0, aFace->GetNode(0)->GetID()-1);
-            tria->GetPointIds()->SetId(1, aFace->GetNode(1)->GetID()-1);
-            tria->GetPointIds()->SetId(2, aFace->GetNode(2)->GetID()-1);
-
-            triangleArray->InsertNextCell(tria);
-        }
-        //quad
-        else if(aFace->NbNodes() == 4)
-        {
-            vtkSmartPointer<vtkQuad> quad = vtkSmartPointer<vtkQuad>::New();
-            quad->GetPointIds()->SetId(0, aFace->GetNode(0)->GetID()-1);
-            quad->GetPointIds()->SetId(1, aFace->GetNode(1)->GetID()-1);
-            quad->GetPointIds()->SetId(2, aFace->GetNode(2)->GetID()-1);
-            quad->GetPointIds()->SetId(3, aFace->GetNode(3)->GetID()-1);
-            
-            quadArray->InsertNextCell(quad);
-        }
-        //quadratic triangle
-        else if (aFace->NbNodes() == 6)
-        {
-            vtkSmartPointer<vtkQuadraticTriangle> tria = vtkSmartPointer<vtkQuadraticTriangle>::New();
-            tria->GetPointIds()->SetId(0, aFace->GetNode(0)->GetID()-1);
-            tria->GetPointIds()->SetId(1, aFace->GetNode(1)->GetID()-1);
-            tria->GetPointIds()->SetId(2, aFace->GetNode(2)->GetID()-1);
-            tria->GetPointIds()->SetId(3, aFace->GetNode(3)->GetID()-1);
-            tria->GetPointIds()->SetId(4, aFace->GetNode(4)->GetID()-1);
-            tria->GetPointIds()->SetId(5, aFace->GetNode(5)->GetID()-1);
-            quadTriangleArray->InsertNextCell(tria);
-        }
-        //quadratic quad
-        else if(aFace->NbNodes() == 8)
-        {
-            vtkSmartPointer<vtkQuadraticQuad> quad = vtkSmartPointer<vtkQuadraticQuad>::New();
-            quad->GetPointIds()->SetId(0, aFace->GetNode(0)->GetID()-1);
-            quad->GetPointIds()->SetId(1, aFace->GetNode(1)->GetID()-1);
-            quad->GetPointIds()->SetId(2, aFace->GetNode(2)->GetID()-1);
-            quad->GetPointIds()->SetId(3, aFace->GetNode(3)->GetID()-1);
-            quad->GetPointIds()->SetId(4, aFace->GetNode(4)->GetID()-1);
-            quad->GetPointIds()->SetId(5, aFace->GetNode(5)->GetID()-1);
-            quad->GetPointIds()->SetId(6, aFace->GetNode(6)->GetID()-1);
-            quad->GetPointIds()->SetId(7, aFace->GetNode(7)->GetID()-1);
-            
-            quadQuadArray->InsertNextCell(quad);
-        }
-     }
-     if(triangleArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_TRIANGLE, triangleArray);
-
-     if(quadArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_QUAD, quadArray);
-
-     if(quadTriangleArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_QUADRATIC_TRIANGLE, quadTriangleArray);
-        
-     if(quadQuadArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_QUADRATIC_QUAD, quadQuadArray);
-
+    switch (numNodes) {
+    case 3:
+        return VTK_TRIANGLE;
+    case 4:
+        return VTK_QUAD;
+    case 6:
+        return VTK_QUADRATIC_TRIANGLE;
+    case 8:
+        return VTK_QUADRATIC_QUAD;
+    default:
+        return VTK_EMPTY_CELL;
+    }
 }
 
-void exportFemMeshCells(vtkSmartPointer<vtkUnstructuredGrid> grid, const SMDS_VolumeIteratorPtr& aVolIter)
+int vtkCellTypeOfVolume(int numNodes)
 {
-    // add common CFD cells like hex, wedge, prism, in addition to tetra
-    vtkSmartPointer<vtkCellArray> tetraArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> hexaArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> wedgeArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> pyramidArray = vtkSmartPointer<vtkCellArray>::New();
-    // quadratic elemnts with 13 and 15 nodes are not added yet
-    vtkSmartPointer<vtkCellArray> quadTetraArray = vtkSmartPointer<vtkCellArray>::New();
-    vtkSmartPointer<vtkCellArray> quadHexaArray = vtkSmartPointer<vtkCellArray>::New();
-     
-    for (;aVolIter->more();)
-    {
-        const SMDS_MeshVolume* aVol = aVolIter->next();
-
-        //tetrahedra
-        if(aVol->NbNodes() == 4) {
-            vtkSmartPointer<vtkTetra> tetra = vtkSmartPointer<vtkTetra>::New();
-            tetra->GetPointIds()->SetId(0, aVol->GetNode(0)->GetID()-1);
-            tetra->GetPointIds()->SetId(1, aVol->GetNode(1)->GetID()-1);
-            tetra->GetPointIds()->SetId(2, aVol->GetNode(2)->GetID()-1);
-            tetra->GetPointIds()->SetId(3, aVol->GetNode(3)->GetID()-1);
-
-            tetraArray->InsertNextCell(tetra);
-        }
-        // common cell types for CFD
-        if(aVol->NbNodes() == 5) {
-            vtkSmartPointer<vtkPyramid> cell= vtkSmartPointer<vtkPyramid>::New();
-            cell->GetPointIds()->SetId(0, aVol->GetNode(0)->GetID()-1);
-            cell->GetPointIds()->SetId(1, aVol->GetNode(1)->GetID()-1);
-            cell->GetPointIds()->SetId(2, aVol->GetNode(2)->GetID()-1);
-            cell->GetPointIds()->SetId(3, aVol->GetNode(3)->GetID()-1);
-            cell->GetPointIds()->SetId(4, aVol->GetNode(4)->GetID()-1);
-        
-            pyramidArray->InsertNextCell(cell);
-        }
-        if(aVol->NbNodes() == 6) {
-            vtkSmartPointer<vtkWedge> cell = vtkSmartPointer<vtkWedge>::New();
-            cell->GetPointIds()->SetId(0, aVol->GetNode(0)->GetID()-1);
-            cell->GetPointIds()->SetId(1, aVol->GetNode(1)->GetID()-1);
-            cell->GetPointIds()->SetId(2, aVol->GetNode(2)->GetID()-1);
-            cell->GetPointIds()->SetId(3, aVol->GetNode(3)->GetID()-1);
-            cell->GetPointIds()->SetId(4, aVol->GetNode(4)->GetID()-1);
-            cell->GetPointIds()->SetId(5, aVol->GetNode(5)->GetID()-1);
-        
-            wedgeArray->InsertNextCell(cell);
-        }
-        if(aVol->NbNodes() == 8) {
-            vtkSmartPointer<vtkHexahedron> cell= vtkSmartPointer<vtkHexahedron>::New();
-            cell->GetPointIds()->SetId(0, aVol->GetNode(0)->GetID()-1);
-            cell->GetPointIds()->SetId(1, aVol->GetNode(1)->GetID()-1);
-            cell->GetPointIds()->SetId(2, aVol->GetNode(2)->GetID()-1);
-            cell->GetPointIds()->SetId(3, aVol->GetNode(3)->GetID()-1);
-            cell->GetPointIds()->SetId(4, aVol->GetNode(4)->GetID()-1);
-            cell->GetPointIds()->SetId(5, aVol->GetNode(5)->GetID()-1);
-            cell->GetPointIds()->SetId(6, aVol->GetNode(6)->GetID()-1);
-            cell->GetPointIds()->SetId(7, aVol->GetNode(7)->GetID()-1);
-        
-            hexaArray->InsertNextCell(cell);
-        }
-        //quadratic tetrahedra
-        else if( aVol->NbNodes() == 10) {
-
-            vtkSmartPointer<vtkQuadraticTetra> tetra = vtkSmartPointer<vtkQuadraticTetra>::New();
-            for(int i=0; i<10; i++){
-                tetra->GetPointIds()->SetId(i, aVol->GetNode(i)->GetID()-1);
-            }
-
-            quadTetraArray->InsertNextCell(tetra);
-        }
-        if(aVol->NbNodes() == 20) { // not tested, no sure about vertex sequence
-            vtkSmartPointer<vtkHexahedron> cell= vtkSmartPointer<vtkHexahedron>::New();
-            for(int i=0; i<20; i++){
-                cell->GetPointIds()->SetId(i, aVol->GetNode(i)->GetID()-1);
-            }
-            hexaArray->InsertNextCell(cell);
-        }
+    // quadratic elements with 13 and 15 nodes are not added yet
+    switch (numNodes) {
+    case 4:
+        return VTK_TETRA;
+    case 5:
+        return VTK_PYRAMID;
+    case 6:
+        return VTK_WEDGE;
+    case 8:
+        return VTK_HEXAHEDRON;
+    case 10:
+        return VTK_QUADRATIC_TETRA;
+    case 20:
+        return VTK_QUADRATIC_HEXAHEDRON;
+    default:
+        return VTK_EMPTY_CELL;
     }
+}
 
-    if(tetraArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_TETRA, tetraArray);
-
-    if(pyramidArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_PYRAMID, pyramidArray);
-
-    if(wedgeArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_WEDGE, wedgeArray);
+template <class Iterator>
+void exportFemMeshElements(vtkSmartPointer<vtkUnstructuredGrid> grid, const Iterator& aElemIter,
+                           int numElems, int (*cellType)(int))
+{
+    // all cells go into one connectivity array, so no vtkCell object is created
+    // per element and meshes with mixed element types are kept completely
+    vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+    cells->Allocate(cells->EstimateSize(numElems, 10));
+    std::vector<int> types;
+    types.reserve(numElems);
+    std::vector<vtkIdType> ids;
+
+    while (aElemIter->more()) {
+        const SMDS_MeshElement* aElem = aElemIter->next();
+        int numNodes = aElem->NbNodes();
+        int type = cellType(numNodes);
+        if (type == VTK_EMPTY_CELL)
+            continue;
 
-    if(hexaArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_HEXAHEDRON, hexaArray);
-        
-    if(quadTetraArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_QUADRATIC_TETRA, quadTetraArray);
-        
-    if(quadHexaArray->GetNumberOfCells()>0)
-        grid->SetCells(VTK_QUADRATIC_HEXAHEDRON, quadHexaArray);
+        ids.resize(numNodes);
+        for (int i = 0; i < numNodes; i++)
+            ids[i] = aElem->GetNode(i)->GetID() - 1;
+        cells->InsertNextCell(numNodes, &ids[0]);
+        types.push_back(type);
+    }
 
+    if (!types.empty())
+        grid->SetCells(&types[0], cells);
 }
 
 void FemVTKTools::exportVTKMesh(const FemMesh* mesh, vtkSmartPointer<vtkUnstructuredGrid> grid)
@@ -398,13 +292,16 @@ void FemVTKTools::exportVTKMesh(const FemMesh* mesh, vtkSmartPointer<vtkUnstruct
         points->SetPoint(node->GetID()-1, coords);
     }
     grid->SetPoints(points);
-    //start with 2d elements
-    SMDS_FaceIteratorPtr aFaceIter = meshDS->facesIterator();
-    exportFemMeshFaces(grid, aFaceIter);
-    //3D volume elements
-    SMDS_VolumeIteratorPtr aVolIter = meshDS->volumesIterator();
-    exportFemMeshCells(grid, aVolIter);
 
+    // export the volume elements, only if there are none the 2d elements
+    if (info.NbVolumes() > 0) {
+        SMDS_VolumeIteratorPtr aVolIter = meshDS->volumesIterator();
+        exportFemMeshElements(grid, aVolIter, info.NbVolumes(), &vtkCellTypeOfVolume);
+    }
+    else {
+        SMDS_FaceIteratorPtr aFaceIter = meshDS->facesIterator();
+        exportFemMeshElements(grid, aFaceIter, info.NbFaces(), &vtkCellTypeOfFace);
+    }
 }
 
 void FemVTKTools::writeVTKMesh(const char* filename, const FemMesh* mesh)
@@ -755,95 +652,42 @@ void FemVTKTools::exportFluidicResult(const App::DocumentObject* res, vtkSmartPo
 }
 
 
+void exportFieldArray(vtkSmartPointer<vtkDataSet> grid, const char* name,
+                      const double* values, vtkIdType numTuples, int numComponents)
+{
+    // copy the values in one block into the preallocated array
+    vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
+    data->SetNumberOfComponents(numComponents);
+    data->SetNumberOfTuples(numTuples);
+    data->SetName(name);
+    if (numTuples > 0)
+        std::memcpy(data->GetPointer(0), values, numTuples * numComponents * sizeof(double));
+
+    grid->GetPointData()->AddArray(data);
+}
+
+void exportFieldArray(vtkSmartPointer<vtkDataSet> grid, const char* name, const std::vector<double>& vec)
+{
+    exportFieldArray(grid, name, vec.empty() ? 0 : &vec[0], static_cast<vtkIdType>(vec.size()), 1);
+}
+
 void FemVTKTools::exportMechanicalResult(const App::DocumentObject* obj, vtkSmartPointer<vtkDataSet> grid) {
     // code redundance can be avoided by property inspection, consider refactoring
     const FemResultObject* res = static_cast<const FemResultObject*>(obj);
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<double>& vec = res->StressValues.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfValues(vec.size());
-        data->SetName("Von Mises stress");
-
-        for(size_t i=0; i<vec.size(); ++i)
-            data->SetValue(i, vec[i]);
-
-        grid->GetPointData()->AddArray(data);
-    }
-
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<double>& vec = res->MaxShear.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfValues(vec.size());
-        data->SetName("Max shear stress (Tresca)");
-
-        for(size_t i=0; i<vec.size(); ++i)
-            data->SetValue(i, vec[i]);
-
-        grid->GetPointData()->AddArray(data);
-    }
-
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<double>& vec = res->PrincipalMax.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfValues(vec.size());
-        data->SetName("Maximum Principal stress");
-
-        for(size_t i=0; i<vec.size(); ++i)
-            data->SetValue(i, vec[i]);
-
-        grid->GetPointData()->AddArray(data);
-    }
-
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<double>& vec = res->PrincipalMin.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfValues(vec.size());
-        data->SetName("Minimum Principal stress");
-
-        for(size_t i=0; i<vec.size(); ++i)
-            data->SetValue(i, vec[i]);
-
-        grid->GetPointData()->AddArray(data);
-    }
-
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<double>& vec = res->Temperature.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfValues(vec.size());
-        data->SetName("Temperature");
-
-        for(size_t i=0; i<vec.size(); ++i)
-            data->SetValue(i, vec[i]);
-
-        grid->GetPointData()->AddArray(data);
-    }
-
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<double>& vec = res->UserDefined.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfValues(vec.size());
-        data->SetName("User Defined Results");
-
-        for(size_t i=0; i<vec.size(); ++i)
-            data->SetValue(i, vec[i]);
-
-        grid->GetPointData()->AddArray(data);
-    }
-
-
-    if(!res->StressValues.getValues().empty()) {
-        const std::vector<Base::Vector3d>& vec = res->DisplacementVectors.getValues();
-        vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
-        data->SetNumberOfComponents(3);
-        data->SetName("Displacement");
-
-        for(std::vector<Base::Vector3d>::const_iterator it=vec.begin(); it!=vec.end(); ++it) {
-            double tuple[] = {it->x, it->y, it->z};
-            data->InsertNextTuple(tuple);
-        }
+    if(res->StressValues.getValues().empty())
+        return;
 
-        grid->GetPointData()->AddArray(data);
-    }
+    exportFieldArray(grid, "Von Mises stress", res->StressValues.getValues());
+    exportFieldArray(grid, "Max shear stress (Tresca)", res->MaxShear.getValues());
+    exportFieldArray(grid, "Maximum Principal stress", res->PrincipalMax.getValues());
+    exportFieldArray(grid, "Minimum Principal stress", res->PrincipalMin.getValues());
+    exportFieldArray(grid, "Temperature", res->Temperature.getValues());
+    exportFieldArray(grid, "User Defined Results", res->UserDefined.getValues());
+
+    // Base::Vector3d consists of three contiguous doubles
+    static_assert(sizeof(Base::Vector3d) == 3 * sizeof(double), "Base::Vector3d must not be padded");
+    const std::vector<Base::Vector3d>& vec = res->DisplacementVectors.getValues();
+    exportFieldArray(grid, "Displacement", vec.empty() ? 0 : &vec[0].x, static_cast<vtkIdType>(vec.size()), 3);
 }
 
 } // namespace
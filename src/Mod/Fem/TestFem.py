@@ -523,6 +523,56 @@ class TherMechFemTest(unittest.TestCase):
         pass
 
 
+class FemMeshPersistenceTest(unittest.TestCase):
+
+    def setUp(self):
+        try:
+            FreeCAD.setActiveDocument("FemMeshPersistenceTest")
+        except:
+            FreeCAD.newDocument("FemMeshPersistenceTest")
+        finally:
+            FreeCAD.setActiveDocument("FemMeshPersistenceTest")
+        self.active_doc = FreeCAD.ActiveDocument
+        self.file_name = temp_dir + '/FemMeshPersistenceTest.FCStd'
+
+    def create_new_mesh(self):
+        self.mesh_object = self.active_doc.addObject('Fem::FemMeshObject', mesh_name)
+        self.mesh = Fem.FemMesh()
+        with open(mesh_points_file, 'r') as points_file:
+            reader = csv.reader(points_file)
+            for p in reader:
+                self.mesh.addNode(float(p[1]), float(p[2]), float(p[3]), int(p[0]))
+
+        with open(mesh_volumes_file, 'r') as volumes_file:
+            reader = csv.reader(volumes_file)
+            for v in reader:
+                self.mesh.addVolume([int(v[2]), int(v[1]), int(v[3]), int(v[4]), int(v[5]),
+                                    int(v[7]), int(v[6]), int(v[9]), int(v[8]), int(v[10])],
+                                    int(v[0]))
+
+        self.mesh_object.FemMesh = self.mesh
+        self.active_doc.recompute()
+
+    def test_save_restore(self):
+        fcc_print('Checking FEM mesh save and restore...')
+        self.create_new_mesh()
+        self.active_doc.saveAs(self.file_name)
+        FreeCAD.closeDocument("FemMeshPersistenceTest")
+
+        self.active_doc = FreeCAD.openDocument(self.file_name)
+        mesh = self.active_doc.getObject(mesh_name).FemMesh
+        self.assertEqual(mesh.NodeCount, self.mesh.NodeCount, "Restored mesh has a different number of nodes")
+        self.assertEqual(mesh.VolumeCount, self.mesh.VolumeCount, "Restored mesh has a different number of volumes")
+        self.assertEqual(mesh.Nodes, self.mesh.Nodes, "Restored mesh has different nodes")
+        for v in self.mesh.Volumes:
+            self.assertEqual(mesh.getElementNodes(v), self.mesh.getElementNodes(v),
+                             "Restored mesh has different nodes of volume {}".format(v))
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.active_doc.Name)
+        pass
+
+
 # helpers
 def open_cube_test():
     cube_file = test_file_dir + '/cube.fcstd'
@@ -42,6 +42,7 @@
 #include "FeatureMeshSegmentByMesh.h"
 #include "FeatureMeshSetOperations.h"
 #include "FeatureMeshDefects.h"
+#include "FeatureMeshDecimation.h"
 #include "FeatureMeshSolid.h"
 
 namespace Mesh {
@@ -92,6 +93,7 @@ PyMODINIT_FUNC initMesh()
     Mesh::FixIndices            ::init();
     Mesh::FillHoles             ::init();
     Mesh::RemoveComponents      ::init();
+    Mesh::Decimation            ::init();
 
     Mesh::Sphere                ::init();
     Mesh::Ellipsoid             ::init();
@@ -32,6 +32,8 @@
 
 #include "Builder.h"
 #include "MeshKernel.h"
+#include "MeshIO.h"
+#include "ParallelSort.h"
 
 using namespace MeshCore;
 
@@ -253,3 +255,169 @@ void MeshBuilder::Finish (bool freeMemory)
 
     _meshKernel.RecalcBoundBox();
 }
+
+// ----------------------------------------------------------------------------
+
+struct MeshFastBuilder::Private {
+    struct Vertex
+    {
+        Vertex() : x(0), y(0), z(0), i(0) {}
+        Vertex(float x, float y, float z, unsigned long i) : x(x), y(y), z(z), i(i) {}
+
+        float x, y, z;
+        unsigned long i;
+
+        bool operator!=(const Vertex& rhs) const
+        {
+            return x != rhs.x || y != rhs.y || z != rhs.z;
+        }
+        bool operator<(const Vertex& rhs) const
+        {
+            if (x != rhs.x)
+                return x < rhs.x;
+            else if (y != rhs.y)
+                return y < rhs.y;
+            else if (z != rhs.z)
+                return z < rhs.z;
+            else
+                return false;
+        }
+    };
+
+    struct Edge
+    {
+        unsigned long pt1, pt2;
+        unsigned long side; // facet index * 3 + local edge index
+
+        bool operator<(const Edge& rhs) const
+        {
+            if (pt1 != rhs.pt1)
+                return pt1 < rhs.pt1;
+            else if (pt2 != rhs.pt2)
+                return pt2 < rhs.pt2;
+            else
+                return side < rhs.side;
+        }
+        bool sameEdge(const Edge& rhs) const
+        {
+            return pt1 == rhs.pt1 && pt2 == rhs.pt2;
+        }
+    };
+
+    std::vector<Vertex> verts;
+};
+
+MeshFastBuilder::MeshFastBuilder(MeshKernel &rclM) : p(new Private), _meshKernel(rclM)
+{
+}
+
+MeshFastBuilder::~MeshFastBuilder(void)
+{
+    delete p;
+}
+
+void MeshFastBuilder::Initialize (unsigned long ctFacets)
+{
+    p->verts.reserve(ctFacets * 3);
+}
+
+void MeshFastBuilder::AddFacet (const Base::Vector3f* facetPoints)
+{
+    int i1 = 1, i2 = 2;
+    // adjust circulation direction
+    if ((((facetPoints[1] - facetPoints[0]) % (facetPoints[2] - facetPoints[0])) * facetPoints[3]) < 0.0f)
+        std::swap(i1, i2);
+
+    unsigned long index = p->verts.size();
+    p->verts.push_back(Private::Vertex(facetPoints[0].x, facetPoints[0].y, facetPoints[0].z, index));
+    p->verts.push_back(Private::Vertex(facetPoints[i1].x, facetPoints[i1].y, facetPoints[i1].z, index + 1));
+    p->verts.push_back(Private::Vertex(facetPoints[i2].x, facetPoints[i2].y, facetPoints[i2].z, index + 2));
+}
+
+void MeshFastBuilder::AddFacet (const MeshGeomFacet& facet)
+{
+    Base::Vector3f facetPoints[4] = {
+        facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], facet.GetNormal()
+    };
+    AddFacet(facetPoints);
+}
+
+void MeshFastBuilder::Finish ()
+{
+    typedef Private::Vertex Vertex;
+    typedef Private::Edge Edge;
+
+    std::vector<Vertex>& verts = p->verts;
+    std::size_t ulCtPts = verts.size();
+    std::size_t ulCtFts = ulCtPts / 3;
+
+    // weld the vertices: after sorting equal points are adjacent
+    ParallelSort<Vertex>::sort(verts);
+
+    std::vector<unsigned long> indices(ulCtPts);
+    MeshPointArray rPoints;
+    rPoints.reserve(ulCtPts / 5);
+    for (std::size_t i = 0; i < ulCtPts; i++) {
+        const Vertex& v = verts[i];
+        if (i == 0 || verts[i-1] != v)
+            rPoints.push_back(MeshPoint(Base::Vector3f(v.x, v.y, v.z)));
+        indices[v.i] = rPoints.size() - 1;
+    }
+
+    // free the memory immediately
+    std::vector<Vertex>().swap(verts);
+
+    MeshFacetArray rFacets(ulCtFts);
+    for (std::size_t i = 0; i < ulCtFts; i++) {
+        MeshFacet& f = rFacets[i];
+        f._aulPoints[0] = indices[3*i];
+        f._aulPoints[1] = indices[3*i+1];
+        f._aulPoints[2] = indices[3*i+2];
+        // degenerated facet
+        if (f._aulPoints[0] == f._aulPoints[1] ||
+            f._aulPoints[0] == f._aulPoints[2] ||
+            f._aulPoints[1] == f._aulPoints[2])
+            f.SetInvalid();
+    }
+
+    { std::vector<unsigned long>().swap(indices); }
+
+    // remove degenerated facets and points that are not referenced any more
+    MeshCleanup meshCleanup(rPoints, rFacets);
+    meshCleanup.RemoveInvalids();
+
+    // set the neighbourhood: after sorting the two sides of an edge are adjacent
+    ulCtFts = rFacets.size();
+    std::vector<Edge> edges(ulCtFts * 3);
+    for (std::size_t i = 0; i < ulCtFts; i++) {
+        for (int j = 0; j < 3; j++) {
+            unsigned long p1 = rFacets[i]._aulPoints[j];
+            unsigned long p2 = rFacets[i]._aulPoints[(j+1)%3];
+            Edge& e = edges[3*i+j];
+            e.pt1 = std::min<unsigned long>(p1, p2);
+            e.pt2 = std::max<unsigned long>(p1, p2);
+            e.side = 3*i+j;
+        }
+    }
+
+    ParallelSort<Edge>::sort(edges);
+
+    std::size_t ulCtEdges = edges.size();
+    for (std::size_t i = 0; i < ulCtEdges; ) {
+        std::size_t j = i + 1;
+        while (j < ulCtEdges && edges[i].sameEdge(edges[j]))
+            j++;
+        // an edge shared by more than two facets is non-manifold, then
+        // the facets are connected pairwise
+        for (std::size_t k = i; k + 1 < j; k += 2) {
+            unsigned long s1 = edges[k].side;
+            unsigned long s2 = edges[k+1].side;
+            rFacets[s1/3]._aulNeighbours[s1%3] = s2/3;
+            rFacets[s2/3]._aulNeighbours[s2%3] = s1/3;
+        }
+        i = j;
+    }
+
+    _meshKernel.Clear();
+    _meshKernel.Adopt(rPoints, rFacets);
+}
@@ -164,6 +164,56 @@ private:
     float _fSaveTolerance;
 };
 
+/**
+ * Class for creating the mesh structure by adding facets. In opposite to
+ * MeshBuilder the vertices are not welded on insertion but all at once in
+ * Finish(). Points are only merged if they are exactly equal, no tolerance
+ * is used. This makes it suitable for formats like STL that store each
+ * facet with its own copy of the corner points.
+ *
+ * The facets are collected in a plain array, the vertices are then welded
+ * and the facet neighbourhood is computed by sorting the corners and edges
+ * in parallel. This needs much less memory than the tree-based approach of
+ * MeshBuilder and is considerably faster for big meshes.
+ * \code
+ * MeshFastBuilder builder(someMeshReference);
+ * builder.Initialize(numberOfFacets);
+ * for (...)
+ *   builder.AddFacet(...);
+ * builder.Finish();
+ * \endcode
+ */
+class MeshExport MeshFastBuilder
+{
+public:
+    MeshFastBuilder(MeshKernel &rclM);
+    ~MeshFastBuilder(void);
+
+    /** Initializes the class. Must be done before adding facets.
+     * The mesh kernel will be cleared in Finish().
+     * @param ctFacets count of facets.
+     */
+    void Initialize (unsigned long ctFacets);
+    /** Add new facet
+     * @param facetPoints Array of vectors (size 4) in order of vec1, vec2,
+     *                    vec3, normal. If the normal is not a null vector
+     *                    the orientation of the facet is adjusted to it.
+     */
+    void AddFacet (const Base::Vector3f* facetPoints);
+    /** Add new facet
+     */
+    void AddFacet (const MeshGeomFacet& facet);
+    /** Welds the vertices, removes degenerated facets, computes the
+     * neighbourhood and passes the result to the mesh kernel.
+     */
+    void Finish ();
+
+private:
+    struct Private;
+    Private* p;
+    MeshKernel& _meshKernel;
+};
+
 } // namespace MeshCore
 
 #endif 
@@ -0,0 +1,545 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <climits>
+# include <cmath>
+# include <functional>
+# include <iterator>
+#endif
+
+#include <QFuture>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include <Base/Tools.h>
+
+#include "Decimation.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+
+MeshDecimation::Quadric::Quadric()
+{
+    for (int i=0; i<10; i++)
+        m[i] = 0.0;
+}
+
+void MeshDecimation::Quadric::AddPlane(const Base::Vector3d& n, double d, double w)
+{
+    m[0] += w*n.x*n.x; m[1] += w*n.x*n.y; m[2] += w*n.x*n.z; m[3] += w*n.x*d;
+                       m[4] += w*n.y*n.y; m[5] += w*n.y*n.z; m[6] += w*n.y*d;
+                                          m[7] += w*n.z*n.z; m[8] += w*n.z*d;
+                                                             m[9] += w*d*d;
+}
+
+MeshDecimation::Quadric& MeshDecimation::Quadric::operator += (const Quadric& q)
+{
+    for (int i=0; i<10; i++)
+        m[i] += q.m[i];
+    return *this;
+}
+
+double MeshDecimation::Quadric::Error(const Base::Vector3d& v) const
+{
+    double e = m[0]*v.x*v.x + 2.0*m[1]*v.x*v.y + 2.0*m[2]*v.x*v.z + 2.0*m[3]*v.x
+             + m[4]*v.y*v.y + 2.0*m[5]*v.y*v.z + 2.0*m[6]*v.y
+             + m[7]*v.z*v.z + 2.0*m[8]*v.z
+             + m[9];
+    // rounding errors may give slightly negative values
+    return std::max<double>(e, 0.0);
+}
+
+// ----------------------------------------------------------------------------
+
+MeshDecimation::MeshDecimation(MeshKernel& mesh)
+  : kernel(mesh)
+  , targetSize(0)
+  , tolerance(0.0f)
+  , featureAngle(0.0f)
+  , boundaryWeight(1000.0)
+  , collapses(0)
+  , maxError(0.0f)
+  , elapsedTime(0)
+  , countFacets(0)
+{
+}
+
+MeshDecimation::~MeshDecimation()
+{
+}
+
+void MeshDecimation::Initialize()
+{
+    const MeshPointArray& rPoints = kernel.GetPoints();
+    const MeshFacetArray& rFacets = kernel.GetFacets();
+    unsigned long numPoints = rPoints.size();
+    unsigned long numFacets = rFacets.size();
+
+    points.resize(numPoints);
+    for (unsigned long i=0; i<numPoints; i++)
+        points[i] = Base::convertTo<Base::Vector3d>(static_cast<const Base::Vector3f&>(rPoints[i]));
+
+    vertices.resize(numPoints);
+    faces.resize(numFacets);
+    normals.resize(numFacets);
+    for (unsigned long i=0; i<numPoints; i++) {
+        vertices[i].start = 0;
+        vertices[i].count = 0;
+        vertices[i].stamp = 0;
+        vertices[i].border = false;
+    }
+
+    for (unsigned long i=0; i<numFacets; i++) {
+        const MeshFacet& f = rFacets[i];
+        Face& face = faces[i];
+        face.removed = false;
+        for (int j=0; j<3; j++) {
+            face.p[j] = f._aulPoints[j];
+            vertices[face.p[j]].count++;
+            if (f._aulNeighbours[j] == ULONG_MAX) {
+                vertices[f._aulPoints[j]].border = true;
+                vertices[f._aulPoints[(j+1)%3]].border = true;
+            }
+        }
+
+        Base::Vector3d n = (points[face.p[1]] - points[face.p[0]]) %
+                           (points[face.p[2]] - points[face.p[0]]);
+        double len = n.Length();
+        normals[i] = len > 0.0 ? n / len : Base::Vector3d();
+    }
+
+    // the facets of point i are refs[start] ... refs[start+count-1]
+    unsigned long offset = 0;
+    for (unsigned long i=0; i<numPoints; i++) {
+        vertices[i].start = offset;
+        offset += vertices[i].count;
+        vertices[i].count = 0;
+    }
+    refs.resize(offset);
+    for (unsigned long i=0; i<numFacets; i++) {
+        for (int j=0; j<3; j++) {
+            Vertex& v = vertices[faces[i].p[j]];
+            refs[v.start + v.count++] = i;
+        }
+    }
+    countFacets = numFacets;
+
+    // split into chunks for the thread pool
+    std::vector<Range> ranges;
+    const unsigned long chunk = 16384;
+    for (unsigned long i=0; i<numPoints; i += chunk) {
+        Range r;
+        r.begin = i;
+        r.end = std::min<unsigned long>(i + chunk, numPoints);
+        ranges.push_back(r);
+    }
+
+    // the candidates need the quadrics of the neighbours, so the two
+    // passes must not be merged
+    QFuture<void> future = QtConcurrent::map
+        (ranges, boost::bind(&MeshDecimation::ComputeQuadrics, this, _1));
+    future.waitForFinished();
+    future = QtConcurrent::map
+        (ranges, boost::bind(&MeshDecimation::ComputeCandidates, this, _1));
+    future.waitForFinished();
+
+    heap.clear();
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it)
+        heap.insert(heap.end(), it->candidates.begin(), it->candidates.end());
+    std::make_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+    std::vector<Base::Vector3d>().swap(normals);
+}
+
+void MeshDecimation::ComputeQuadrics(const Range& range)
+{
+    const MeshFacetArray& rFacets = kernel.GetFacets();
+    double cosAngle = featureAngle > 0.0f ? std::cos(featureAngle) : -2.0;
+
+    for (unsigned long i = range.begin; i < range.end; i++) {
+        Vertex& v = vertices[i];
+        for (unsigned long k = v.start; k < v.start + v.count; k++) {
+            unsigned long index = refs[k];
+            const Face& f = faces[index];
+            const Base::Vector3d& n = normals[index];
+            v.q.AddPlane(n, -(n * points[f.p[0]]), 1.0);
+
+            // add a plane perpendicular to the facet through border and
+            // sharp edges
+            for (int j=0; j<3; j++) {
+                if (f.p[j] != i && f.p[(j+1)%3] != i)
+                    continue;
+                unsigned long neighbour = rFacets[index]._aulNeighbours[j];
+                if (neighbour != ULONG_MAX && normals[neighbour] * n >= cosAngle)
+                    continue;
+                const Base::Vector3d& p0 = points[f.p[j]];
+                Base::Vector3d e = points[f.p[(j+1)%3]] - p0;
+                Base::Vector3d c = e % n;
+                double len = c.Length();
+                if (len > 0.0) {
+                    c /= len;
+                    v.q.AddPlane(c, -(c * p0), boundaryWeight);
+                }
+            }
+        }
+    }
+}
+
+void MeshDecimation::ComputeCandidates(Range& range) const
+{
+    for (unsigned long i = range.begin; i < range.end; i++)
+        CollectCandidates(i, false, range.candidates);
+}
+
+void MeshDecimation::Neighbours(unsigned long index, std::vector<unsigned long>& nb) const
+{
+    nb.clear();
+    const Vertex& v = vertices[index];
+    for (unsigned long k = v.start; k < v.start + v.count; k++) {
+        const Face& f = faces[refs[k]];
+        if (f.removed)
+            continue;
+        for (int j=0; j<3; j++) {
+            if (f.p[j] != index)
+                nb.push_back(f.p[j]);
+        }
+    }
+    std::sort(nb.begin(), nb.end());
+    nb.erase(std::unique(nb.begin(), nb.end()), nb.end());
+}
+
+void MeshDecimation::CollectCandidates(unsigned long index, bool all,
+                                       std::vector<Candidate>& candidates) const
+{
+    std::vector<unsigned long> nb;
+    Neighbours(index, nb);
+    for (std::vector<unsigned long>::iterator it = nb.begin(); it != nb.end(); ++it) {
+        // at initialization each edge is added once
+        if (!all && *it < index)
+            continue;
+        Candidate c;
+        Base::Vector3d pos;
+        c.cost = Optimize(index, *it, pos);
+        c.p0 = index;
+        c.p1 = *it;
+        c.s0 = vertices[index].stamp;
+        c.s1 = vertices[*it].stamp;
+        candidates.push_back(c);
+    }
+}
+
+double MeshDecimation::Optimize(unsigned long i0, unsigned long i1, Base::Vector3d& pos) const
+{
+    const Vertex& v0 = vertices[i0];
+    const Vertex& v1 = vertices[i1];
+    const Base::Vector3d& p0 = points[i0];
+    const Base::Vector3d& p1 = points[i1];
+
+    // keep the outline of open meshes
+    if (v0.border != v1.border) {
+        pos = v0.border ? p0 : p1;
+        Quadric q = v0.q;
+        q += v1.q;
+        return q.Error(pos);
+    }
+
+    Quadric q = v0.q;
+    q += v1.q;
+    const double* m = q.m;
+
+    // minimize the error by solving A*x = -b with Cramer's rule
+    double c0 = m[4]*m[7] - m[5]*m[5];
+    double c1 = m[2]*m[5] - m[1]*m[7];
+    double c2 = m[1]*m[5] - m[2]*m[4];
+    double det = m[0]*c0 + m[1]*c1 + m[2]*c2;
+    double trace = m[0] + m[4] + m[7];
+    if (std::fabs(det) > 1.0e-10 * trace * trace * trace) {
+        // the inverse of the symmetric 3x3 matrix
+        double i00 = c0;
+        double i01 = c1;
+        double i02 = c2;
+        double i11 = m[0]*m[7] - m[2]*m[2];
+        double i12 = m[1]*m[2] - m[0]*m[5];
+        double i22 = m[0]*m[4] - m[1]*m[1];
+        Base::Vector3d x(-(i00*m[3] + i01*m[6] + i02*m[8]) / det,
+                         -(i01*m[3] + i11*m[6] + i12*m[8]) / det,
+                         -(i02*m[3] + i12*m[6] + i22*m[8]) / det);
+        // an ill-conditioned system may give a point far away from the edge
+        Base::Vector3d mid = (p0 + p1) * 0.5;
+        if (Base::DistanceP2(x, mid) <= Base::DistanceP2(p0, p1)) {
+            pos = x;
+            return q.Error(pos);
+        }
+    }
+
+    // take the best of the end points and the middle point
+    Base::Vector3d cand[3] = { p0, p1, (p0 + p1) * 0.5 };
+    double cost = DBL_MAX;
+    for (int i=0; i<3; i++) {
+        double err = q.Error(cand[i]);
+        if (err < cost) {
+            cost = err;
+            pos = cand[i];
+        }
+    }
+    return cost;
+}
+
+unsigned long MeshDecimation::CountCommonFacets(unsigned long i0, unsigned long i1) const
+{
+    unsigned long count = 0;
+    const Vertex& v = vertices[i0];
+    for (unsigned long k = v.start; k < v.start + v.count; k++) {
+        const Face& f = faces[refs[k]];
+        if (!f.removed && (f.p[0] == i1 || f.p[1] == i1 || f.p[2] == i1))
+            count++;
+    }
+    return count;
+}
+
+bool MeshDecimation::IsCollapseLegal(unsigned long i0, unsigned long i1, const Base::Vector3d& pos) const
+{
+    // a non-manifold edge or an edge that connects two borders
+    unsigned long common = CountCommonFacets(i0, i1);
+    if (common == 0 || common > 2)
+        return false;
+    if (common == 2 && vertices[i0].border && vertices[i1].border)
+        return false;
+
+    // link condition: the end points may only share the points opposite
+    // to the edge, otherwise the collapse creates a non-manifold
+    std::vector<unsigned long> nb0, nb1, shared;
+    Neighbours(i0, nb0);
+    Neighbours(i1, nb1);
+    std::set_intersection(nb0.begin(), nb0.end(), nb1.begin(), nb1.end(),
+                          std::back_inserter(shared));
+    if (shared.size() != common)
+        return false;
+    // the opposite points must not span a facet with either end point,
+    // as for a tetrahedron
+    if (common == 2) {
+        const Vertex& v = vertices[i0];
+        for (unsigned long k = v.start; k < v.start + v.count; k++) {
+            const Face& f = faces[refs[k]];
+            if (f.removed)
+                continue;
+            int cnt = 0;
+            for (int j=0; j<3; j++) {
+                if (f.p[j] == shared[0] || f.p[j] == shared[1])
+                    cnt++;
+            }
+            if (cnt == 2)
+                return false;
+        }
+    }
+
+    // the remaining facets must not flip or degenerate
+    unsigned long ends[2] = { i0, i1 };
+    for (int e=0; e<2; e++) {
+        const Vertex& v = vertices[ends[e]];
+        unsigned long other = ends[1-e];
+        for (unsigned long k = v.start; k < v.start + v.count; k++) {
+            const Face& f = faces[refs[k]];
+            if (f.removed || f.p[0] == other || f.p[1] == other || f.p[2] == other)
+                continue;
+            Base::Vector3d p[3], q[3];
+            for (int j=0; j<3; j++) {
+                p[j] = points[f.p[j]];
+                q[j] = f.p[j] == ends[e] ? pos : p[j];
+            }
+            Base::Vector3d n0 = (p[1] - p[0]) % (p[2] - p[0]);
+            Base::Vector3d n1 = (q[1] - q[0]) % (q[2] - q[0]);
+            double l0 = n0.Length();
+            double l1 = n1.Length();
+            if (l1 <= 0.0 || (l0 > 0.0 && n0 * n1 < 0.2 * l0 * l1))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void MeshDecimation::Collapse(unsigned long i0, unsigned long i1, const Base::Vector3d& pos)
+{
+    points[i0] = pos;
+    vertices[i0].q += vertices[i1].q;
+    vertices[i0].border = vertices[i0].border || vertices[i1].border;
+
+    // the facets of both points are appended to the references, the old
+    // entries are removed by CompactRefs()
+    unsigned long start = refs.size();
+    unsigned long ends[2] = { i0, i1 };
+    for (int e=0; e<2; e++) {
+        unsigned long beg = vertices[ends[e]].start;
+        unsigned long end = beg + vertices[ends[e]].count;
+        for (unsigned long k = beg; k < end; k++) {
+            unsigned long index = refs[k];
+            Face& f = faces[index];
+            if (f.removed)
+                continue;
+            bool has0 = false, has1 = false;
+            for (int j=0; j<3; j++) {
+                if (f.p[j] == i0)
+                    has0 = true;
+                else if (f.p[j] == i1)
+                    has1 = true;
+            }
+            if (has0 && has1) {
+                f.removed = true;
+                countFacets--;
+                continue;
+            }
+            for (int j=0; j<3; j++) {
+                if (f.p[j] == i1)
+                    f.p[j] = i0;
+            }
+            refs.push_back(index);
+        }
+    }
+
+    vertices[i0].start = start;
+    vertices[i0].count = refs.size() - start;
+    vertices[i0].stamp++;
+    vertices[i1].count = 0;
+    vertices[i1].stamp++;
+}
+
+void MeshDecimation::CompactRefs()
+{
+    for (std::vector<Vertex>::iterator it = vertices.begin(); it != vertices.end(); ++it)
+        it->count = 0;
+    for (std::vector<Face>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        if (!it->removed) {
+            for (int j=0; j<3; j++)
+                vertices[it->p[j]].count++;
+        }
+    }
+
+    unsigned long offset = 0;
+    for (std::vector<Vertex>::iterator it = vertices.begin(); it != vertices.end(); ++it) {
+        it->start = offset;
+        offset += it->count;
+        it->count = 0;
+    }
+
+    refs.resize(offset);
+    for (unsigned long i=0; i<faces.size(); i++) {
+        const Face& f = faces[i];
+        if (!f.removed) {
+            for (int j=0; j<3; j++) {
+                Vertex& v = vertices[f.p[j]];
+                refs[v.start + v.count++] = i;
+            }
+        }
+    }
+}
+
+void MeshDecimation::Store()
+{
+    std::vector<unsigned long> index(points.size(), ULONG_MAX);
+    MeshPointArray rPoints;
+    MeshFacetArray rFacets;
+    rFacets.reserve(countFacets);
+
+    for (std::vector<Face>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        if (it->removed)
+            continue;
+        for (int j=0; j<3; j++) {
+            unsigned long p = it->p[j];
+            if (index[p] == ULONG_MAX) {
+                index[p] = rPoints.size();
+                rPoints.push_back(MeshPoint(Base::convertTo<Base::Vector3f>(points[p])));
+            }
+        }
+        rFacets.push_back(MeshFacet(index[it->p[0]], index[it->p[1]], index[it->p[2]]));
+    }
+
+    kernel.Adopt(rPoints, rFacets, true);
+
+    std::vector<Base::Vector3d>().swap(points);
+    std::vector<Vertex>().swap(vertices);
+    std::vector<Face>().swap(faces);
+    std::vector<unsigned long>().swap(refs);
+    std::vector<Candidate>().swap(heap);
+}
+
+void MeshDecimation::Simplify()
+{
+    collapses = 0;
+    maxError = 0.0f;
+    elapsedTime = 0;
+    if (kernel.CountFacets() == 0 || (targetSize == 0 && tolerance <= 0.0f))
+        return;
+
+    Base::StopWatch watch;
+    watch.start();
+    Initialize();
+
+    double maxCost = double(tolerance) * double(tolerance);
+    double largest = 0.0;
+    unsigned long limit = 2 * refs.size();
+    std::vector<Candidate> candidates;
+    while (!heap.empty() && countFacets > targetSize) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+        Candidate c = heap.back();
+        heap.pop_back();
+
+        // one of the points has changed since the candidate was added
+        const Vertex& v0 = vertices[c.p0];
+        const Vertex& v1 = vertices[c.p1];
+        if (v0.stamp != c.s0 || v1.stamp != c.s1 || v0.count == 0 || v1.count == 0)
+            continue;
+        if (tolerance > 0.0f && c.cost > maxCost)
+            break;
+
+        Base::Vector3d pos;
+        Optimize(c.p0, c.p1, pos);
+        if (!IsCollapseLegal(c.p0, c.p1, pos))
+            continue;
+
+        Collapse(c.p0, c.p1, pos);
+        collapses++;
+        largest = std::max<double>(largest, c.cost);
+
+        if (refs.size() > limit) {
+            CompactRefs();
+            limit = 2 * refs.size();
+        }
+
+        candidates.clear();
+        CollectCandidates(c.p0, true, candidates);
+        for (std::vector<Candidate>::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+            heap.push_back(*it);
+            std::push_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+        }
+    }
+
+    Store();
+    maxError = static_cast<float>(std::sqrt(largest));
+    elapsedTime = watch.elapsed();
+}
@@ -0,0 +1,155 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESHCORE_DECIMATION_H
+#define MESHCORE_DECIMATION_H
+
+#include <vector>
+#include <Base/Vector3D.h>
+
+namespace MeshCore
+{
+class MeshKernel;
+
+/**
+ * The MeshDecimation class reduces the number of facets of a mesh by a
+ * sequence of edge collapses ordered by quadric error metrics.
+ *
+ * Every point gets the sum of the squared distances to the planes of its
+ * adjacent facets as error quadric. The edge with the smallest error is
+ * collapsed into the point that minimizes the sum of the quadrics of both
+ * end points, and the edges around the new point are put back onto the heap.
+ * Collapses that flip facets or make the mesh non-manifold are skipped.
+ *
+ * Border edges, and optionally sharp edges, add planes perpendicular to their
+ * facets to the quadrics of their end points so that they keep their shape.
+ * The initial quadrics and edge costs are computed in parallel.
+ */
+class MeshExport MeshDecimation
+{
+public:
+    MeshDecimation(MeshKernel&);
+    ~MeshDecimation();
+
+    /** Stops when the mesh has \a count facets left. The default is 0. */
+    void SetTargetSize(unsigned long count)
+    { targetSize = count; }
+    /** Stops when the error of the next collapse exceeds \a tol. The error is
+     * the root of the sum of the squared distances of the new point to the
+     * original planes around it. The default is 0 which means no limit.
+     */
+    void SetTolerance(float tol)
+    { tolerance = tol; }
+    /** Edges whose adjacent facets enclose an angle of more than \a angle
+     * (in radian) are preserved like border edges. The default is 0 which
+     * disables the detection of sharp edges.
+     */
+    void SetFeatureAngle(float angle)
+    { featureAngle = angle; }
+    /** Weight of the planes added for border and sharp edges. The default
+     * is 1000.
+     */
+    void SetBoundaryWeight(double weight)
+    { boundaryWeight = weight; }
+
+    /** Simplifies the mesh. */
+    void Simplify();
+
+    /// Number of performed collapses of the last call of Simplify()
+    unsigned long CountCollapses() const { return collapses; }
+    /// Largest error of a performed collapse
+    float GetMaxError() const { return maxError; }
+    /// Elapsed time in milliseconds of the last call of Simplify()
+    int GetElapsedTime() const { return elapsedTime; }
+
+private:
+    /** Symmetric 4x4 matrix stored as upper triangle. */
+    struct Quadric
+    {
+        double m[10];
+        Quadric();
+        void AddPlane(const Base::Vector3d& n, double d, double w);
+        Quadric& operator += (const Quadric&);
+        double Error(const Base::Vector3d&) const;
+    };
+    struct Face
+    {
+        unsigned long p[3];
+        bool removed;
+    };
+    struct Vertex
+    {
+        Quadric q;
+        unsigned long start, count; // facets are refs[start] ... refs[start+count-1]
+        unsigned int stamp;         // changes whenever the point is modified
+        bool border;
+    };
+    struct Candidate
+    {
+        double cost;
+        unsigned long p0, p1;
+        unsigned int s0, s1;
+        bool operator > (const Candidate& c) const
+        { return cost > c.cost; }
+    };
+    struct Range
+    {
+        unsigned long begin, end;
+        std::vector<Candidate> candidates;
+    };
+
+    void Initialize();
+    void ComputeQuadrics(const Range&);
+    void ComputeCandidates(Range&) const;
+    void CollectCandidates(unsigned long, bool, std::vector<Candidate>&) const;
+    void Neighbours(unsigned long, std::vector<unsigned long>&) const;
+    double Optimize(unsigned long, unsigned long, Base::Vector3d&) const;
+    unsigned long CountCommonFacets(unsigned long, unsigned long) const;
+    bool IsCollapseLegal(unsigned long, unsigned long, const Base::Vector3d&) const;
+    void Collapse(unsigned long, unsigned long, const Base::Vector3d&);
+    void CompactRefs();
+    void Store();
+
+private:
+    MeshKernel& kernel;
+    unsigned long targetSize;
+    float tolerance;
+    float featureAngle;
+    double boundaryWeight;
+
+    unsigned long collapses;
+    float maxError;
+    int elapsedTime;
+
+    unsigned long countFacets;
+    std::vector<Base::Vector3d> points;
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    std::vector<unsigned long> refs;
+    std::vector<Base::Vector3d> normals;
+    std::vector<Candidate> heap;
+};
+
+} // namespace MeshCore
+
+#endif // MESHCORE_DECIMATION_H
@@ -211,18 +211,27 @@ bool MeshFixDuplicatePoints::Fixup()
     }
 
     // now set all facets to the correct index
+    std::vector<unsigned long> changedFacets;
     MeshFacetArray& rFacets = _rclMesh._aclFacetArray;
     for (MeshFacetArray::_TIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
+        bool changed = false;
         for (int i=0; i<3; i++) {
             std::map<unsigned long, unsigned long>::iterator pt = mapPointIndex.find(it->_aulPoints[i]);
-            if (pt != mapPointIndex.end())
+            if (pt != mapPointIndex.end()) {
                 it->_aulPoints[i] = pt->second;
+                changed = true;
+            }
         }
+        if (changed)
+            changedFacets.push_back(it - rFacets.begin());
     }
 
     // remove invalid indices
+    // Note: no facet references a removed point any more, thus the facet
+    // indices are kept and only the neighbourhood around the changed
+    // facets needs to be repaired
     _rclMesh.DeletePoints(pointIndices);
-    _rclMesh.RebuildNeighbours();
+    _rclMesh.RebuildNeighbours(changedFacets);
     
     return true;
 }
@@ -28,6 +28,7 @@
 #include <vector>
 #include <climits>
 #include <cstring>
+#include <stdint.h>
 
 #include "Definitions.h"
 
@@ -67,6 +68,48 @@ public:
   unsigned short _ausCorner[2];  // corner point indices of the facet
 };
 
+#ifdef MESH_COMPACT_INDEX
+/**
+ * Index type used for the point and neighbour indices of MeshFacet if the
+ * mesh module is built with the MESH_COMPACT_INDEX option. The index is stored
+ * with 32 bits which reduces the size of a facet from 64 to 40 bytes on 64-bit
+ * platforms. It converts implicitly from and to unsigned long so that code
+ * using the indices doesn't need to be changed. The special value ULONG_MAX
+ * that marks a missing neighbour or an invalid index is preserved.
+ * The number of points and facets is limited to 2^32-1 then.
+ */
+class MeshCompactIndex
+{
+public:
+  MeshCompactIndex (void) : _index(0xffffffff) { }
+  MeshCompactIndex (unsigned long ulIndex)
+    : _index(ulIndex == ULONG_MAX ? 0xffffffff : static_cast<uint32_t>(ulIndex)) { }
+
+  operator unsigned long () const
+  { return _index == 0xffffffff ? ULONG_MAX : _index; }
+
+  MeshCompactIndex& operator += (unsigned long ulVal)
+  { *this = MeshCompactIndex(static_cast<unsigned long>(*this) + ulVal); return *this; }
+  MeshCompactIndex& operator -= (unsigned long ulVal)
+  { *this = MeshCompactIndex(static_cast<unsigned long>(*this) - ulVal); return *this; }
+  MeshCompactIndex& operator ++ ()
+  { return *this += 1; }
+  MeshCompactIndex& operator -- ()
+  { return *this -= 1; }
+  MeshCompactIndex operator ++ (int)
+  { MeshCompactIndex tmp(*this); *this += 1; return tmp; }
+  MeshCompactIndex operator -- (int)
+  { MeshCompactIndex tmp(*this); *this -= 1; return tmp; }
+
+private:
+  uint32_t _index;
+};
+
+typedef MeshCompactIndex MeshElementIndex;
+#else
+typedef unsigned long MeshElementIndex;
+#endif
+
 /** MeshEdge just a pair of two point indices */
 typedef std::pair<unsigned long, unsigned long> MeshEdge;
 
@@ -293,8 +336,8 @@ public:
 public:
   unsigned char _ucFlag; /**< Flag member. */
   unsigned long _ulProp; /**< Free usable property. */
-  unsigned long _aulPoints[3];     /**< Indices of corner points. */
-  unsigned long _aulNeighbours[3]; /**< Indices of neighbour facets. */
+  MeshElementIndex _aulPoints[3];     /**< Indices of corner points. */
+  MeshElementIndex _aulNeighbours[3]; /**< Indices of neighbour facets. */
 };
 
 /**
@@ -800,8 +843,8 @@ inline MeshFacet::MeshFacet (void)
 : _ucFlag(0),
   _ulProp(0)
 {
-    memset(_aulNeighbours, 0xff, sizeof(ULONG_MAX) * 3);
-    memset(_aulPoints, 0xff, sizeof(ULONG_MAX) * 3);
+    _aulNeighbours[0] = _aulNeighbours[1] = _aulNeighbours[2] = ULONG_MAX;
+    _aulPoints[0] = _aulPoints[1] = _aulPoints[2] = ULONG_MAX;
 }
 
 inline MeshFacet::MeshFacet(const MeshFacet &rclF)
@@ -39,6 +39,7 @@
 #include "Helpers.h"
 #include "Grid.h"
 #include "TopoAlgorithm.h"
+#include "ParallelSort.h"
 #include <Base/Matrix.h>
 
 #include <Base/Sequencer.h>
@@ -328,6 +329,80 @@ struct Edge_Less  : public std::binary_function<const Edge_Index&,
     }
 };
 
+typedef std::vector<Edge_Index>::const_iterator Edge_Iterator;
+typedef std::pair<Edge_Iterator, Edge_Iterator> Edge_Range;
+
+/**
+ * Sets the neighbourhood for the sorted edges of the given range. The range
+ * must not split a group of equal edges.
+ */
+static void SetRangeNeighbours(MeshFacetArray& rFacets, const Edge_Range& range)
+{
+    Edge_Iterator pE = range.first;
+    while (pE != range.second) {
+        Edge_Iterator pN = pE + 1;
+        while (pN != range.second && pN->p0 == pE->p0 && pN->p1 == pE->p1)
+            ++pN;
+
+        // we handle only the cases for 1 and 2, for all higher
+        // values we have a non-manifold that is ignorned here
+        std::ptrdiff_t count = pN - pE;
+        if (count == 2) {
+            unsigned long f0 = pE->f;
+            unsigned long f1 = (pE+1)->f;
+            MeshFacet& rFace0 = rFacets[f0];
+            MeshFacet& rFace1 = rFacets[f1];
+            unsigned short side0 = rFace0.Side(pE->p0,pE->p1);
+            unsigned short side1 = rFace1.Side(pE->p0,pE->p1);
+            rFace0._aulNeighbours[side0] = f1;
+            rFace1._aulNeighbours[side1] = f0;
+        }
+        else if (count == 1) {
+            MeshFacet& rFace = rFacets[pE->f];
+            unsigned short side = rFace.Side(pE->p0,pE->p1);
+            rFace._aulNeighbours[side] = ULONG_MAX;
+        }
+
+        pE = pN;
+    }
+}
+
+/**
+ * Sorts the edges and sets the neighbourhood of the referenced facets.
+ * Each group of equal edges only modifies its own facet sides, hence the
+ * sorted array can be split into independent ranges that are handled in
+ * parallel. The result doesn't depend on the number of threads.
+ */
+static void SetEdgeNeighbours(MeshFacetArray& rFacets, std::vector<Edge_Index>& edges)
+{
+    ParallelSort<Edge_Index, Edge_Less>::sort(edges);
+
+    std::size_t numChunks = std::min<std::size_t>(edges.size() / 65536,
+        static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1)));
+    std::vector<Edge_Range> ranges;
+    Edge_Iterator first = edges.begin();
+    for (std::size_t i = 1; i < numChunks; i++) {
+        Edge_Iterator last = edges.begin() + i * (edges.size() / numChunks);
+        if (last <= first)
+            continue;
+        // move the border to the beginning of the next group
+        while (last != edges.end() && last->p0 == (last-1)->p0 && last->p1 == (last-1)->p1)
+            ++last;
+        ranges.push_back(Edge_Range(first, last));
+        first = last;
+    }
+    ranges.push_back(Edge_Range(first, Edge_Iterator(edges.end())));
+
+    if (ranges.size() == 1) {
+        SetRangeNeighbours(rFacets, ranges.front());
+    }
+    else {
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&SetRangeNeighbours, boost::ref(rFacets), _1));
+        future.waitForFinished();
+    }
+}
+
 }
 
 bool MeshEvalTopology::Evaluate ()
@@ -965,57 +1040,46 @@ void MeshKernel::RebuildNeighbours (unsigned long index)
         }
     }
 
-    // sort the edges
-    std::sort(edges.begin(), edges.end(), Edge_Less());
+    SetEdgeNeighbours(this->_aclFacetArray, edges);
+}
 
-    unsigned long p0 = ULONG_MAX, p1 = ULONG_MAX;
-    unsigned long f0 = ULONG_MAX, f1 = ULONG_MAX;
-    int count = 0;
-    std::vector<Edge_Index>::iterator pE;
-    for (pE = edges.begin(); pE != edges.end(); ++pE) {
-        if (p0 == pE->p0 && p1 == pE->p1) {
-            f1 = pE->f;
-            count++;
-        }
-        else {
-            // we handle only the cases for 1 and 2, for all higher
-            // values we have a non-manifold that is ignorned here
-            if (count == 2) {
-                MeshFacet& rFace0 = this->_aclFacetArray[f0];
-                MeshFacet& rFace1 = this->_aclFacetArray[f1];
-                unsigned short side0 = rFace0.Side(p0,p1);
-                unsigned short side1 = rFace1.Side(p0,p1);
-                rFace0._aulNeighbours[side0] = f1;
-                rFace1._aulNeighbours[side1] = f0;
-            }
-            else if (count == 1) {
-                MeshFacet& rFace = this->_aclFacetArray[f0];
-                unsigned short side = rFace.Side(p0,p1);
-                rFace._aulNeighbours[side] = ULONG_MAX;
+void MeshKernel::RebuildNeighbours (const std::vector<unsigned long>& facets)
+{
+    // mark the points of the modified facets
+    std::size_t numPoints = this->_aclPointArray.size();
+    std::size_t numFacets = this->_aclFacetArray.size();
+    std::vector<bool> marked(numPoints, false);
+    for (std::vector<unsigned long>::const_iterator it = facets.begin(); it != facets.end(); ++it) {
+        if (*it < numFacets) {
+            const MeshFacet& rFace = this->_aclFacetArray[*it];
+            for (int i = 0; i < 3; i++) {
+                if (rFace._aulPoints[i] < numPoints)
+                    marked[rFace._aulPoints[i]] = true;
             }
-
-            p0 = pE->p0;
-            p1 = pE->p1;
-            f0 = pE->f;
-            count = 1;
         }
     }
 
-    // we handle only the cases for 1 and 2, for all higher
-    // values we have a non-manifold that is ignorned here
-    if (count == 2) {
-        MeshFacet& rFace0 = this->_aclFacetArray[f0];
-        MeshFacet& rFace1 = this->_aclFacetArray[f1];
-        unsigned short side0 = rFace0.Side(p0,p1);
-        unsigned short side1 = rFace1.Side(p0,p1);
-        rFace0._aulNeighbours[side0] = f1;
-        rFace1._aulNeighbours[side1] = f0;
-    }
-    else if (count == 1) {
-        MeshFacet& rFace = this->_aclFacetArray[f0];
-        unsigned short side = rFace.Side(p0,p1);
-        rFace._aulNeighbours[side] = ULONG_MAX;
+    // Every edge of a modified facet has two marked end points. So, only
+    // the edges with two marked end points must be checked but for them all
+    // facets sharing them must be taken into account.
+    std::vector<Edge_Index> edges;
+    MeshFacetArray::_TConstIterator pI;
+    MeshFacetArray::_TConstIterator pB = this->_aclFacetArray.begin();
+    for (pI = pB; pI != this->_aclFacetArray.end(); ++pI) {
+        for (int i = 0; i < 3; i++) {
+            unsigned long p0 = pI->_aulPoints[i];
+            unsigned long p1 = pI->_aulPoints[(i+1)%3];
+            if (p0 < numPoints && p1 < numPoints && marked[p0] && marked[p1]) {
+                Edge_Index item;
+                item.p0 = std::min<unsigned long>(p0, p1);
+                item.p1 = std::max<unsigned long>(p0, p1);
+                item.f  = pI - pB;
+                edges.push_back(item);
+            }
+        }
     }
+
+    SetEdgeNeighbours(this->_aclFacetArray, edges);
 }
 
 void MeshKernel::RebuildNeighbours (void)
@@ -43,6 +43,7 @@
 #include <zipios++/gzipoutputstream.h>
 
 #include <cmath>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
@@ -836,6 +837,27 @@ bool MeshInput::LoadPLY (std::istream &inp)
     if (rgb_colors != 0 && rgb_colors != 3)
         return false;
 
+    // look up the slots of the used properties once instead of per vertex
+    std::size_t index_x = 0, index_y = 0, index_z = 0;
+    std::size_t index_r = 0, index_g = 0, index_b = 0;
+    for (std::size_t i = 0; i < vertex_props.size(); i++) {
+        const std::string& name = vertex_props[i].first;
+        if (name == "x")
+            index_x = i;
+        else if (name == "y")
+            index_y = i;
+        else if (name == "z")
+            index_z = i;
+        else if (name == "red")
+            index_r = i;
+        else if (name == "green")
+            index_g = i;
+        else if (name == "blue")
+            index_b = i;
+    }
+
+    std::vector<float> prop_values(vertex_props.size());
+
     // only if set per vertex
     if (rgb_colors == 3) {
         rgb_value = MeshIO::PER_VERTEX;
@@ -854,7 +876,6 @@ bool MeshInput::LoadPLY (std::istream &inp)
 
         for (std::size_t i = 0; i < v_count && std::getline(inp, line); i++) {
             // go through the vertex properties
-            std::map<std::string, float> prop_values;
             for (std::vector<std::pair<std::string, Number> >::iterator it = vertex_props.begin(); it != vertex_props.end(); ++it) {
                 switch (it->second) {
                 case int8:
@@ -864,7 +885,7 @@ bool MeshInput::LoadPLY (std::istream &inp)
                         if (boost::regex_search(line, what, rx_s)) {
                             int v;
                             v = boost::lexical_cast<int>(what[1]);
-                            prop_values[it->first] = static_cast<float>(v);
+                            prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                             line = line.substr(what[0].length());
                         }
                         else {
@@ -878,7 +899,7 @@ bool MeshInput::LoadPLY (std::istream &inp)
                         if (boost::regex_search(line, what, rx_u)) {
                             int v;
                             v = boost::lexical_cast<int>(what[1]);
-                            prop_values[it->first] = static_cast<float>(v);
+                            prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                             line = line.substr(what[0].length());
                         }
                         else {
@@ -891,7 +912,7 @@ bool MeshInput::LoadPLY (std::istream &inp)
                         if (boost::regex_search(line, what, rx_d)) {
                             double v;
                             v = boost::lexical_cast<double>(what[1]);
-                            prop_values[it->first] = static_cast<float>(v);
+                            prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                             line = line.substr(what[0].length());
                         }
                         else {
@@ -904,15 +925,15 @@ bool MeshInput::LoadPLY (std::istream &inp)
             }
 
             Base::Vector3f pt;
-            pt.x = (prop_values["x"]);
-            pt.y = (prop_values["y"]);
-            pt.z = (prop_values["z"]);
+            pt.x = prop_values[index_x];
+            pt.y = prop_values[index_y];
+            pt.z = prop_values[index_z];
             meshPoints.push_back(pt);
 
             if (_material && (rgb_value == MeshIO::PER_VERTEX)) {
-                float r = (prop_values["red"]) / 255.0f;
-                float g = (prop_values["green"]) / 255.0f;
-                float b = (prop_values["blue"]) / 255.0f;
+                float r = prop_values[index_r] / 255.0f;
+                float g = prop_values[index_g] / 255.0f;
+                float b = prop_values[index_b] / 255.0f;
                 _material->diffuseColor.push_back(App::Color(r, g, b));
             }
         }
@@ -937,48 +958,47 @@ bool MeshInput::LoadPLY (std::istream &inp)
 
         for (std::size_t i = 0; i < v_count; i++) {
             // go through the vertex properties
-            std::map<std::string, float> prop_values;
             for (std::vector<std::pair<std::string, Number> >::iterator it = vertex_props.begin(); it != vertex_props.end(); ++it) {
                 switch (it->second) {
                 case int8:
                     {
                         int8_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 case uint8:
                     {
                         uint8_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 case int16:
                     {
                         int16_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 case uint16:
                     {
                         uint16_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 case int32:
                     {
                         int32_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 case uint32:
                     {
                         uint32_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 case float32:
                     {
                         float v; is >> v;
-                        prop_values[it->first] = v;
+                        prop_values[it - vertex_props.begin()] = v;
                     } break;
                 case float64:
                     {
                         double v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
+                        prop_values[it - vertex_props.begin()] = static_cast<float>(v);
                     } break;
                 default:
                     return false;
@@ -986,15 +1006,15 @@ bool MeshInput::LoadPLY (std::istream &inp)
             }
 
             Base::Vector3f pt;
-            pt.x = (prop_values["x"]);
-            pt.y = (prop_values["y"]);
-            pt.z = (prop_values["z"]);
+            pt.x = prop_values[index_x];
+            pt.y = prop_values[index_y];
+            pt.z = prop_values[index_z];
             meshPoints.push_back(pt);
 
             if (_material && (rgb_value == MeshIO::PER_VERTEX)) {
-                float r = (prop_values["red"]) / 255.0f;
-                float g = (prop_values["green"]) / 255.0f;
-                float b = (prop_values["blue"]) / 255.0f;
+                float r = prop_values[index_r] / 255.0f;
+                float g = prop_values[index_g] / 255.0f;
+                float b = prop_values[index_b] / 255.0f;
                 _material->diffuseColor.push_back(App::Color(r, g, b));
             }
         }
@@ -1164,7 +1184,7 @@ bool MeshInput::LoadAsciiSTL (std::istream &rstrIn)
     // restart from the beginning
     buf->pubseekoff(0, std::ios::beg, std::ios::in);
 
-    MeshBuilder builder(this->_rclMesh);
+    MeshFastBuilder builder(this->_rclMesh);
     builder.Initialize(ulFacetCt);
 
     ulVertexCt = 0;
@@ -1199,7 +1219,6 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
 {
     char szInfo[80];
     Base::Vector3f clVects[4];
-    uint16_t usAtt = 0;
     uint32_t ulCt = 0;
 
     if (!rstrIn || rstrIn.bad() == true)
@@ -1229,18 +1248,31 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     if (ulCt > ulFac)
         return false;// not a valid STL file
  
-    MeshBuilder builder(this->_rclMesh);
+    MeshFastBuilder builder(this->_rclMesh);
     builder.Initialize(ulCt);
 
-    for (uint32_t i = 0; i < ulCt; i++) {
-        // read normal, points
-        rstrIn.read((char*)&clVects, sizeof(clVects));
-
-        std::swap(clVects[0], clVects[3]);
-        builder.AddFacet(clVects);
-
-        // overread 2 bytes attribute
-        rstrIn.read((char*)&usAtt, sizeof(usAtt));
+    // a facet record consists of the normal, three points and 2 bytes
+    // attribute. Read them in blocks to reduce the number of stream calls
+    const uint32_t ulRecord = 50;
+    const uint32_t ulBlock = 4096;
+    std::vector<char> block(ulRecord * ulBlock);
+    for (uint32_t i = 0; i < ulCt; i += ulBlock) {
+        uint32_t ulNum = std::min<uint32_t>(ulBlock, ulCt - i);
+        rstrIn.read(&block[0], ulNum * ulRecord);
+        if (!rstrIn)
+            return false;
+
+        for (uint32_t j = 0; j < ulNum; j++) {
+            // read normal, points
+            float coords[12];
+            memcpy(coords, &block[j * ulRecord], sizeof(coords));
+
+            clVects[3].Set(coords[0], coords[1], coords[2]);
+            clVects[0].Set(coords[3], coords[4], coords[5]);
+            clVects[1].Set(coords[6], coords[7], coords[8]);
+            clVects[2].Set(coords[9], coords[10], coords[11]);
+            builder.AddFacet(clVects);
+        }
     }
 
     builder.Finish();
@@ -30,6 +30,7 @@
 # include <queue>
 #endif
 
+#include <Base/BatchTransform.h>
 #include <Base/Exception.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
@@ -912,15 +913,13 @@ void MeshKernel::operator *= (const Base::Matrix4D &rclMat)
 
 void MeshKernel::Transform (const Base::Matrix4D &rclMat)
 {
-    MeshPointArray::_TIterator  clPIter = _aclPointArray.begin(), clPEIter = _aclPointArray.end();
-    Base::Matrix4D clMatrix(rclMat);
+    Base::BatchTransform trf(rclMat);
+    if (trf.isIdentity() || _aclPointArray.empty())
+        return;
 
-    _clBoundBox.SetVoid();
-    while (clPIter < clPEIter) {
-        *clPIter *= clMatrix;
-        _clBoundBox.Add(*clPIter);
-        clPIter++;
-    }
+    // the points are stored with their flags and property, so pass the stride
+    trf.apply(&_aclPointArray[0].x, _aclPointArray.size(), sizeof(MeshPoint));
+    RecalcBoundBox();
 }
 
 void MeshKernel::Smooth(int iterations, float stepsize)
@@ -367,6 +367,12 @@ public:
     void RemoveInvalids ();
     /** Rebuilds the neighbour indices for all facets. */
     void RebuildNeighbours (void);
+    /** Rebuilds the neighbour indices only around the given facets, e.g. after
+     * their point indices have been changed. The neighbourhood of all facets
+     * that don't share an edge with them is expected to be valid.
+     * The result is the same as of a complete rebuild.
+     */
+    void RebuildNeighbours (const std::vector<unsigned long>& facets);
     /** Removes unreferenced points or facets with invalid indices from the mesh. */
     void Cleanup();
     /** Clears the whole data structure. */
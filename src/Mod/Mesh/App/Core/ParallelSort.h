@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_PARALLELSORT_H
+#define MESH_PARALLELSORT_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+namespace MeshCore {
+
+/**
+ * Sorts a big array by sorting chunks of it in parallel and merging the
+ * sorted chunks pairwise afterwards. Elements that are equivalent with
+ * respect to \a Compare may end up in any order, like with std::sort.
+ */
+template <class T, class Compare = std::less<T> >
+class ParallelSort
+{
+    typedef typename std::vector<T>::iterator Iterator;
+
+    struct Range
+    {
+        Iterator first, middle, last;
+    };
+
+    static void sortRange(Range& r, Compare comp)
+    {
+        std::sort(r.first, r.last, comp);
+    }
+
+    static void mergeRange(Range& r, Compare comp)
+    {
+        std::inplace_merge(r.first, r.middle, r.last, comp);
+    }
+
+public:
+    static void sort(std::vector<T>& data, Compare comp = Compare())
+    {
+        // for small arrays it's not worth to use threads
+        std::size_t numChunks = std::min<std::size_t>(data.size() / 65536,
+            static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1)));
+        if (numChunks < 2) {
+            std::sort(data.begin(), data.end(), comp);
+            return;
+        }
+
+        std::size_t chunkSize = data.size() / numChunks;
+        std::vector<Range> chunks(numChunks);
+        for (std::size_t i = 0; i < numChunks; i++) {
+            chunks[i].first = data.begin() + i * chunkSize;
+            chunks[i].middle = chunks[i].first;
+            chunks[i].last = (i + 1 < numChunks) ? chunks[i].first + chunkSize : data.end();
+        }
+
+        QFuture<void> future = QtConcurrent::map
+            (chunks, boost::bind(&ParallelSort<T, Compare>::sortRange, _1, comp));
+        future.waitForFinished();
+
+        while (chunks.size() > 1) {
+            std::vector<Range> merged;
+            merged.reserve((chunks.size() + 1) / 2);
+            for (std::size_t i = 0; i + 1 < chunks.size(); i += 2) {
+                Range r;
+                r.first = chunks[i].first;
+                r.middle = chunks[i+1].first;
+                r.last = chunks[i+1].last;
+                merged.push_back(r);
+            }
+            std::vector<Range> pending(merged);
+            if (chunks.size() % 2 == 1) {
+                Range r = chunks.back();
+                r.middle = r.first;
+                pending.push_back(r);
+            }
+
+            future = QtConcurrent::map
+                (merged, boost::bind(&ParallelSort<T, Compare>::mergeRange, _1, comp));
+            future.waitForFinished();
+            chunks.swap(pending);
+        }
+    }
+};
+
+} // namespace MeshCore
+
+#endif // MESH_PARALLELSORT_H
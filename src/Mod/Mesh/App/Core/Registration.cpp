@@ -0,0 +1,358 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <climits>
+# include <cmath>
+#endif
+
+#include <QFuture>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+
+#include "Registration.h"
+#include "Iterator.h"
+#include "Definitions.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+struct MeshRegistration::PointPair
+{
+    Base::Vector3f point;   // transformed point
+    Base::Vector3f nearest; // nearest point on the mesh
+    Base::Vector3f normal;  // normal of the nearest facet
+    float distance;
+    bool valid;
+};
+
+struct MeshRegistration::Range
+{
+    std::size_t first, last;
+};
+
+namespace MeshCore {
+
+/**
+ * Computes the principal axes of the weighted points with the center of gravity
+ * as origin and returns the transformation from the local into the world system.
+ * The signs of the axes are chosen like in MeshEigensystem.
+ */
+static Base::Matrix4D PrincipalAxes(const std::vector<Base::Vector3f>& points,
+                                    const std::vector<double>& weights)
+{
+    double sum = 0.0;
+    Eigen::Vector3d c = Eigen::Vector3d::Zero();
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const Base::Vector3f& p = points[i];
+        c += weights[i] * Eigen::Vector3d(p.x, p.y, p.z);
+        sum += weights[i];
+    }
+    if (sum <= 0.0)
+        return Base::Matrix4D();
+    c /= sum;
+
+    Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const Base::Vector3f& p = points[i];
+        Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - c;
+        cov += weights[i] * d * d.transpose();
+    }
+
+    // the eigenvalues are in increasing order
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(cov);
+    Eigen::Vector3d u = eig.eigenvectors().col(2);
+    Eigen::Vector3d v = eig.eigenvectors().col(1);
+    Eigen::Vector3d w = eig.eigenvectors().col(0);
+
+    double fSumU = 0.0, fSumV = 0.0, fSumW = 0.0;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const Base::Vector3f& p = points[i];
+        Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - c;
+        double fU = u.dot(d);
+        double fV = v.dot(d);
+        double fW = w.dot(d);
+        fSumU += weights[i] * (fU > 0 ? fU * fU : -fU * fU);
+        fSumV += weights[i] * (fV > 0 ? fV * fV : -fV * fV);
+        fSumW += weights[i] * (fW > 0 ? fW * fW : -fW * fW);
+    }
+
+    if (fSumU < 0.0)
+        u = -u;
+    if (fSumV < 0.0)
+        v = -v;
+    if (fSumW < 0.0)
+        w = -w;
+    if (u.cross(v).dot(w) < 0.0)
+        w = -w;
+
+    Base::Matrix4D mat;
+    mat[0][0] = u.x(); mat[0][1] = v.x(); mat[0][2] = w.x(); mat[0][3] = c.x();
+    mat[1][0] = u.y(); mat[1][1] = v.y(); mat[1][2] = w.y(); mat[1][3] = c.y();
+    mat[2][0] = u.z(); mat[2][1] = v.z(); mat[2][2] = w.z(); mat[2][3] = c.z();
+    return mat;
+}
+
+}
+
+MeshRegistration::MeshRegistration(const MeshKernel& nominal)
+  : myKernel(nominal), myGrid(nominal), myMaxIterations(50), myTolerance(1.0e-4f),
+    myTrimRatio(0.9f), myMaxDistance(0.0f)
+{
+}
+
+MeshRegistration::~MeshRegistration()
+{
+}
+
+void MeshRegistration::FindPairsInRange(const std::vector<Base::Vector3f>& points,
+                                        const Base::Matrix4D& mat,
+                                        std::vector<PointPair>& pairs,
+                                        const Range& range) const
+{
+    for (std::size_t i = range.first; i < range.last; i++) {
+        PointPair& pair = pairs[i];
+        pair.point = mat * points[i];
+        unsigned long index;
+        if (myMaxDistance > 0.0f) {
+            index = myGrid.SearchNearestFromPoint(pair.point, myMaxDistance);
+        }
+        else {
+            // the search from outside of the grid doesn't necessarily return the
+            // nearest facet, so look for a closer one within the found distance
+            index = myGrid.SearchNearestFromPoint(pair.point);
+            if (index != ULONG_MAX) {
+                float dist = myKernel.GetFacet(index).DistanceToPoint(pair.point);
+                unsigned long nearest = myGrid.SearchNearestFromPoint(pair.point, 1.001f * dist + FLOAT_EPS);
+                if (nearest != ULONG_MAX)
+                    index = nearest;
+            }
+        }
+        pair.valid = (index != ULONG_MAX);
+        if (pair.valid) {
+            MeshGeomFacet facet = myKernel.GetFacet(index);
+            pair.distance = facet.DistanceToPoint(pair.point, pair.nearest);
+            pair.normal = facet.GetNormal();
+            // ignore degenerated facets
+            pair.valid = pair.normal.Sqr() > 0.0f;
+        }
+    }
+}
+
+void MeshRegistration::FindPairs(const std::vector<Base::Vector3f>& points,
+                                 const Base::Matrix4D& mat,
+                                 std::vector<PointPair>& pairs) const
+{
+    pairs.resize(points.size());
+
+    const std::size_t chunkSize = 1024;
+    std::vector<Range> ranges;
+    for (std::size_t i = 0; i < points.size(); i += chunkSize) {
+        Range r;
+        r.first = i;
+        r.last = std::min<std::size_t>(i + chunkSize, points.size());
+        ranges.push_back(r);
+    }
+
+    if (ranges.size() == 1) {
+        FindPairsInRange(points, mat, pairs, ranges.front());
+    }
+    else {
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&MeshRegistration::FindPairsInRange, this,
+                                 boost::cref(points), boost::cref(mat), boost::ref(pairs), _1));
+        future.waitForFinished();
+    }
+
+    pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+        boost::bind(&PointPair::valid, _1) == false), pairs.end());
+}
+
+void MeshRegistration::TrimPairs(std::vector<PointPair>& pairs) const
+{
+    if (myTrimRatio >= 1.0f || pairs.empty())
+        return;
+
+    std::size_t keep = static_cast<std::size_t>(std::ceil(myTrimRatio * pairs.size()));
+    if (keep < pairs.size()) {
+        std::nth_element(pairs.begin(), pairs.begin() + keep, pairs.end(),
+            boost::bind(&PointPair::distance, _1) < boost::bind(&PointPair::distance, _2));
+        pairs.resize(keep);
+    }
+}
+
+float MeshRegistration::TrimmedDistance(const std::vector<Base::Vector3f>& points,
+                                        const Base::Matrix4D& mat) const
+{
+    std::vector<PointPair> pairs;
+    FindPairs(points, mat, pairs);
+    TrimPairs(pairs);
+    if (pairs.empty())
+        return FLOAT_MAX;
+
+    double sum = 0.0;
+    for (std::vector<PointPair>::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+        sum += it->distance * it->distance;
+    // penalize positions where only a few points find a partner
+    return static_cast<float>(std::sqrt(sum / pairs.size()) * points.size() / pairs.size());
+}
+
+Base::Matrix4D MeshRegistration::CoarseAlignment(const std::vector<Base::Vector3f>& points,
+                                                 const Base::Matrix4D& start) const
+{
+    if (points.size() < 3 || myKernel.CountFacets() == 0)
+        return start;
+
+    // the points sample the surface evenly while the vertices of a CAD mesh
+    // gather in curved regions, so use the facet centers weighted by area
+    std::vector<Base::Vector3f> centers;
+    std::vector<double> areas;
+    centers.reserve(myKernel.CountFacets());
+    areas.reserve(myKernel.CountFacets());
+    MeshFacetIterator it(myKernel);
+    for (it.Init(); it.More(); it.Next()) {
+        centers.push_back(it->GetGravityPoint());
+        areas.push_back(it->Area());
+    }
+    Base::Matrix4D target = PrincipalAxes(centers, areas);
+    Base::Matrix4D source = PrincipalAxes(points, std::vector<double>(points.size(), 1.0));
+    source.inverseOrthogonal();
+
+    // a subset of the points is sufficient to rate the candidates
+    std::vector<Base::Vector3f> subset;
+    std::size_t step = std::max<std::size_t>(1, points.size() / 1000);
+    for (std::size_t i = 0; i < points.size(); i += step)
+        subset.push_back(points[i]);
+
+    Base::Matrix4D best = start;
+    float bestDistance = TrimmedDistance(subset, start);
+
+    // rotations by 180 degree around the axes keep the system right-handed
+    static const double flip[4][3] = {{1,1,1}, {1,-1,-1}, {-1,1,-1}, {-1,-1,1}};
+    for (int i = 0; i < 4; i++) {
+        Base::Matrix4D scale;
+        scale.scale(flip[i][0], flip[i][1], flip[i][2]);
+        Base::Matrix4D candidate = target * scale * source;
+        float distance = TrimmedDistance(subset, candidate);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+bool MeshRegistration::SolveStep(const std::vector<PointPair>& pairs, Base::Matrix4D& delta,
+                                 double& angle, double& shift) const
+{
+    // rotate around the center of gravity for a better conditioned system
+    Base::Vector3d center;
+    for (std::vector<PointPair>::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+        center += Base::convertTo<Base::Vector3d>(it->point);
+    center /= static_cast<double>(pairs.size());
+
+    // minimize sum(((p - c) x n) * r + n * t + (p - q) * n)^2
+    Eigen::Matrix<double, 6, 6> ata = Eigen::Matrix<double, 6, 6>::Zero();
+    Eigen::Matrix<double, 6, 1> atb = Eigen::Matrix<double, 6, 1>::Zero();
+    for (std::vector<PointPair>::const_iterator it = pairs.begin(); it != pairs.end(); ++it) {
+        Base::Vector3d p = Base::convertTo<Base::Vector3d>(it->point);
+        Base::Vector3d q = Base::convertTo<Base::Vector3d>(it->nearest);
+        Base::Vector3d n = Base::convertTo<Base::Vector3d>(it->normal);
+        Base::Vector3d c = (p - center) % n;
+        Eigen::Matrix<double, 6, 1> a;
+        a << c.x, c.y, c.z, n.x, n.y, n.z;
+        ata += a * a.transpose();
+        atb -= a * ((p - q) * n);
+    }
+
+    // damp the degrees of freedom that are not determined, e.g. for planar data
+    ata.diagonal().array() += 1.0e-12 * ata.trace();
+    Eigen::LDLT<Eigen::Matrix<double, 6, 6> > ldlt(ata);
+    if (ldlt.info() != Eigen::Success)
+        return false;
+    Eigen::Matrix<double, 6, 1> x = ldlt.solve(atb);
+
+    Base::Vector3d axis(x[0], x[1], x[2]);
+    Base::Vector3d move(x[3], x[4], x[5]);
+    angle = axis.Length();
+    shift = move.Length();
+    // also rejects NaN values
+    if (!(angle < DBL_MAX && shift < DBL_MAX))
+        return false;
+
+    delta.setToUnity();
+    if (angle > 0.0)
+        delta.rotLine(center, axis, angle);
+    delta.move(move);
+    return true;
+}
+
+bool MeshRegistration::Align(const std::vector<Base::Vector3f>& points, Base::Matrix4D& mat)
+{
+    myIterations.clear();
+    if (myKernel.CountFacets() == 0)
+        return false;
+
+    // converts an angle into the displacement of the farthest point
+    Base::BoundBox3f box = myKernel.GetBoundBox();
+    double radius = 0.5 * box.CalcDiagonalLength();
+
+    std::vector<PointPair> pairs;
+    for (int i = 0; i < myMaxIterations; i++) {
+        FindPairs(points, mat, pairs);
+        TrimPairs(pairs);
+        // at least six pairs are needed for the six degrees of freedom
+        if (pairs.size() < 6)
+            return false;
+
+        Iteration info;
+        double sum = 0.0;
+        for (std::vector<PointPair>::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+            sum += it->distance * it->distance;
+        info.rms = static_cast<float>(std::sqrt(sum / pairs.size()));
+        info.pairs = pairs.size();
+
+        Base::Matrix4D delta;
+        if (!SolveStep(pairs, delta, info.rotation, info.translation))
+            return false;
+        mat = delta * mat;
+
+        // on noisy data the step does not vanish but dithers below the
+        // residual, so stop as well once the residual no longer improves
+        double motion = info.translation + info.rotation * radius;
+        bool stalled = !myIterations.empty() && motion < 0.5 * info.rms &&
+                       info.rms > 0.99f * myIterations.back().rms;
+        myIterations.push_back(info);
+
+        if (motion < myTolerance || stalled)
+            return true;
+    }
+
+    return false;
+}
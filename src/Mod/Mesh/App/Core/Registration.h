@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESHCORE_REGISTRATION_H
+#define MESHCORE_REGISTRATION_H
+
+#include <vector>
+#include <Base/Matrix.h>
+#include <Base/Vector3D.h>
+
+#include "Grid.h"
+
+namespace MeshCore
+{
+class MeshKernel;
+
+/**
+ * The MeshRegistration class aligns a set of points, e.g. a scan or the points
+ * of another mesh, to a nominal mesh with the iterative closest point algorithm.
+ *
+ * Each iteration searches the nearest facet of every point in parallel, drops
+ * the pairs with the largest distances (trimmed ICP) and minimizes the sum of
+ * the squared point-to-plane distances of the remaining pairs by a linearized
+ * rigid motion. Optionally, the start position is estimated by matching the
+ * principal axes of the points with the ones of the mesh.
+ */
+class MeshExport MeshRegistration
+{
+public:
+    /** Statistics of one iteration. */
+    struct Iteration
+    {
+        float rms;              /**< Root mean square distance of the used pairs. */
+        unsigned long pairs;    /**< Number of used pairs. */
+        double rotation;        /**< Angle of the incremental rotation in radian. */
+        double translation;     /**< Length of the incremental translation. */
+    };
+
+    MeshRegistration(const MeshKernel& nominal);
+    ~MeshRegistration();
+
+    /** Sets the maximum number of iterations. The default is 50. */
+    void SetMaxIterations(int num)
+    { myMaxIterations = num; }
+    /** The algorithm has converged if the incremental motion moves no point
+     * by more than \a tol. The default is 1.0e-4.
+     */
+    void SetTolerance(float tol)
+    { myTolerance = tol; }
+    /** Sets the ratio of the closest pairs that are used in each iteration.
+     * The default is 0.9, a value of 1 disables the trimming.
+     */
+    void SetTrimRatio(float ratio)
+    { myTrimRatio = ratio; }
+    /** Points with a larger distance to the mesh are ignored. The default is 0
+     * which means no limit.
+     */
+    void SetMaxDistance(float dist)
+    { myMaxDistance = dist; }
+
+    /**
+     * Returns the transformation that moves the principal axes of the points onto
+     * the ones of the mesh. Because the directions of the axes are ambiguous for
+     * (nearly) symmetric data all proper variants and \a start are tried, the one
+     * with the smallest trimmed distance is returned.
+     */
+    Base::Matrix4D CoarseAlignment(const std::vector<Base::Vector3f>& points,
+                                   const Base::Matrix4D& start) const;
+    /**
+     * Computes the rigid transformation that moves the \a points onto the mesh.
+     * \a mat is used as start position and is set to the result. Returns true
+     * if the algorithm has converged within the maximum number of iterations,
+     * i.e. the step falls below the tolerance or the residual stops improving.
+     */
+    bool Align(const std::vector<Base::Vector3f>& points, Base::Matrix4D& mat);
+    /** Returns the statistics of the iterations of the last call of Align(). */
+    const std::vector<Iteration>& GetIterations() const
+    { return myIterations; }
+
+private:
+    struct PointPair;
+    struct Range;
+
+    void FindPairs(const std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat,
+                   std::vector<PointPair>& pairs) const;
+    void FindPairsInRange(const std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat,
+                          std::vector<PointPair>& pairs, const Range& range) const;
+    void TrimPairs(std::vector<PointPair>& pairs) const;
+    float TrimmedDistance(const std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat) const;
+    bool SolveStep(const std::vector<PointPair>& pairs, Base::Matrix4D& delta,
+                   double& angle, double& shift) const;
+
+private:
+    const MeshKernel& myKernel;
+    MeshFacetGrid myGrid;
+    int myMaxIterations;
+    float myTolerance;
+    float myTrimRatio;
+    float myMaxDistance;
+    std::vector<Iteration> myIterations;
+};
+
+} // namespace MeshCore
+
+#endif // MESHCORE_REGISTRATION_H
@@ -29,6 +29,11 @@
 #endif
 
 #include <fstream>
+
+#include <QFuture>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
 #include "SetOperations.h"
 #include "Algorithm.h"
 #include "Elements.h"
@@ -44,6 +49,7 @@
 
 #include <Base/Sequencer.h>
 #include <Base/Builder3D.h>
+#include <Base/Tools.h>
 #include <Base/Tools2D.h>
 
 using namespace Base;
@@ -73,9 +79,15 @@ void SetOperations::Do ()
 
   // _builder.clear();
 
+  _timing = Timing();
+  Base::StopWatch totalWatch, phaseWatch;
+  totalWatch.start();
+  phaseWatch.start();
+
   //Base::Sequencer().next();
   std::set<unsigned long> facetsCuttingEdge0, facetsCuttingEdge1;
   Cut(facetsCuttingEdge0, facetsCuttingEdge1);
+  _timing.cut = phaseWatch.restart();
 
   // no intersection curve of the meshes found
   if (facetsCuttingEdge0.empty() || facetsCuttingEdge1.empty())
@@ -105,19 +117,28 @@ void SetOperations::Do ()
     }
     
     MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
+    _timing.total = totalWatch.elapsed();
     return;
   }
 
+  // walk through the sorted sets instead of searching each facet index
   unsigned long i;
+  std::set<unsigned long>::const_iterator cut;
+  cut = facetsCuttingEdge0.begin();
   for (i = 0; i < _cutMesh0.CountFacets(); i++)
   {
-    if (facetsCuttingEdge0.find(i) == facetsCuttingEdge0.end())
+    if (cut != facetsCuttingEdge0.end() && *cut == i)
+      ++cut;
+    else
       _newMeshFacets[0].push_back(_cutMesh0.GetFacet(i));
   }
 
+  cut = facetsCuttingEdge1.begin();
   for (i = 0; i < _cutMesh1.CountFacets(); i++)
   {
-    if (facetsCuttingEdge1.find(i) == facetsCuttingEdge1.end())
+    if (cut != facetsCuttingEdge1.end() && *cut == i)
+      ++cut;
+    else
       _newMeshFacets[1].push_back(_cutMesh1.GetFacet(i));
   }
 
@@ -126,6 +147,7 @@ void SetOperations::Do ()
 
   //Base::Sequencer().next();
   TriangulateMesh(_cutMesh1, 1);
+  _timing.triangulate = phaseWatch.restart();
 
   float mult0, mult1;
   switch (_operationType)
@@ -142,6 +164,7 @@ void SetOperations::Do ()
   CollectFacets(0, mult0);
   //Base::Sequencer().next();
   CollectFacets(1, mult1);
+  _timing.collect = phaseWatch.restart();
 
   std::vector<MeshGeomFacet> facets;
 
@@ -168,6 +191,7 @@ void SetOperations::Do ()
   // _builder.saveToFile("c:/temp/vdbg.iv");
 
   MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
+  _timing.total = totalWatch.elapsed();
 }
 
 void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
@@ -178,6 +202,8 @@ void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<u
   unsigned long ctGx1, ctGy1, ctGz1;
   grid1.GetCtGrids(ctGx1, ctGy1, ctGz1);
 
+  // collect all non-empty grid cells of mesh 1
+  std::vector<CutCell> cells;
   unsigned long gx1;
   for (gx1 = 0; gx1 < ctGx1; gx1++)  
   {
@@ -189,227 +215,173 @@ void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<u
       {
         if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
         {
-          std::vector<unsigned long> vecFacets2;
-          grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
-      
-          if (vecFacets2.size() > 0)
-          {
-            std::set<unsigned long> vecFacets1;
-            grid1.GetElements(gx1, gy1, gz1, vecFacets1);
-            
-            std::set<unsigned long>::iterator it1;
-            for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-            {
-              unsigned long fidx1 = *it1;
-              MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
-              
-              std::vector<unsigned long>::iterator it2;
-              for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-              {
-                unsigned long fidx2 = *it2;
-                MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
-
-                MeshPoint p0, p1;
-
-                int isect = f1.IntersectWithFacet(f2, p0, p1);
-                if (isect > 0)
-                { 
-                   // optimize cut line if distance to nearest point is too small
-                  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
-                  MeshPoint np0 = p0, np1 = p1;
-                  int i;
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f1._aclPoints[i] - p0).Length();
-                    float d2 = (f1._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f1._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      p1 = f1._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  // optimize cut line if distance to nearest point is too small
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f2._aclPoints[i] - p0).Length();
-                    float d2 = (f2._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f2._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      np1 = f2._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  MeshPoint mp0 = np0;
-                  MeshPoint mp1 = np1;
-
-                  if (mp0 != mp1)
-                  {
-                    facetsCuttingEdge0.insert(fidx1);
-                    facetsCuttingEdge1.insert(fidx2);
-
-                    _cutPoints.insert(mp0);
-                    _cutPoints.insert(mp1);
-
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
-
-                    _edges[Edge(mp0, mp1)] = EdgeInfo();
-
-                    _facet2points[0][fidx1].push_back(pit0.first);
-                    _facet2points[0][fidx1].push_back(pit1.first);
-                    _facet2points[1][fidx2].push_back(pit0.first);
-                    _facet2points[1][fidx2].push_back(pit1.first);
-
-                  }
-                  else
-                  {
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
-
-                    // do not insert a facet when only one corner point cuts the edge
-                    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                    {
-                      facetsCuttingEdge0.insert(fidx1);
-                      _facet2points[0][fidx1].push_back(pit.first);
-                    }
-
-                    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                    {
-                      facetsCuttingEdge1.insert(fidx2);
-                      _facet2points[1][fidx2].push_back(pit.first);
-                    }
-                  }
-
-                 } // if (f1.IntersectWithFacet(f2, p0, p1))
-              } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-            } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-          } // if (vecFacets2.size() > 0)
-        } // if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
-      } // for (gz1 = 0; gz1 < ctGz1; gz1++)
-    } // for (gy1 = 0; gy1 < ctGy1; gy1++)
-  } // for (gx1 = 0; gx1 < ctGx1; gx1++)  
-}
+          CutCell cell;
+          cell.x = gx1;
+          cell.y = gy1;
+          cell.z = gz1;
+          cells.push_back(cell);
+        }
+      }
+    }
+  }
 
-void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
-{
-  // Triangulate Mesh 
-  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::iterator it1;
-  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+  // the facet-facet intersections of the cells are independent of each other
+  QFuture<void> future = QtConcurrent::map
+      (cells, boost::bind(&SetOperations::CutGridCell, this, boost::cref(grid1), boost::cref(grid2), _1));
+  future.waitForFinished();
+
+  // merge the results in the order of the grid cells so that the outcome
+  // doesn't depend on the number of threads
+  std::vector<CutCell>::const_iterator itc;
+  for (itc = cells.begin(); itc != cells.end(); ++itc)
   {
-    std::vector<Vector3f> points;
-    std::set<MeshPoint>   pointsSet;
+    std::vector<CutResult>::const_iterator itr;
+    for (itr = itc->results.begin(); itr != itc->results.end(); ++itr)
+    {
+      unsigned long fidx1 = itr->facet0;
+      unsigned long fidx2 = itr->facet1;
+      const MeshPoint& mp0 = itr->pt0;
+      const MeshPoint& mp1 = itr->pt1;
 
-    unsigned long fidx = it1->first;
-    MeshGeomFacet f = cutMesh.GetFacet(fidx);
+      if (mp0 != mp1)
+      {
+        facetsCuttingEdge0.insert(fidx1);
+        facetsCuttingEdge1.insert(fidx2);
 
-    //if (side == 1)
-    //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
+        std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
+        std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
 
-     // facet corner points
-    //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
-    int i;
-    for (i = 0; i < 3; i++)
-    {
-      pointsSet.insert(f._aclPoints[i]);
-      points.push_back(f._aclPoints[i]);
-    }
-    
-    // triangulated facets
-    std::list<std::set<MeshPoint>::iterator>::iterator it2;
-    for (it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
-    {
-      if (pointsSet.find(*(*it2)) == pointsSet.end())
-      {
-        pointsSet.insert(*(*it2));
-        points.push_back(*(*it2));
-      }
+        _edges[Edge(mp0, mp1)] = EdgeInfo();
 
-    }
+        _facet2points[0][fidx1].push_back(pit0.first);
+        _facet2points[0][fidx1].push_back(pit1.first);
+        _facet2points[1][fidx2].push_back(pit0.first);
+        _facet2points[1][fidx2].push_back(pit1.first);
+      }
+      else
+      {
+        std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
 
-    Vector3f normal = f.GetNormal();
-    Vector3f base = points[0];
-    Vector3f dirX = points[1] - points[0];
-    dirX.Normalize();
-    Vector3f dirY = dirX % normal;
+        // do not insert a facet when only one corner point cuts the edge
+        // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
+        {
+          facetsCuttingEdge0.insert(fidx1);
+          _facet2points[0][fidx1].push_back(pit.first);
+        }
 
-    // project points to 2D plane
-    std::vector<Vector3f>::iterator it;
-    std::vector<Vector3f> vertices;
-    for (it = points.begin(); it != points.end(); ++it)
-    {
-      Vector3f pv = *it;
-      pv.TransformToCoordinateSystem(base, dirX, dirY);
-      vertices.push_back(pv);
+        // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
+        {
+          facetsCuttingEdge1.insert(fidx2);
+          _facet2points[1][fidx2].push_back(pit.first);
+        }
+      }
     }
+  }
+}
 
-    DelaunayTriangulator tria;
-    tria.SetPolygon(vertices);
-    tria.TriangulatePolygon();
+void SetOperations::CutGridCell (const MeshFacetGrid& grid1, const MeshFacetGrid& grid2, CutCell& cell) const
+{
+  std::vector<unsigned long> vecFacets2;
+  grid2.Inside(grid1.GetBoundBox(cell.x, cell.y, cell.z), vecFacets2);
+
+  if (vecFacets2.size() > 0)
+  {
+    std::set<unsigned long> vecFacets1;
+    grid1.GetElements(cell.x, cell.y, cell.z, vecFacets1);
 
-    std::vector<MeshFacet> facets = tria.GetFacets();
-    for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
+    std::set<unsigned long>::iterator it1;
+    for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
     {
-      if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
-          (it->_aulPoints[1] == it->_aulPoints[2]) ||
-          (it->_aulPoints[2] == it->_aulPoints[0]))
-      { // two same triangle corner points
-        continue;
-      }
-  
-      MeshGeomFacet facet(points[it->_aulPoints[0]],
-                          points[it->_aulPoints[1]],
-                          points[it->_aulPoints[2]]);
-
-      //if (side == 1)
-      // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
-      //if (facet.Area() < 0.0001f)
-      //{ // too small facet
-      //  continue;
-      //}
-
-      float dist0 = facet._aclPoints[0].DistanceToLine
-          (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
-      float dist1 = facet._aclPoints[1].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
-      float dist2 = facet._aclPoints[2].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
-
-      if ((dist0 < _minDistanceToPoint) ||
-          (dist1 < _minDistanceToPoint) ||
-          (dist2 < _minDistanceToPoint))
-      {
-        continue;
-      }
+      unsigned long fidx1 = *it1;
+      MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
 
-      //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
-      //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
-      //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+      std::vector<unsigned long>::iterator it2;
+      for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
+      {
+        unsigned long fidx2 = *it2;
+        MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
+
+        MeshPoint p0, p1;
+
+        int isect = f1.IntersectWithFacet(f2, p0, p1);
+        if (isect > 0)
+        { 
+           // optimize cut line if distance to nearest point is too small
+          float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
+          MeshPoint np0 = p0, np1 = p1;
+          int i;
+          for (i = 0; i < 3; i++)
+          {
+            float d1 = (f1._aclPoints[i] - p0).Length();
+            float d2 = (f1._aclPoints[i] - p1).Length();
+            if (d1 < minDist1)
+            {
+              minDist1 = d1;
+              np0 = f1._aclPoints[i];
+            }
+            if (d2 < minDist2)
+            {
+              minDist2 = d2;
+              p1 = f1._aclPoints[i];
+            }
+          } // for (int i = 0; i < 3; i++)
 
-      //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
-      //{
-      //  continue;
-      //}
+          // optimize cut line if distance to nearest point is too small
+          for (i = 0; i < 3; i++)
+          {
+            float d1 = (f2._aclPoints[i] - p0).Length();
+            float d2 = (f2._aclPoints[i] - p1).Length();
+            if (d1 < minDist1)
+            {
+              minDist1 = d1;
+              np0 = f2._aclPoints[i];
+            }
+            if (d2 < minDist2)
+            {
+              minDist2 = d2;
+              np1 = f2._aclPoints[i];
+            }
+          } // for (int i = 0; i < 3; i++)
+
+          CutResult result;
+          result.facet0 = fidx1;
+          result.facet1 = fidx2;
+          result.pt0 = np0;
+          result.pt1 = np1;
+          cell.results.push_back(result);
+        } // if (f1.IntersectWithFacet(f2, p0, p1))
+      } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
+    } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
+  } // if (vecFacets2.size() > 0)
+}
 
-      facet.CalcNormal();
-      if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
-      { // adjust normal
-         std::swap(facet._aclPoints[0], facet._aclPoints[1]);
-         facet.CalcNormal();
-      }
+void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
+{
+  // Triangulate Mesh 
+  std::vector<TriangulateJob> jobs;
+  jobs.reserve(_facet2points[side].size());
+  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::const_iterator it1;
+  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+  {
+    TriangulateJob job;
+    job.facet = it1;
+    jobs.push_back(job);
+  }
 
+  // the triangulations of the cut facets are independent of each other
+  QFuture<void> future = QtConcurrent::map
+      (jobs, boost::bind(&SetOperations::TriangulateFacet, this, boost::cref(cutMesh), _1));
+  future.waitForFinished();
 
+  // the edge bookkeeping is done in the order of the facet indices
+  std::vector<TriangulateJob>::iterator itj;
+  for (itj = jobs.begin(); itj != jobs.end(); ++itj)
+  {
+    unsigned long fidx = itj->facet->first;
+    std::vector<MeshGeomFacet>::iterator itf;
+    for (itf = itj->facets.begin(); itf != itj->facets.end(); ++itf)
+    {
+      MeshGeomFacet& facet = *itf;
       int j;
       for (j = 0; j < 3; j++)
       {
@@ -433,9 +405,116 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
       }
 
       _newMeshFacets[side].push_back(facet);
+    }
+  }
+}
+
+void SetOperations::TriangulateFacet (const MeshKernel& cutMesh, TriangulateJob& job) const
+{
+  std::vector<Vector3f> points;
+  std::set<MeshPoint>   pointsSet;
+
+  unsigned long fidx = job.facet->first;
+  MeshGeomFacet f = cutMesh.GetFacet(fidx);
+
+  //if (side == 1)
+  //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
+
+   // facet corner points
+  //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
+  int i;
+  for (i = 0; i < 3; i++)
+  {
+    pointsSet.insert(f._aclPoints[i]);
+    points.push_back(f._aclPoints[i]);
+  }
+  
+  // triangulated facets
+  std::list<std::set<MeshPoint>::iterator>::const_iterator it2;
+  for (it2 = job.facet->second.begin(); it2 != job.facet->second.end(); ++it2)
+  {
+    if (pointsSet.find(*(*it2)) == pointsSet.end())
+    {
+      pointsSet.insert(*(*it2));
+      points.push_back(*(*it2));
+    }
+
+  }
+
+  Vector3f normal = f.GetNormal();
+  Vector3f base = points[0];
+  Vector3f dirX = points[1] - points[0];
+  dirX.Normalize();
+  Vector3f dirY = dirX % normal;
+
+  // project points to 2D plane
+  std::vector<Vector3f>::iterator it;
+  std::vector<Vector3f> vertices;
+  for (it = points.begin(); it != points.end(); ++it)
+  {
+    Vector3f pv = *it;
+    pv.TransformToCoordinateSystem(base, dirX, dirY);
+    vertices.push_back(pv);
+  }
+
+  DelaunayTriangulator tria;
+  tria.SetPolygon(vertices);
+  tria.TriangulatePolygon();
+
+  std::vector<MeshFacet> facets = tria.GetFacets();
+  for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
+  {
+    if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
+        (it->_aulPoints[1] == it->_aulPoints[2]) ||
+        (it->_aulPoints[2] == it->_aulPoints[0]))
+    { // two same triangle corner points
+      continue;
+    }
+
+    MeshGeomFacet facet(points[it->_aulPoints[0]],
+                        points[it->_aulPoints[1]],
+                        points[it->_aulPoints[2]]);
+
+    //if (side == 1)
+    // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
+
+    //if (facet.Area() < 0.0001f)
+    //{ // too small facet
+    //  continue;
+    //}
+
+    float dist0 = facet._aclPoints[0].DistanceToLine
+        (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
+    float dist1 = facet._aclPoints[1].DistanceToLine
+        (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
+    float dist2 = facet._aclPoints[2].DistanceToLine
+        (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
+
+    if ((dist0 < _minDistanceToPoint) ||
+        (dist1 < _minDistanceToPoint) ||
+        (dist2 < _minDistanceToPoint))
+    {
+      continue;
+    }
+
+    //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
+    //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
+    //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+
+    //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
+    //{
+    //  continue;
+    //}
+
+    facet.CalcNormal();
+    if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
+    { // adjust normal
+       std::swap(facet._aclPoints[0], facet._aclPoints[1]);
+       facet.CalcNormal();
+    }
 
-    } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
-  } // for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+    job.facets.push_back(facet);
+  } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
 }
 
 void SetOperations::CollectFacets (int side, float mult)
@@ -68,6 +68,20 @@ public:
    */
   void Do ();
 
+  /** Elapsed time in milliseconds of the single phases of the last call of Do().
+   * This is meant to find out where the time goes for large meshes.
+   */
+  struct Timing
+  {
+    int cut;          /**< intersection of the facets of both meshes */
+    int triangulate;  /**< re-triangulation of the cut facets */
+    int collect;      /**< region growing to collect the facets of the result */
+    int total;        /**< whole operation */
+
+    Timing () : cut(0), triangulate(0), collect(0), total(0) {}
+  };
+  const Timing& GetTiming () const { return _timing; }
+
 protected:
   const MeshKernel   &_cutMesh0;             /** Mesh for set operations source 1 */
   const MeshKernel   &_cutMesh1;             /** Mesh for set operations source 2 */
@@ -157,6 +171,27 @@ private:
       bool AllowVisit (const MeshFacet& rclFacet, const MeshFacet& rclFrom, unsigned long ulFInd, unsigned long ulLevel, unsigned short neighbourIndex);
   };
 
+  /** Result of the intersection of two facets of the meshes */
+  struct CutResult
+  {
+    unsigned long facet0, facet1;          // facet indices of mesh 1 and mesh 2
+    MeshPoint     pt0, pt1;                // end points of the cut line
+  };
+
+  /** Intersections found inside a single grid cell of mesh 1 */
+  struct CutCell
+  {
+    unsigned long x, y, z;
+    std::vector<CutResult> results;
+  };
+
+  /** Triangulation of a single cut facet */
+  struct TriangulateJob
+  {
+    std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::const_iterator facet;
+    std::vector<MeshGeomFacet> facets;
+  };
+
   /** all points from cut */
   std::set<MeshPoint>       _cutPoints;
   /** all edges */
@@ -172,6 +207,10 @@ private:
   void Cut (std::set<unsigned long>& facetsNotCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
   /** Trianglute each facets cutted with his cutting points */
   void TriangulateMesh (const MeshKernel &cutMesh, int side);
+  /** Intersect the facets of mesh 1 in one grid cell with the facets of mesh 2, called from several threads */
+  void CutGridCell (const MeshFacetGrid& grid1, const MeshFacetGrid& grid2, CutCell& cell) const;
+  /** Triangulate a single cut facet, called from several threads */
+  void TriangulateFacet (const MeshKernel& cutMesh, TriangulateJob& job) const;
   /** search facets for adding (with region growing) */
   void CollectFacets (int side, float mult);
   /** close gap in the mesh */
@@ -180,6 +219,8 @@ private:
   /** visual debugger */
   Base::Builder3D _builder;
 
+  Timing _timing;
+
 };
 
 
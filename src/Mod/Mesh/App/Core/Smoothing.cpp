@@ -23,8 +23,15 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 #endif
 
+#include <QFuture>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include <Base/Tools.h>
+
 #include "Smoothing.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
@@ -179,95 +186,187 @@ LaplaceSmoothing::~LaplaceSmoothing()
 {
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize)
+void LaplaceSmoothing::BuildAdjacency(Adjacency& adj, const std::vector<unsigned long>* point_indices) const
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
-
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
+    const MeshFacetArray& facets = kernel.GetFacets();
+    unsigned long count = kernel.CountPoints();
+
+    // count the facets around each point, each facet adds two neighbours
+    std::vector<unsigned long> numFacets(count, 0);
+    MeshFacetArray::_TConstIterator it;
+    for (it = facets.begin(); it != facets.end(); ++it) {
+        for (int i=0; i<3; i++)
+            numFacets[it->_aulPoints[i]]++;
+    }
+
+    std::vector<unsigned long> rows(count + 1, 0);
+    for (unsigned long i=0; i<count; i++)
+        rows[i+1] = rows[i] + 2 * numFacets[i];
+
+    std::vector<unsigned long> raw(rows[count]);
+    std::vector<unsigned long> fill(rows.begin(), rows.end() - 1);
+    for (it = facets.begin(); it != facets.end(); ++it) {
+        for (int i=0; i<3; i++) {
+            unsigned long p = it->_aulPoints[i];
+            raw[fill[p]++] = it->_aulPoints[(i+1)%3];
+            raw[fill[p]++] = it->_aulPoints[(i+2)%3];
         }
+    }
 
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+    // points that are allowed to move
+    std::vector<bool> movable(count, point_indices == 0);
+    if (point_indices) {
+        std::vector<unsigned long>::const_iterator jt;
+        for (jt = point_indices->begin(); jt != point_indices->end(); ++jt)
+            if (*jt < count)
+                movable[*jt] = true;
+    }
+    std::vector<unsigned long>::const_iterator jt;
+    for (jt = fixedPoints.begin(); jt != fixedPoints.end(); ++jt) {
+        if (*jt < count)
+            movable[*jt] = false;
+    }
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-v_it->x);
-            dely += w*((v_beg[*cv_it]).y-v_it->y);
-            delz += w*((v_beg[*cv_it]).z-v_it->z);
-        }
+    adj.offsets.resize(count + 1);
+    adj.neighbours.clear();
+    adj.neighbours.reserve(raw.size() / 2);
+    adj.offsets[0] = 0;
+    for (unsigned long i=0; i<count; i++) {
+        std::vector<unsigned long>::iterator beg = raw.begin() + rows[i];
+        std::vector<unsigned long>::iterator end = raw.begin() + rows[i+1];
+        std::sort(beg, end);
+        end = std::unique(beg, end);
+        unsigned long n_count = std::distance(beg, end);
+
+        // do nothing for border points
+        if (movable[i] && n_count >= 3 && n_count == numFacets[i])
+            adj.neighbours.insert(adj.neighbours.end(), beg, end);
+        adj.offsets[i+1] = adj.neighbours.size();
+    }
+}
+
+void LaplaceSmoothing::LoadPoints()
+{
+    const MeshPointArray& points = kernel.GetPoints();
+    unsigned long count = points.size();
+    for (int j=0; j<3; j++) {
+        coords[j].resize(count);
+        buffer[j].resize(count);
+    }
+
+    for (unsigned long i=0; i<count; i++) {
+        coords[0][i] = points[i].x;
+        coords[1][i] = points[i].y;
+        coords[2][i] = points[i].z;
+    }
 
-        float x = (float)(v_it->x+stepsize*delx);
-        float y = (float)(v_it->y+stepsize*dely);
-        float z = (float)(v_it->z+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
+    // split into chunks for the thread pool
+    ranges.clear();
+    const unsigned long chunk = 16384;
+    for (unsigned long i=0; i<count; i += chunk) {
+        Range r;
+        r.begin = i;
+        r.end = std::min<unsigned long>(i + chunk, count);
+        ranges.push_back(r);
     }
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize,
-                                const std::vector<unsigned long>& point_indices)
+void LaplaceSmoothing::StorePoints()
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
+    unsigned long count = coords[0].size();
+    for (unsigned long i=0; i<count; i++)
+        kernel.SetPoint(i, coords[0][i], coords[1][i], coords[2][i]);
+    kernel.RecalcBoundBox();
+
+    for (int j=0; j<3; j++) {
+        std::vector<float>().swap(coords[j]);
+        std::vector<float>().swap(buffer[j]);
+    }
+}
 
-    for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
+void LaplaceSmoothing::UmbrellaRange(const Adjacency& adj, double stepsize, const Range& range)
+{
+    const float* px = &coords[0][0];
+    const float* py = &coords[1][0];
+    const float* pz = &coords[2][0];
+    float* qx = &buffer[0][0];
+    float* qy = &buffer[1][0];
+    float* qz = &buffer[2][0];
+    const unsigned long* off = &adj.offsets[0];
+    const unsigned long* nbs = adj.neighbours.empty() ? 0 : &adj.neighbours[0];
+
+    for (unsigned long pos = range.begin; pos < range.end; pos++) {
+        unsigned long beg = off[pos], end = off[pos+1];
+        if (beg == end) {
+            qx[pos] = px[pos];
+            qy[pos] = py[pos];
+            qz[pos] = pz[pos];
             continue;
         }
 
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
-
+        double w = 1.0/double(end - beg);
         double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*((v_beg[*cv_it]).z-(v_beg[*pos]).z);
+        for (unsigned long k = beg; k < end; k++) {
+            unsigned long nb = nbs[k];
+            delx += w*(px[nb]-px[pos]);
+            dely += w*(py[nb]-py[pos]);
+            delz += w*(pz[nb]-pz[pos]);
         }
 
-        float x = (float)((v_beg[*pos]).x+stepsize*delx);
-        float y = (float)((v_beg[*pos]).y+stepsize*dely);
-        float z = (float)((v_beg[*pos]).z+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
+        qx[pos] = (float)(px[pos]+stepsize*delx);
+        qy[pos] = (float)(py[pos]+stepsize*dely);
+        qz[pos] = (float)(pz[pos]+stepsize*delz);
     }
 }
 
-void LaplaceSmoothing::Smooth(unsigned int iterations)
+void LaplaceSmoothing::Umbrella(const Adjacency& adj, double stepsize)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
-
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
+    if (ranges.size() > 1) {
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&LaplaceSmoothing::UmbrellaRange, this, boost::cref(adj), stepsize, _1));
+        future.waitForFinished();
+    }
+    else if (!ranges.empty()) {
+        UmbrellaRange(adj, stepsize, ranges.front());
     }
+
+    for (int j=0; j<3; j++)
+        coords[j].swap(buffer[j]);
 }
 
-void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+void LaplaceSmoothing::Iterate(const Adjacency& adj)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    Umbrella(adj, lambda);
+}
+
+void LaplaceSmoothing::Run(unsigned int iterations, const std::vector<unsigned long>* point_indices)
+{
+    iterationTimes.clear();
+    if (kernel.CountPoints() == 0)
+        return;
+
+    Adjacency adj;
+    BuildAdjacency(adj, point_indices);
+    LoadPoints();
 
+    Base::StopWatch watch;
     for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
+        watch.start();
+        Iterate(adj);
+        iterationTimes.push_back(watch.elapsed());
     }
+
+    StorePoints();
+}
+
+void LaplaceSmoothing::Smooth(unsigned int iterations)
+{
+    Run(iterations, 0);
+}
+
+void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+{
+    Run(iterations, &point_indices);
 }
 
 TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
@@ -281,28 +380,20 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
-
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
-        Umbrella(vv_it, vf_it, -(lambda+micro));
-    }
+    Run(iterations, 0);
 }
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
-
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
-        Umbrella(vv_it, vf_it, -(lambda+micro), point_indices);
-    }
+    Run(iterations, &point_indices);
+}
+
+void TaubinSmoothing::Iterate(const Adjacency& adj)
+{
+    Umbrella(adj, lambda);
+    Umbrella(adj, -(lambda+micro));
 }
@@ -29,8 +29,6 @@
 namespace MeshCore
 {
 class MeshKernel;
-class MeshRefPointToPoints;
-class MeshRefPointToFacets;
 
 /** Base class for smoothing algorithms. */
 class MeshExport AbstractSmoothing
@@ -73,6 +71,15 @@ public:
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
 };
 
+/**
+ * Laplacian (umbrella operator) smoothing.
+ * The vertex adjacency is built once in compressed row format and the
+ * coordinates are copied into separate x, y and z arrays. Each step computes
+ * the new positions of all points from the positions of the previous step
+ * (Jacobi iteration), so that the points can be processed in parallel.
+ * Border points, points with less than three neighbours and fixed points are
+ * not moved.
+ */
 class MeshExport LaplaceSmoothing : public AbstractSmoothing
 {
 public:
@@ -81,16 +88,40 @@ public:
     void Smooth(unsigned int);
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
     void SetLambda(double l) { lambda = l;}
+    /// Points that must keep their position
+    void SetFixedPoints(const std::vector<unsigned long>& points) { fixedPoints = points; }
+    /// Elapsed time in milliseconds of each step of the last call of Smooth() or SmoothPoints()
+    const std::vector<int>& GetIterationTimes() const { return iterationTimes; }
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double,
-                  const std::vector<unsigned long>&);
+    /** The neighbours of point i are neighbours[offsets[i]] ... neighbours[offsets[i+1]-1].
+     * Points that must not be moved have no neighbours.
+     */
+    struct Adjacency
+    {
+        std::vector<unsigned long> offsets;
+        std::vector<unsigned long> neighbours;
+    };
+    struct Range
+    {
+        unsigned long begin, end;
+    };
+
+    void BuildAdjacency(Adjacency&, const std::vector<unsigned long>* point_indices) const;
+    void LoadPoints();
+    void StorePoints();
+    void Umbrella(const Adjacency&, double);
+    void UmbrellaRange(const Adjacency&, double, const Range&);
+    void Run(unsigned int, const std::vector<unsigned long>*);
+    virtual void Iterate(const Adjacency&);
 
 protected:
     double lambda;
+    std::vector<unsigned long> fixedPoints;
+    std::vector<int> iterationTimes;
+    std::vector<Range> ranges;
+    std::vector<float> coords[3];   // current positions
+    std::vector<float> buffer[3];   // positions of the next step
 };
 
 class MeshExport TaubinSmoothing : public LaplaceSmoothing
@@ -102,6 +133,9 @@ public:
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
     void SetMicro(double m) { micro = m;}
 
+protected:
+    void Iterate(const Adjacency&);
+
 protected:
     double micro;
 };
@@ -127,6 +127,7 @@ bool MeshTopoAlgorithm::SnapVertex(unsigned long ulFacetPos, const Base::Vector3
       }
       else if ( (rP - rPt1)*cNo2 > 0.0f && fD2 >= fTV && fTV >= 0.0f )
       {
+        unsigned long uPtCnt = _rclMesh.CountPoints();
         MeshFacet cTria;
         cTria._aulPoints[0] = this->GetOrAddIndex(rP);
         cTria._aulPoints[1] = rFace._aulPoints[(i+1)%3];
@@ -134,6 +135,11 @@ bool MeshTopoAlgorithm::SnapVertex(unsigned long ulFacetPos, const Base::Vector3
         cTria._aulNeighbours[1] = ulFacetPos;
         rFace._aulNeighbours[i] = _rclMesh.CountFacets();
         _rclMesh._aclFacetArray.push_back(cTria);
+
+        // the snapped point is already part of the mesh so that the other
+        // edges of the new facet may be shared with existing facets
+        if (cTria._aulPoints[0] < uPtCnt)
+          _rclMesh.RebuildNeighbours(std::vector<unsigned long>(1, _rclMesh.CountFacets()-1));
         return true;
       }
     }
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#endif
+
+#include <Base/Tools.h>
+
+#include "FeatureMeshDecimation.h"
+
+namespace Mesh {
+    const App::PropertyQuantityConstraint::Constraints angleRange = {0.0,180.0,1.0};
+}
+
+using namespace Mesh;
+
+
+//===========================================================================
+// Decimation Feature
+//===========================================================================
+
+PROPERTY_SOURCE(Mesh::Decimation, Mesh::Feature)
+
+Decimation::Decimation()
+{
+    ADD_PROPERTY_TYPE(Source,(0),"Decimation",App::Prop_None,"The mesh to simplify");
+    ADD_PROPERTY_TYPE(Reduction,(50),"Decimation",App::Prop_None,
+                      "Percentage of facets to remove");
+    ADD_PROPERTY_TYPE(Tolerance,(0.0),"Decimation",App::Prop_None,
+                      "Maximum error of a collapse, 0 means no limit");
+    ADD_PROPERTY_TYPE(FeatureAngle,(0.0),"Decimation",App::Prop_None,
+                      "Edges with a larger angle between their facets are preserved, 0 disables it");
+    FeatureAngle.setConstraints(&angleRange);
+}
+
+Decimation::~Decimation()
+{
+}
+
+short Decimation::mustExecute() const
+{
+    if (Source.isTouched() ||
+        Reduction.isTouched() ||
+        Tolerance.isTouched() ||
+        FeatureAngle.isTouched())
+        return 1;
+    return 0;
+}
+
+App::DocumentObjectExecReturn *Decimation::execute(void)
+{
+    App::DocumentObject* link = Source.getValue();
+    if (!link) return new App::DocumentObjectExecReturn("No mesh linked");
+    App::Property* prop = link->getPropertyByName("Mesh");
+    if (prop && prop->getTypeId() == Mesh::PropertyMeshKernel::getClassTypeId()) {
+        if (Reduction.getValue() >= 100 && Tolerance.getValue() <= 0.0)
+            return new App::DocumentObjectExecReturn("A reduction of 100% needs a tolerance");
+        Mesh::PropertyMeshKernel* kernel = static_cast<Mesh::PropertyMeshKernel*>(prop);
+        std::unique_ptr<MeshObject> mesh(new MeshObject);
+        *mesh = kernel->getValue();
+        mesh->decimate(static_cast<float>(Tolerance.getValue()),
+                       static_cast<float>(Reduction.getValue()) / 100.0f,
+                       static_cast<float>(Base::toRadians<double>(FeatureAngle.getValue())));
+        this->Mesh.setValuePtr(mesh.release());
+    }
+
+    return App::DocumentObject::StdReturn;
+}
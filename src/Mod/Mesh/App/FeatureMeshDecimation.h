@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_FEATURE_MESH_DECIMATION_H
+#define MESH_FEATURE_MESH_DECIMATION_H
+
+#include <App/PropertyStandard.h>
+#include <App/PropertyLinks.h>
+#include <App/PropertyUnits.h>
+#include "MeshFeature.h"
+
+namespace Mesh
+{
+
+/**
+ * The Decimation class reduces the number of facets of the attached mesh with
+ * quadric error metrics, see MeshObject::decimate().
+ */
+class MeshExport Decimation : public Mesh::Feature
+{
+  PROPERTY_HEADER(Mesh::Decimation);
+
+public:
+  /// Constructor
+  Decimation(void);
+  virtual ~Decimation();
+
+  /** @name Properties */
+  //@{
+  App::PropertyLink     Source;
+  App::PropertyPercent  Reduction;
+  App::PropertyFloat    Tolerance;
+  App::PropertyAngle    FeatureAngle;
+  //@}
+
+  /** @name methods override Feature */
+  //@{
+  /// recalculate the Feature
+  virtual App::DocumentObjectExecReturn *execute(void);
+  short mustExecute() const;
+  //@}
+};
+
+}
+
+#endif // MESH_FEATURE_MESH_DECIMATION_H
@@ -97,6 +97,11 @@ App::DocumentObjectExecReturn *SetOperations::execute(void)
         MeshCore::SetOperations setOp(meshKernel1.getKernel(), meshKernel2.getKernel(), 
             pcKernel->getKernel(), type, 1.0e-5f);
         setOp.Do();
+
+        const MeshCore::SetOperations::Timing& timing = setOp.GetTiming();
+        Base::Console().Log("%s: %s took %d ms (cut: %d ms, triangulate: %d ms, collect: %d ms)\n",
+            getNameInDocument(), ot.c_str(), timing.total, timing.cut, timing.triangulate, timing.collect);
+
         Mesh.setValuePtr(pcKernel.release());
     }
     else { 
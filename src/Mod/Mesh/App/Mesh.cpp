@@ -39,6 +39,7 @@
 #include <Base/ViewProj.h>
 
 #include "Core/Builder.h"
+#include "Core/Decimation.h"
 #include "Core/MeshKernel.h"
 #include "Core/Grid.h"
 #include "Core/Iterator.h"
@@ -1112,6 +1113,46 @@ void MeshObject::refine()
     this->_segments.clear();
 }
 
+void MeshObject::decimate(float fTolerance, float fReduction, float fFeatureAngle)
+{
+    // without a target size the tolerance is the only stop criterion
+    if (fReduction >= 1.0f && fTolerance <= 0.0f)
+        throw Base::ValueError("Decimation needs a tolerance if all facets may be removed");
+
+    float count = static_cast<float>(_kernel.CountFacets());
+    fReduction = std::max<float>(0.0f, std::min<float>(fReduction, 1.0f));
+    unsigned long targetSize = 0;
+    if (fReduction < 1.0f)
+        targetSize = std::max<unsigned long>(1, static_cast<unsigned long>(count * (1.0f - fReduction)));
+
+    MeshCore::MeshDecimation dm(_kernel);
+    dm.SetTargetSize(targetSize);
+    dm.SetTolerance(fTolerance);
+    dm.SetFeatureAngle(fFeatureAngle);
+    dm.Simplify();
+    Base::Console().Log("Decimation: %lu collapses in %d ms, max. error %f\n",
+        dm.CountCollapses(), dm.GetElapsedTime(), dm.GetMaxError());
+
+    // clear the segments because we don't know how the new
+    // topology looks like
+    this->_segments.clear();
+}
+
+void MeshObject::decimateToSize(unsigned long targetSize, float fFeatureAngle)
+{
+    if (targetSize == 0)
+        throw Base::ValueError("Decimation needs a target size greater than zero");
+
+    MeshCore::MeshDecimation dm(_kernel);
+    dm.SetTargetSize(targetSize);
+    dm.SetFeatureAngle(fFeatureAngle);
+    dm.Simplify();
+    Base::Console().Log("Decimation: %lu collapses in %d ms, max. error %f\n",
+        dm.CountCollapses(), dm.GetElapsedTime(), dm.GetMaxError());
+
+    this->_segments.clear();
+}
+
 void MeshObject::optimizeTopology(float fMaxAngle)
 {
     MeshCore::MeshTopoAlgorithm topalg(_kernel);
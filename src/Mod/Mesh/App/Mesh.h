@@ -251,6 +251,15 @@ public:
     /** @name Topological operations */
     //@{
     void refine();
+    /** Reduces the number of facets by edge collapses using quadric error metrics.
+     * At most the fraction \a fReduction of the facets is removed, and no collapse
+     * with an error above \a fTolerance is done unless it is 0. Edges whose facets
+     * enclose an angle above \a fFeatureAngle (in radian) are preserved as well as
+     * the borders. A Base::ValueError is thrown if neither limit is set.
+     */
+    void decimate(float fTolerance, float fReduction, float fFeatureAngle = 0.0f);
+    /** Reduces the number of facets to \a targetSize. */
+    void decimateToSize(unsigned long targetSize, float fFeatureAngle = 0.0f);
     void optimizeTopology(float);
     void optimizeEdges();
     void splitEdges();
@@ -28,6 +28,9 @@
 #include <Base/Builder3D.h>
 #include <Base/GeometryPyCXX.h>
 #include <Base/MatrixPy.h>
+#include <Base/Interpreter.h>
+#include <Base/BatchTransform.h>
+#include <Base/BufferProtocol.h>
 
 #include "Mesh.h"
 #include "MeshPy.h"
@@ -44,6 +47,7 @@
 #include "Core/MeshKernel.h"
 #include "Core/Segmentation.h"
 #include "Core/Curvature.h"
+#include "Core/Registration.h"
 
 using namespace Mesh;
 
@@ -384,7 +388,11 @@ PyObject*  MeshPy::crossSections(PyObject *args)
     }
 
     std::vector<MeshObject::TPolylines> sections;
-    getMeshObjectPtr()->crossSections(csPlanes, sections, min_eps, PyObject_IsTrue(poly) ? true : false);
+    bool polylines = PyObject_IsTrue(poly) ? true : false;
+    {
+        Base::PyGILStateRelease unlock;
+        getMeshObjectPtr()->crossSections(csPlanes, sections, min_eps, polylines);
+    }
 
     // convert to Python objects
     Py::List crossSections;
@@ -413,7 +421,11 @@ PyObject*  MeshPy::unite(PyObject *args)
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->unite(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh;
+        {
+            Base::PyGILStateRelease unlock;
+            mesh = getMeshObjectPtr()->unite(*pcObject->getMeshObjectPtr());
+        }
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -430,7 +442,11 @@ PyObject*  MeshPy::intersect(PyObject *args)
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->intersect(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh;
+        {
+            Base::PyGILStateRelease unlock;
+            mesh = getMeshObjectPtr()->intersect(*pcObject->getMeshObjectPtr());
+        }
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -447,7 +463,11 @@ PyObject*  MeshPy::difference(PyObject *args)
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->subtract(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh;
+        {
+            Base::PyGILStateRelease unlock;
+            mesh = getMeshObjectPtr()->subtract(*pcObject->getMeshObjectPtr());
+        }
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -464,7 +484,11 @@ PyObject*  MeshPy::inner(PyObject *args)
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->inner(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh;
+        {
+            Base::PyGILStateRelease unlock;
+            mesh = getMeshObjectPtr()->inner(*pcObject->getMeshObjectPtr());
+        }
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -481,7 +505,11 @@ PyObject*  MeshPy::outer(PyObject *args)
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->outer(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh;
+        {
+            Base::PyGILStateRelease unlock;
+            mesh = getMeshObjectPtr()->outer(*pcObject->getMeshObjectPtr());
+        }
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -792,6 +820,173 @@ PyObject*  MeshPy::getPointNormals(PyObject *args)
     } PY_CATCH;
 }
 
+PyObject* MeshPy::getPointArray(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+
+    PY_TRY {
+        const MeshCore::MeshPointArray& points = getMeshObjectPtr()->getKernel().GetPoints();
+        double* data;
+        Py::Object bytes(Base::BufferProtocol::createArray(3 * points.size(), data), true);
+        double* ptr = data;
+        for (MeshCore::MeshPointArray::_TConstIterator it = points.begin(); it != points.end(); ++it) {
+            *ptr++ = it->x;
+            *ptr++ = it->y;
+            *ptr++ = it->z;
+        }
+
+        Base::BatchTransform(getMeshObjectPtr()->getTransform()).apply(data, points.size());
+        return Py::new_reference_to(bytes);
+    } PY_CATCH;
+}
+
+PyObject* MeshPy::getFacetArray(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+
+    PY_TRY {
+        const MeshCore::MeshFacetArray& facets = getMeshObjectPtr()->getKernel().GetFacets();
+        uint32_t* data;
+        Py::Object bytes(Base::BufferProtocol::createArray(3 * facets.size(), data), true);
+        for (MeshCore::MeshFacetArray::_TConstIterator it = facets.begin(); it != facets.end(); ++it) {
+            *data++ = it->_aulPoints[0];
+            *data++ = it->_aulPoints[1];
+            *data++ = it->_aulPoints[2];
+        }
+
+        return Py::new_reference_to(bytes);
+    } PY_CATCH;
+}
+
+PyObject* MeshPy::setArrays(PyObject *args)
+{
+    PyObject *pts, *fts;
+    if (!PyArg_ParseTuple(args, "OO", &pts, &fts))
+        return NULL;
+
+    PY_TRY {
+        std::vector<double> coords;
+        std::vector<unsigned long> indices;
+        Base::BufferProtocol::getDoubles(pts, 3, coords);
+        Base::BufferProtocol::getIndices(fts, 3, indices);
+
+        std::size_t numPoints = coords.size() / 3;
+        for (std::vector<unsigned long>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
+            if (*it >= numPoints)
+                throw Base::ValueError("Point index out of range");
+        }
+
+        // the mesh keeps its points in local coordinates
+        Base::Matrix4D mat = getMeshObjectPtr()->getTransform();
+        mat.inverse();
+        if (!coords.empty())
+            Base::BatchTransform(mat).apply(&coords[0], numPoints);
+
+        MeshCore::MeshPointArray points;
+        points.reserve(numPoints);
+        for (std::size_t i = 0; i < numPoints; i++)
+            points.push_back(Base::Vector3f((float)coords[3*i], (float)coords[3*i+1], (float)coords[3*i+2]));
+
+        MeshCore::MeshFacetArray facets;
+        facets.reserve(indices.size() / 3);
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            MeshCore::MeshFacet face;
+            face._aulPoints[0] = indices[i];
+            face._aulPoints[1] = indices[i+1];
+            face._aulPoints[2] = indices[i+2];
+            facets.push_back(face);
+        }
+
+        MeshPropertyLock lock(this->parentProperty);
+        MeshCore::MeshKernel kernel;
+        kernel.Adopt(points, facets, true);
+        getMeshObjectPtr()->swap(kernel);
+    } PY_CATCH;
+
+    Py_Return;
+}
+
+PyObject* MeshPy::alignPoints(PyObject *args)
+{
+    PyObject *obj;
+    PyObject *coarse=Py_False;
+    int iterations=50;
+    float tolerance=1.0e-4f, trim=0.9f, maxDistance=0.0f;
+    if (!PyArg_ParseTuple(args, "O|Oifff", &obj, &coarse,
+                          &iterations, &tolerance, &trim, &maxDistance))
+        return NULL;
+    bool coarseAlign = PyObject_IsTrue(coarse) ? true : false;
+
+    PY_TRY {
+        // the points in global coordinates
+        std::vector<Base::Vector3f> points;
+        if (PyObject_TypeCheck(obj, &(MeshPy::Type))) {
+            const MeshObject* mesh = static_cast<MeshPy*>(obj)->getMeshObjectPtr();
+            const MeshCore::MeshPointArray& pts = mesh->getKernel().GetPoints();
+            Base::Matrix4D mat = mesh->getTransform();
+            points.reserve(pts.size());
+            for (MeshCore::MeshPointArray::_TConstIterator it = pts.begin(); it != pts.end(); ++it)
+                points.push_back(mat * (*it));
+        }
+        else if (PyObject_CheckBuffer(obj) && !PyBytes_Check(obj)) {
+            std::vector<double> coords;
+            Base::BufferProtocol::getDoubles(obj, 3, coords);
+            points.reserve(coords.size() / 3);
+            for (std::size_t i = 0; i < coords.size(); i += 3)
+                points.push_back(Base::Vector3f((float)coords[i], (float)coords[i+1], (float)coords[i+2]));
+        }
+        else {
+            Py::Sequence list(obj);
+            points.reserve(list.size());
+            for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                Base::Vector3d pnt = Py::Vector(*it).toVector();
+                points.push_back(Base::convertTo<Base::Vector3f>(pnt));
+            }
+        }
+
+        // the registration works in the local system of the mesh
+        Base::Matrix4D trf = getMeshObjectPtr()->getTransform();
+        Base::Matrix4D inv = trf;
+        inv.inverse();
+        for (std::vector<Base::Vector3f>::iterator it = points.begin(); it != points.end(); ++it)
+            *it = inv * (*it);
+
+        Base::Matrix4D mat;
+        bool converged;
+        MeshCore::MeshRegistration reg(getMeshObjectPtr()->getKernel());
+        reg.SetMaxIterations(iterations);
+        reg.SetTolerance(tolerance);
+        reg.SetTrimRatio(trim);
+        reg.SetMaxDistance(maxDistance);
+        {
+            Base::PyGILStateRelease unlock;
+            if (coarseAlign)
+                mat = reg.CoarseAlignment(points, mat);
+            converged = reg.Align(points, mat);
+        }
+
+        Py::List rms, pairs, rotation, translation;
+        const std::vector<MeshCore::MeshRegistration::Iteration>& info = reg.GetIterations();
+        for (std::vector<MeshCore::MeshRegistration::Iteration>::const_iterator it = info.begin(); it != info.end(); ++it) {
+            rms.append(Py::Float(it->rms));
+            pairs.append(Py::Long(it->pairs));
+            rotation.append(Py::Float(it->rotation));
+            translation.append(Py::Float(it->translation));
+        }
+
+        Py::Dict dict;
+        dict.setItem(Py::String("Matrix"), Py::Matrix(trf * mat * inv));
+        dict.setItem(Py::String("Converged"), Py::Boolean(converged));
+        dict.setItem(Py::String("RMS"), rms);
+        dict.setItem(Py::String("Pairs"), pairs);
+        dict.setItem(Py::String("Rotation"), rotation);
+        dict.setItem(Py::String("Translation"), translation);
+        return Py::new_reference_to(dict);
+    } PY_CATCH;
+}
+
 PyObject* MeshPy::countSegments(PyObject *args)
 {
     if (!PyArg_ParseTuple(args, ""))
@@ -964,6 +1159,7 @@ PyObject*  MeshPy::fixSelfIntersections(PyObject *args)
     if (!PyArg_ParseTuple(args, ""))
         return NULL;
     try {
+        Base::PyGILStateRelease unlock;
         getMeshObjectPtr()->removeSelfIntersections();
     }
     catch (const Base::Exception& e) {
@@ -978,6 +1174,7 @@ PyObject*  MeshPy::removeFoldsOnSurface(PyObject *args)
     if (!PyArg_ParseTuple(args, ""))
         return NULL;
     try {
+        Base::PyGILStateRelease unlock;
         getMeshObjectPtr()->removeFoldsOnSurface();
     }
     catch (const Base::Exception& e) {
@@ -1061,6 +1258,7 @@ PyObject*  MeshPy::harmonizeNormals(PyObject *args)
 
     PY_TRY {
         MeshPropertyLock lock(this->parentProperty);
+        Base::PyGILStateRelease unlock;
         getMeshObjectPtr()->harmonizeNormals();
     } PY_CATCH;
 
@@ -1189,12 +1387,52 @@ PyObject*  MeshPy::refine(PyObject *args)
         return NULL;
 
     PY_TRY {
+        Base::PyGILStateRelease unlock;
         getMeshObjectPtr()->refine();
     } PY_CATCH;
 
     Py_Return; 
 }
 
+PyObject*  MeshPy::decimate(PyObject *args)
+{
+    int targetSize;
+    if (PyArg_ParseTuple(args, "i", &targetSize)) {
+        if (targetSize <= 0) {
+            PyErr_SetString(PyExc_ValueError, "Target size must be positive");
+            return 0;
+        }
+
+        PY_TRY {
+            MeshPropertyLock lock(this->parentProperty);
+            Base::PyGILStateRelease unlock;
+            getMeshObjectPtr()->decimateToSize(static_cast<unsigned long>(targetSize));
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
+    PyErr_Clear();
+    float fTolerance, fReduction, fFeatureAngle=0.0f;
+    if (PyArg_ParseTuple(args, "ff|f", &fTolerance, &fReduction, &fFeatureAngle)) {
+        if (fReduction >= 1.0f && fTolerance <= 0.0f) {
+            PyErr_SetString(PyExc_ValueError, "A reduction of 1 needs a positive tolerance");
+            return 0;
+        }
+
+        PY_TRY {
+            MeshPropertyLock lock(this->parentProperty);
+            Base::PyGILStateRelease unlock;
+            getMeshObjectPtr()->decimate(fTolerance, fReduction, fFeatureAngle);
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
+    PyErr_SetString(PyExc_TypeError, "decimate(targetSize) or decimate(tolerance, reduction, [featureAngle])");
+    return 0;
+}
+
 PyObject*  MeshPy::optimizeTopology(PyObject *args)
 {
     float fMaxAngle=-1.0f;
@@ -1203,6 +1441,7 @@ PyObject*  MeshPy::optimizeTopology(PyObject *args)
 
     PY_TRY {
         MeshPropertyLock lock(this->parentProperty);
+        Base::PyGILStateRelease unlock;
         getMeshObjectPtr()->optimizeTopology(fMaxAngle);
     } PY_CATCH;
 
@@ -1575,6 +1814,7 @@ PyObject*  MeshPy::smooth(PyObject *args)
 
     PY_TRY {
         MeshPropertyLock lock(this->parentProperty);
+        Base::PyGILStateRelease unlock;
         getMeshObjectPtr()->smooth(iter, d_max);
     } PY_CATCH;
 
@@ -1,7 +1,7 @@
 #   (c) Juergen Riegel (juergen.riegel@web.de) 2007      LGPL
 
 import FreeCAD, os, sys, unittest, Mesh
-import thread, time, tempfile, math
+import thread, time, tempfile, math, struct
 
 
 #---------------------------------------------------------------------------
@@ -36,6 +36,14 @@ class MeshTopoTestCases(unittest.TestCase):
 		planarMeshObject = Mesh.Mesh(self.planarMesh)
 		planarMeshObject.collapseFacets(range(18))
 
+	def testSnapVertexToExistingPoint(self):
+		# a fan of three facets around the origin with a missing sector
+		fan = [[0,0,0],[1,0,0],[0,1,0], [0,0,0],[0,1,0],[-1,0,0], [0,0,0],[-1,0,0],[0,-1,0]]
+		fanMeshObject = Mesh.Mesh(fan)
+		fanMeshObject.snapVertex(2, FreeCAD.Vector(1,0,0))
+		self.failUnless(fanMeshObject.CountFacets == 4, "Missing sector was not filled")
+		self.failUnless(3 in fanMeshObject.Facets[0].NeighbourIndices, "Facets are not connected")
+
 
 class MeshGeoTestCases(unittest.TestCase):
 	def setUp(self):
@@ -163,6 +171,113 @@ class LoadMeshInThreadsCases(unittest.TestCase):
         pass
 
 
+class MeshSTLReaderCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(10.0,50)
+
+    def checkReload(self, ext):
+        name = tempfile.gettempdir() + os.sep + "reload." + ext
+        self.mesh.write(name)
+        mesh = Mesh.Mesh(name)
+        os.remove(name)
+        self.failUnless(mesh.CountPoints == self.mesh.CountPoints, "Vertices are not welded")
+        self.failUnless(mesh.CountFacets == self.mesh.CountFacets, "Number of facets differs")
+        self.failUnless(mesh.isSolid(), "Neighbourhood is not set")
+        self.failIf(mesh.hasNonManifolds(), "Mesh has non-manifolds")
+        self.failUnless(mesh.countComponents() == 1, "Mesh is not connected")
+
+    def testBinarySTL(self):
+        self.checkReload("stl")
+
+    def testAsciiSTL(self):
+        self.checkReload("ast")
+
+    def testDegeneratedFacet(self):
+        triangles = [FreeCAD.Vector(0,0,0), FreeCAD.Vector(1,0,0), FreeCAD.Vector(0,1,0),
+                     FreeCAD.Vector(1,0,0), FreeCAD.Vector(1,1,0), FreeCAD.Vector(0,1,0),
+                     FreeCAD.Vector(2,0,0), FreeCAD.Vector(2,0,0), FreeCAD.Vector(3,0,0)]
+        name = tempfile.gettempdir() + os.sep + "degenerated.stl"
+        f = open(name, "wb")
+        f.write(struct.pack("<80sI", "", 3))
+        for i in range(3):
+            f.write(struct.pack("<3f", 0, 0, 1))
+            for v in triangles[3*i:3*i+3]:
+                f.write(struct.pack("<3f", v.x, v.y, v.z))
+            f.write(struct.pack("<H", 0))
+        f.close()
+        mesh = Mesh.Mesh(name)
+        os.remove(name)
+        self.failUnless(mesh.CountFacets == 2, "Degenerated facet was not removed")
+        self.failUnless(mesh.CountPoints == 4, "Unreferenced points were not removed")
+        self.failUnless(1 in mesh.Facets[0].NeighbourIndices, "Facets are not connected")
+
+    def tearDown(self):
+        pass
+
+
+class MeshSetOperationsCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh1 = Mesh.createSphere(10.0,50)
+        self.mesh2 = Mesh.createSphere(10.0,50)
+        self.mesh2.translate(8,3,2)
+
+    def testUnion(self):
+        res = self.mesh1.unite(self.mesh2)
+        self.failUnless(res.CountFacets > 0, "Union is empty")
+        self.failUnless(res.Area < self.mesh1.Area + self.mesh2.Area, "Union is too big")
+
+    def testIntersection(self):
+        res = self.mesh1.intersect(self.mesh2)
+        self.failUnless(res.CountFacets > 0, "Intersection is empty")
+        self.failUnless(res.Area < self.mesh1.Area, "Intersection is too big")
+
+    def testDeterministic(self):
+        # the cut is computed in several threads, the result must not depend on it
+        res1 = self.mesh1.difference(self.mesh2)
+        res2 = self.mesh1.difference(self.mesh2)
+        self.failUnless(res1.Topology == res2.Topology, "Results of the same operation differ")
+
+    def tearDown(self):
+        pass
+
+
+class MeshSmoothingCases(unittest.TestCase):
+    def setUp(self):
+        # a bumpy open grid
+        triangles = []
+        for i in range(8):
+            for j in range(8):
+                p1 = FreeCAD.Vector(i,   j,   ((i*7+j*3)%5)*0.1)
+                p2 = FreeCAD.Vector(i+1, j,   (((i+1)*7+j*3)%5)*0.1)
+                p3 = FreeCAD.Vector(i+1, j+1, (((i+1)*7+(j+1)*3)%5)*0.1)
+                p4 = FreeCAD.Vector(i,   j+1, ((i*7+(j+1)*3)%5)*0.1)
+                triangles += [p1,p2,p3, p1,p3,p4]
+        self.mesh = Mesh.Mesh(triangles)
+
+    def testSmoothSphere(self):
+        mesh = Mesh.createSphere(10.0,50)
+        area = mesh.Area
+        count = mesh.CountFacets
+        mesh.smooth(10)
+        self.failUnless(mesh.CountFacets == count, "Smoothing must not change the topology")
+        self.failUnless(mesh.Area < area, "Laplace smoothing must shrink a sphere")
+
+    def testBorderPointsFixed(self):
+        before = [(p.x,p.y,p.z) for p in self.mesh.Points]
+        self.mesh.smooth(5)
+        after = [(p.x,p.y,p.z) for p in self.mesh.Points]
+        moved = False
+        for (b,a) in zip(before, after):
+            if b[0] in (0,8) or b[1] in (0,8):
+                self.failUnless(b == a, "Border point %s was moved" % (b,))
+            elif b != a:
+                moved = True
+        self.failUnless(moved, "No inner point was moved")
+
+    def tearDown(self):
+        pass
+
+
 class PolynomialFitCases(unittest.TestCase):
     def setUp(self):
         pass
@@ -220,3 +335,124 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+class MeshArrayCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.Mesh([[0,0,0],[1,0,0],[0,1,0], [1,0,0],[1,1,0],[0,1,0]])
+        self.mesh.Placement.Base = FreeCAD.Vector(0,0,5)
+
+    def testGetArrays(self):
+        pts = self.mesh.getPointArray()
+        fcs = self.mesh.getFacetArray()
+        self.assertEqual(len(pts), 8 * 3 * self.mesh.CountPoints)
+        self.assertEqual(len(fcs), 4 * 3 * self.mesh.CountFacets)
+        coords = struct.unpack("%dd" % (3 * self.mesh.CountPoints), pts)
+        for i, p in enumerate(self.mesh.Points):
+            self.assertEqual(coords[3*i:3*i+3], (p.x, p.y, p.z))
+        indices = struct.unpack("%dI" % (3 * self.mesh.CountFacets), fcs)
+        for i, f in enumerate(self.mesh.Facets):
+            self.assertEqual(indices[3*i:3*i+3], f.PointIndices)
+
+    def testSetArrays(self):
+        try:
+            import numpy
+        except ImportError:
+            self.skipTest("NumPy is not available")
+        pts = numpy.frombuffer(self.mesh.getPointArray()).reshape(-1,3)
+        fcs = numpy.frombuffer(self.mesh.getFacetArray(), numpy.uint32).reshape(-1,3)
+        other = Mesh.Mesh()
+        other.setArrays(pts, fcs)
+        self.assertEqual(other.CountPoints, self.mesh.CountPoints)
+        self.assertEqual(other.CountFacets, self.mesh.CountFacets)
+        self.assertTrue(other.BoundBox.isInside(self.mesh.BoundBox.Center))
+        self.assertRaises(Exception, other.setArrays, pts, fcs + 10)
+
+class MeshRegistrationCases(unittest.TestCase):
+    def setUp(self):
+        import random
+        random.seed(1)
+        self.nominal = Mesh.createBox(10,20,30)
+        # synthetic scan with noise and some outliers
+        self.scan = []
+        for f in self.nominal.Facets:
+            p0, p1, p2 = [FreeCAD.Vector(*p) for p in f.Points]
+            n = FreeCAD.Vector(*f.Normal)
+            for i in range(100):
+                a = random.random()
+                b = random.random()
+                if a + b > 1:
+                    a, b = 1 - a, 1 - b
+                p = p0 + (p1 - p0) * a + (p2 - p0) * b + n * (0.02 * (random.random() - 0.5))
+                if random.random() < 0.05:
+                    p = p + FreeCAD.Vector(random.random(), random.random(), random.random()) * 5
+                self.scan.append(p)
+
+    def perturb(self, angle, move):
+        mat = FreeCAD.Matrix()
+        mat.rotateZ(angle)
+        mat.rotateX(angle / 2)
+        mat.move(move)
+        return mat, [mat.multiply(p) for p in self.scan]
+
+    def testAlignPoints(self):
+        mat, points = self.perturb(0.1, FreeCAD.Vector(1,0.5,-0.5))
+        result = self.nominal.alignPoints(points)
+        self.assertTrue(result["Converged"])
+        self.assertTrue(result["RMS"][-1] < 0.05)
+        res = result["Matrix"].multiply(mat)
+        for a, b in zip(res.A, FreeCAD.Matrix().A):
+            self.assertAlmostEqual(a, b, 2)
+
+    def testCoarseAlignment(self):
+        mat, points = self.perturb(2.0, FreeCAD.Vector(20,-10,5))
+        result = self.nominal.alignPoints(points, True)
+        self.assertTrue(result["Converged"])
+        # because of the symmetry of the box the matrix isn't unique
+        self.assertTrue(result["RMS"][-1] < 0.05)
+
+class MeshDecimationCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(10.0, 100)
+
+    def checkRadius(self, mesh, eps):
+        for p in mesh.Points:
+            self.assertTrue(abs(FreeCAD.Vector(p.x,p.y,p.z).Length - 10.0) < eps)
+
+    def testTargetSize(self):
+        count = self.mesh.CountFacets
+        self.mesh.decimate(count // 10)
+        self.assertTrue(self.mesh.CountFacets <= count // 10)
+        self.assertTrue(self.mesh.CountFacets > count // 20)
+        self.assertTrue(self.mesh.isSolid())
+        self.assertFalse(self.mesh.hasNonManifolds())
+        self.checkRadius(self.mesh, 0.5)
+
+    def testTolerance(self):
+        count = self.mesh.CountFacets
+        self.mesh.decimate(0.01, 1.0)
+        self.assertTrue(self.mesh.CountFacets < count)
+        self.assertTrue(self.mesh.isSolid())
+        self.checkRadius(self.mesh, 0.05)
+
+    def testBorderKept(self):
+        triangles = []
+        for i in range(20):
+            for j in range(20):
+                p1 = FreeCAD.Vector(i, j, 0)
+                p2 = FreeCAD.Vector(i + 1, j, 0)
+                p3 = FreeCAD.Vector(i + 1, j + 1, 0)
+                p4 = FreeCAD.Vector(i, j + 1, 0)
+                triangles += [p1, p2, p3, p1, p3, p4]
+        planar = Mesh.Mesh(triangles)
+        box = planar.BoundBox
+        planar.decimate(0.01, 1.0)
+        self.assertTrue(planar.CountFacets < 10)
+        self.assertAlmostEqual(planar.BoundBox.XLength, box.XLength, 4)
+        self.assertAlmostEqual(planar.BoundBox.YLength, box.YLength, 4)
+        self.assertAlmostEqual(planar.BoundBox.ZLength, 0.0, 4)
+
+    def testInvalidArguments(self):
+        self.assertRaises(ValueError, self.mesh.decimate, -1)
+        self.assertRaises(ValueError, self.mesh.decimate, 0)
+        self.assertRaises(ValueError, self.mesh.decimate, 0.0, 1.0)
+        self.assertRaises(TypeError, self.mesh.decimate, 0.5)
@@ -39,11 +39,27 @@
 # include <Inventor/actions/SoGetBoundingBoxAction.h>
 # include <Inventor/actions/SoGetPrimitiveCountAction.h>
 # include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/SoPickedPoint.h>
 # include <Inventor/actions/SoPickAction.h>
+# include <Inventor/actions/SoRayPickAction.h>
 # include <Inventor/actions/SoWriteAction.h>
 # include <Inventor/details/SoFaceDetail.h>
+# include <Inventor/details/SoPointDetail.h>
 # include <Inventor/errors/SoReadError.h>
 # include <Inventor/misc/SoState.h>
+# include <Inventor/elements/SoGLCacheContextElement.h>
+#endif
+
+#include <Inventor/C/glue/gl.h>
+#include <QFuture>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#ifndef GL_ARRAY_BUFFER
+# define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+# define GL_STATIC_DRAW 0x88E4
 #endif
 
 #include "SoFCMeshObject.h"
@@ -591,16 +607,28 @@ void SoFCMeshObjectShape::initClass()
 SoFCMeshObjectShape::SoFCMeshObjectShape()
     : renderTriangleLimit(100000)
     , meshChanged(true)
+    , bufferMesh(0)
+    , bufferNodeId(0)
+    , bufferCcw(true)
+    , pickTreeChanged(true)
+    , pickTreeMesh(0)
+    , pickTreeNodeId(0)
     , selectBuf(0)
 {
     SO_NODE_CONSTRUCTOR(SoFCMeshObjectShape);
     setName(SoFCMeshObjectShape::getClassTypeId().getName());
 }
 
+SoFCMeshObjectShape::~SoFCMeshObjectShape()
+{
+    releaseBuffers();
+}
+
 void SoFCMeshObjectShape::notify(SoNotList * node)
 {
     inherited::notify(node);
     meshChanged = true;
+    pickTreeChanged = true;
 }
 
 /**
@@ -633,7 +661,11 @@ void SoFCMeshObjectShape::GLRender(SoGLRenderAction *action)
         if (SoShapeHintsElement::getVertexOrdering(state) == SoShapeHintsElement::CLOCKWISE) 
             ccw = false;
 
-        if (mode == false || mesh->countFacets() <= this->renderTriangleLimit) {
+        if (mbind == OVERALL && drawFacesVBO(action, mesh, needNormals, ccw)) {
+            // the buffer object is fast enough to also render the complete mesh
+            // in interactive mode
+        }
+        else if (mode == false || mesh->countFacets() <= this->renderTriangleLimit) {
             if (mbind != OVERALL)
                 drawFaces(mesh, &mb, mbind, needNormals, ccw);
             else
@@ -758,6 +790,153 @@ void SoFCMeshObjectShape::drawFaces(const Mesh::MeshObject * mesh, SoMaterialBun
     }
 }
 
+/**
+ * Renders the triangles of the complete mesh from a vertex buffer object. The buffer is
+ * created for each OpenGL context the first time it is needed and kept until the mesh
+ * changes. Returns false if vertex buffer objects are not supported.
+ */
+bool SoFCMeshObjectShape::drawFacesVBO(SoGLRenderAction * action, const Mesh::MeshObject * mesh,
+                                       SbBool needNormals, SbBool ccw)
+{
+    if (mesh->countFacets() == 0)
+        return false;
+
+    uint32_t contextid = action->getCacheContext();
+    const cc_glglue * glue = cc_glglue_instance(static_cast<int>(contextid));
+    if (!cc_glglue_has_vertex_buffer_object(glue))
+        return false;
+
+    // the node id of the element changes whenever the mesh node gets modified
+    uint32_t nodeId = SoFCMeshObjectElement::getInstance(action->getState())->getNodeId();
+    if (meshChanged || bufferMesh != mesh || bufferNodeId != nodeId || bufferCcw != ccw) {
+        releaseBuffers();
+        meshChanged = false;
+        bufferMesh = mesh;
+        bufferNodeId = nodeId;
+        bufferCcw = ccw;
+    }
+
+    GLuint buffer = 0;
+    std::map<uint32_t, GLuint>::iterator it = vertexBuffers.find(contextid);
+    if (it == vertexBuffers.end()) {
+        if (vertexArray.empty())
+            generateVertexArray(mesh, ccw);
+
+        // clear old errors so that a failing upload can be detected
+        while (glGetError() != GL_NO_ERROR) {}
+        cc_glglue_glGenBuffers(glue, 1, &buffer);
+        cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, buffer);
+        cc_glglue_glBufferData(glue, GL_ARRAY_BUFFER, vertexArray.size() * sizeof(float),
+                               &(vertexArray[0]), GL_STATIC_DRAW);
+        if (glGetError() != GL_NO_ERROR) {
+            // probably out of memory, use the immediate mode for this context
+            cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, 0);
+            cc_glglue_glDeleteBuffers(glue, 1, &buffer);
+            buffer = 0;
+        }
+        vertexBuffers[contextid] = buffer;
+
+        // the copy in main memory is only needed again for another context
+        std::vector<float>().swap(vertexArray);
+    }
+    else {
+        buffer = it->second;
+        if (buffer)
+            cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, buffer);
+    }
+
+    if (!buffer)
+        return false;
+
+    // every corner consists of the normal followed by the point
+    const GLsizei stride = 6 * sizeof(float);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, reinterpret_cast<const GLvoid*>(3 * sizeof(float)));
+    if (needNormals) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, stride, 0);
+    }
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(3 * mesh->countFacets()));
+    glPopClientAttrib();
+    cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+/**
+ * Fills the vertex array with the normals and points of all triangles. The triangles are
+ * split into blocks that are processed in parallel.
+ */
+void SoFCMeshObjectShape::generateVertexArray(const Mesh::MeshObject * mesh, SbBool ccw)
+{
+    const unsigned long numFacets = mesh->countFacets();
+    vertexArray.resize(18 * numFacets);
+
+    const unsigned long blockSize = 65536;
+    std::vector<std::pair<unsigned long, unsigned long> > blocks;
+    for (unsigned long i = 0; i < numFacets; i += blockSize)
+        blocks.push_back(std::make_pair(i, std::min<unsigned long>(i + blockSize, numFacets)));
+
+    QFuture<void> future = QtConcurrent::map(blocks, boost::bind
+        (&SoFCMeshObjectShape::fillVertexArray, this, mesh, ccw, _1));
+    future.waitForFinished();
+}
+
+void SoFCMeshObjectShape::fillVertexArray(const Mesh::MeshObject * mesh, SbBool ccw,
+                                          const std::pair<unsigned long, unsigned long>& block)
+{
+    const MeshCore::MeshPointArray & rPoints = mesh->getKernel().GetPoints();
+    const MeshCore::MeshFacetArray & rFacets = mesh->getKernel().GetFacets();
+    const float sign = ccw ? 1.0f : -1.0f;
+
+    float* data = &(vertexArray[18 * block.first]);
+    for (unsigned long index = block.first; index < block.second; index++) {
+        const MeshCore::MeshFacet& face = rFacets[index];
+        const MeshCore::MeshPoint& v0 = rPoints[face._aulPoints[0]];
+        const MeshCore::MeshPoint& v1 = rPoints[face._aulPoints[1]];
+        const MeshCore::MeshPoint& v2 = rPoints[face._aulPoints[2]];
+
+        // Calculate the normal n = (v1-v0)x(v2-v0) the same way as drawFaces() does
+        float n[3];
+        n[0] = sign * ((v1.y-v0.y)*(v2.z-v0.z)-(v1.z-v0.z)*(v2.y-v0.y));
+        n[1] = sign * ((v1.z-v0.z)*(v2.x-v0.x)-(v1.x-v0.x)*(v2.z-v0.z));
+        n[2] = sign * ((v1.x-v0.x)*(v2.y-v0.y)-(v1.y-v0.y)*(v2.x-v0.x));
+
+        const MeshCore::MeshPoint* corner[3] = {&v0, &v1, &v2};
+        for (int i = 0; i < 3; i++) {
+            *data++ = n[0];
+            *data++ = n[1];
+            *data++ = n[2];
+            *data++ = corner[i]->x;
+            *data++ = corner[i]->y;
+            *data++ = corner[i]->z;
+        }
+    }
+}
+
+/**
+ * Schedules the deletion of the vertex buffer objects of all contexts. The buffers get deleted
+ * as soon as their context becomes current.
+ */
+void SoFCMeshObjectShape::releaseBuffers()
+{
+    for (std::map<uint32_t, GLuint>::iterator it = vertexBuffers.begin(); it != vertexBuffers.end(); ++it) {
+        if (it->second) {
+            SoGLCacheContextElement::scheduleDeleteCallback(it->first, deleteBuffer,
+                reinterpret_cast<void*>(static_cast<uintptr_t>(it->second)));
+        }
+    }
+    vertexBuffers.clear();
+    std::vector<float>().swap(vertexArray);
+}
+
+void SoFCMeshObjectShape::deleteBuffer(void * closure, uint32_t contextid)
+{
+    const cc_glglue * glue = cc_glglue_instance(static_cast<int>(contextid));
+    GLuint buffer = static_cast<GLuint>(reinterpret_cast<uintptr_t>(closure));
+    cc_glglue_glDeleteBuffers(glue, 1, &buffer);
+}
+
 /**
  * Renders the gravity points of a subset of triangles.
  */
@@ -983,7 +1162,79 @@ SoFCMeshObjectShape::rayPick(SoRayPickAction * action)
     //        this->generatePrimitives(action);
     //    }
     //}
-    inherited::rayPick(action);
+    if (!this->shouldRayPick(action))
+        return;
+
+    SoState* state = action->getState();
+    const Mesh::MeshObject* mesh = SoFCMeshObjectElement::get(state);
+    if (!mesh)
+        return;
+
+    // only the facets whose bounding box is hit by the ray are tested
+    uint32_t nodeId = SoFCMeshObjectElement::getInstance(state)->getNodeId();
+    if (pickTreeChanged || pickTreeMesh != mesh || pickTreeNodeId != nodeId) {
+        pickTreeChanged = false;
+        pickTreeMesh = mesh;
+        pickTreeNodeId = nodeId;
+        buildPickTree(mesh);
+    }
+
+    this->computeObjectSpaceRay(action);
+
+    std::vector<int> facets;
+    pickTree.intersect(action, facets);
+
+    const MeshCore::MeshPointArray & rPoints = mesh->getKernel().GetPoints();
+    const MeshCore::MeshFacetArray & rFacets = mesh->getKernel().GetFacets();
+    for (std::vector<int>::iterator it = facets.begin(); it != facets.end(); ++it) {
+        const MeshCore::MeshFacet& face = rFacets[*it];
+        SbVec3f v0 = sbvec3f(rPoints[face._aulPoints[0]]);
+        SbVec3f v1 = sbvec3f(rPoints[face._aulPoints[1]]);
+        SbVec3f v2 = sbvec3f(rPoints[face._aulPoints[2]]);
+
+        SbVec3f isect, bary;
+        SbBool front;
+        if (!action->intersect(v0, v1, v2, isect, bary, front) || !action->isBetweenPlanes(isect))
+            continue;
+
+        SoPickedPoint* pp = action->addIntersection(isect);
+        if (pp) {
+            SbVec3f normal = (v1 - v0).cross(v2 - v0);
+            normal.normalize();
+            pp->setObjectNormal(normal);
+
+            SoFaceDetail* detail = new SoFaceDetail();
+            detail->setFaceIndex(*it);
+            detail->setNumPoints(3);
+            SoPointDetail point;
+            for (int i = 0; i < 3; i++) {
+                point.setCoordinateIndex(face._aulPoints[i]);
+                detail->setPoint(i, &point);
+            }
+            pp->setDetail(detail, this);
+        }
+    }
+}
+
+/**
+ * Builds the tree of the bounding boxes of all facets.
+ */
+void SoFCMeshObjectShape::buildPickTree(const Mesh::MeshObject * mesh)
+{
+    const MeshCore::MeshPointArray & rPoints = mesh->getKernel().GetPoints();
+    const MeshCore::MeshFacetArray & rFacets = mesh->getKernel().GetFacets();
+
+    std::vector<SbBox3f> boxes;
+    boxes.reserve(rFacets.size());
+    for (MeshCore::MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
+        SbBox3f box;
+        box.extendBy(sbvec3f(rPoints[it->_aulPoints[0]]));
+        box.extendBy(sbvec3f(rPoints[it->_aulPoints[1]]));
+        box.extendBy(sbvec3f(rPoints[it->_aulPoints[2]]));
+        boxes.push_back(box);
+    }
+
+    pickTree.build(boxes);
 }
 
 /** Sets the point indices, the geometric points and the normal for each triangle.
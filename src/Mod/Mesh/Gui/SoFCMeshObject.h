@@ -23,6 +23,8 @@
 #ifndef MESHGUI_SOFCMESHOBJECT_H
 #define MESHGUI_SOFCMESHOBJECT_H
 
+#include <map>
+#include <vector>
 #include <Inventor/fields/SoSField.h>
 #include <Inventor/fields/SoSFUInt32.h>
 #include <Inventor/fields/SoSubField.h>
@@ -33,6 +35,7 @@
 #include <Inventor/elements/SoReplacedElement.h>
 #include <Mod/Mesh/App/Core/Elements.h>
 #include <Mod/Mesh/App/Mesh.h>
+#include <Gui/SoFCRayPickTree.h>
 
 typedef unsigned int GLuint;
 typedef int GLint;
@@ -152,6 +155,11 @@ protected:
  * The limit of maximum allowed triangles can be specified in \a renderTriangleLimit, the
  * default value is set to 100.000.
  *
+ * If the OpenGL implementation supports vertex buffer objects and the mesh has an overall
+ * material the triangles are uploaded once into a buffer object of the graphics card and
+ * rendered from there. In this case the complete mesh is always rendered. The buffer gets
+ * rebuilt as soon as the mesh has changed.
+ *
  * The GLRender() method checks the status of the SoFCInteractiveElement to decide to be in
  * interactive mode or not.
  * To take advantage of this facility the client programmer must set the status of the
@@ -194,7 +202,7 @@ private:
 
 private:
     // Force using the reference count mechanism.
-    virtual ~SoFCMeshObjectShape() {};
+    virtual ~SoFCMeshObjectShape();
     virtual void notify(SoNotList * list);
     Binding findMaterialBinding(SoState * const state) const;
     // Draw faces
@@ -202,6 +210,15 @@ private:
                    SbBool needNormals, SbBool ccw) const;
     void drawPoints(const Mesh::MeshObject *, SbBool needNormals, SbBool ccw) const;
     unsigned int countTriangles(SoAction * action) const;
+    // Draw faces from a vertex buffer object
+    bool drawFacesVBO(SoGLRenderAction * action, const Mesh::MeshObject *,
+                      SbBool needNormals, SbBool ccw);
+    void generateVertexArray(const Mesh::MeshObject *, SbBool ccw);
+    void fillVertexArray(const Mesh::MeshObject *, SbBool ccw,
+                         const std::pair<unsigned long, unsigned long>&);
+    void releaseBuffers();
+    static void deleteBuffer(void * closure, uint32_t contextid);
+    void buildPickTree(const Mesh::MeshObject *);
 
     void startSelection(SoAction * action, const Mesh::MeshObject*);
     void stopSelection(SoAction * action, const Mesh::MeshObject*);
@@ -209,6 +226,18 @@ private:
 
 private:
     bool meshChanged;
+    /// interleaved normals and points of all triangle corners, only kept until uploaded
+    std::vector<float> vertexArray;
+    /// the vertex buffer object for each OpenGL context, 0 if the upload failed
+    std::map<uint32_t, GLuint> vertexBuffers;
+    const Mesh::MeshObject* bufferMesh;
+    uint32_t bufferNodeId;
+    SbBool bufferCcw;
+    /// the facets sorted into a tree to speed up picking
+    Gui::SoFCRayPickTree pickTree;
+    bool pickTreeChanged;
+    const Mesh::MeshObject* pickTreeMesh;
+    uint32_t pickTreeNodeId;
     GLuint *selectBuf;
     GLfloat modelview[16];
     GLfloat projection[16];
@@ -28,13 +28,20 @@
 #include <Base/Exception.h>
 #include <Base/Tools.h>
 #include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Mesh/App/Core/ParallelSort.h>
 
+#include <QFuture>
+#include <QtConcurrentMap>
+
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepTools.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
-#include <StlTransfer.hxx>
-#include <StlMesh_Mesh.hxx>
-#include <StlMesh_MeshExplorer.hxx>
+#include <Poly_Triangulation.hxx>
 #include <Standard_Version.hxx>
 
 #ifdef HAVE_SMESH
@@ -98,38 +105,84 @@ int MeshingOutput::sync()
 
 // ----------------------------------------------------------------------------
 
-struct Mesher::Vertex {
-    static const double deflection;
-    Standard_Real x,y,z;
-    Standard_Integer i;
-    mutable MeshCore::MeshPoint p;
+namespace MeshPart {
+
+/**
+ * The triangulation of a single face. The points are already transformed
+ * by the location of the face and the triangles are oriented according to
+ * the orientation of the face.
+ */
+struct FaceTriangulation
+{
+    TopoDS_Face face;
+    bool valid;
+    std::size_t numNodes;
+    std::vector<gp_Pnt> points;
+    std::vector<unsigned long> triangles;
 
-    Vertex(Standard_Real X, Standard_Real Y, Standard_Real Z)
-        : x(X),y(Y),z(Z),i(0)
+    FaceTriangulation() : valid(false), numNodes(0)
     {
-        p.x = static_cast<float>(x);
-        p.y = static_cast<float>(y);
-        p.z = static_cast<float>(z);
     }
+};
 
-    const MeshCore::MeshPoint& toPoint() const
+/**
+ * A node of a face triangulation with its index in the array of all nodes.
+ */
+struct TriangulationNode
+{
+    Standard_Real x,y,z;
+    unsigned long i;
+
+    bool operator < (const TriangulationNode& n) const
     {
-        return p;
+        if (x != n.x)
+            return x < n.x;
+        if (y != n.y)
+            return y < n.y;
+        return z < n.z;
     }
-
-    bool operator < (const Vertex &v) const
+    bool isEqual(const TriangulationNode& n) const
     {
-        if (fabs ( this->x - v.x) >= deflection)
-            return this->x < v.x;
-        if (fabs ( this->y - v.y) >= deflection)
-            return this->y < v.y;
-        if (fabs ( this->z - v.z) >= deflection)
-            return this->z < v.z;
-        return false; // points are considered to be equal
+        return x == n.x && y == n.y && z == n.z;
     }
 };
 
-const double Mesher::Vertex::deflection = gp::Resolution();
+}
+
+static void collectTriangulation(FaceTriangulation& ft)
+{
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(ft.face, loc);
+    if (mesh.IsNull())
+        return;
+
+    ft.valid = true;
+    ft.numNodes = mesh->NbNodes();
+    bool identity = loc.IsIdentity();
+    gp_Trsf trsf = loc.Transformation();
+
+    const TColgp_Array1OfPnt& nodes = mesh->Nodes();
+    ft.points.reserve(nodes.Length());
+    for (Standard_Integer i = nodes.Lower(); i <= nodes.Upper(); i++) {
+        gp_Pnt p = nodes(i);
+        if (!identity)
+            p.Transform(trsf);
+        ft.points.push_back(p);
+    }
+
+    bool reversed = (ft.face.Orientation() == TopAbs_REVERSED);
+    const Poly_Array1OfTriangle& triangles = mesh->Triangles();
+    ft.triangles.reserve(3 * triangles.Length());
+    for (Standard_Integer i = triangles.Lower(); i <= triangles.Upper(); i++) {
+        Standard_Integer n1, n2, n3;
+        triangles(i).Get(n1, n2, n3);
+        if (reversed)
+            std::swap(n1, n2);
+        ft.triangles.push_back(n1 - nodes.Lower());
+        ft.triangles.push_back(n2 - nodes.Lower());
+        ft.triangles.push_back(n3 - nodes.Lower());
+    }
+}
 
 // ----------------------------------------------------------------------------
 
@@ -165,82 +218,96 @@ Mesh::MeshObject* Mesher::createMesh() const
 {
     // OCC standard mesher
     if (method == Standard) {
-        Handle_StlMesh_Mesh aMesh = new StlMesh_Mesh();
-
+        TopTools_IndexedMapOfShape faceMap;
         if (!shape.IsNull()) {
             BRepTools::Clean(shape);
-#if OCC_VERSION_HEX >= 0x060801
-            BRepMesh_IncrementalMesh bMesh(shape, deflection, Standard_False, angularDeflection);
-            StlTransfer::RetrieveMesh(shape,aMesh);
+            // The faces are meshed in parallel. Each edge is discretized only
+            // once and its points are shared by the triangulations of all
+            // faces it belongs to.
+#if OCC_VERSION_HEX >= 0x060600
+            BRepMesh_IncrementalMesh bMesh(shape, deflection, Standard_False,
+                                           angularDeflection, Standard_True);
 #else
-            StlTransfer::BuildIncrementalMesh(shape, deflection,
-#if OCC_VERSION_HEX >= 0x060503
-                Standard_True,
-#endif
-                aMesh);
+            BRepMesh_IncrementalMesh bMesh(shape, deflection, Standard_False,
+                                           angularDeflection);
 #endif
+            TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
+        }
+
+        std::vector<FaceTriangulation> triangulations(faceMap.Extent());
+        for (int i=0; i<faceMap.Extent(); i++)
+            triangulations[i].face = TopoDS::Face(faceMap(i+1));
+
+        // collect the triangulations of the faces in parallel
+        QFuture<void> future = QtConcurrent::map(triangulations, &collectTriangulation);
+        future.waitForFinished();
+
+        std::size_t numNodes = 0, numTriangles = 0;
+        int numDomains = 0;
+        for (std::vector<FaceTriangulation>::iterator it = triangulations.begin(); it != triangulations.end(); ++it) {
+            numNodes += it->points.size();
+            numTriangles += it->triangles.size() / 3;
+            if (it->valid)
+                numDomains++;
+        }
+
+        // Weld the nodes of the faces. As adjacent faces share the points of
+        // the discretization of their common edge the nodes are exactly equal
+        // and no tolerance is needed.
+        std::vector<TriangulationNode> nodes;
+        nodes.reserve(numNodes);
+        for (std::vector<FaceTriangulation>::iterator it = triangulations.begin(); it != triangulations.end(); ++it) {
+            for (std::vector<gp_Pnt>::iterator jt = it->points.begin(); jt != it->points.end(); ++jt) {
+                TriangulationNode node;
+                node.x = jt->X();
+                node.y = jt->Y();
+                node.z = jt->Z();
+                node.i = nodes.size();
+                nodes.push_back(node);
+            }
+            std::vector<gp_Pnt>().swap(it->points);
         }
 
+        MeshCore::ParallelSort<TriangulationNode>::sort(nodes);
+
+        MeshCore::MeshPointArray verts;
+        verts.reserve(nodes.size());
+        std::vector<unsigned long> nodeToPoint(nodes.size());
+        for (std::vector<TriangulationNode>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            if (it == nodes.begin() || !(it-1)->isEqual(*it)) {
+                verts.push_back(MeshCore::MeshPoint(Base::Vector3f(
+                    static_cast<float>(it->x),
+                    static_cast<float>(it->y),
+                    static_cast<float>(it->z))));
+            }
+            nodeToPoint[it->i] = verts.size() - 1;
+        }
+        std::vector<TriangulationNode>().swap(nodes);
+
         std::map<uint32_t, std::vector<std::size_t> > colorMap;
         for (std::size_t i=0; i<colors.size(); i++) {
             colorMap[colors[i]].push_back(i);
         }
 
-        bool createSegm = (static_cast<int>(colors.size()) == aMesh->NbDomains());
+        bool createSegm = (static_cast<int>(colors.size()) == numDomains);
 
         MeshCore::MeshFacetArray faces;
-        faces.reserve(aMesh->NbTriangles());
-
-        std::set<Vertex> vertices;
-        Standard_Real x1, y1, z1;
-        Standard_Real x2, y2, z2;
-        Standard_Real x3, y3, z3;
+        faces.reserve(numTriangles);
 
         std::vector< std::vector<unsigned long> > meshSegments;
         std::size_t numMeshFaces = 0;
-        StlMesh_MeshExplorer xp(aMesh);
-        for (Standard_Integer nbd=1;nbd<=aMesh->NbDomains();nbd++) {
+        unsigned long nodeOffset = 0;
+        for (std::vector<FaceTriangulation>::iterator it = triangulations.begin(); it != triangulations.end(); ++it) {
+            if (!it->valid)
+                continue;
+
             std::size_t numDomainFaces = 0;
-            for (xp.InitTriangle(nbd); xp.MoreTriangle(); xp.NextTriangle()) {
-                xp.TriangleVertices(x1,y1,z1,x2,y2,z2,x3,y3,z3);
-                std::set<Vertex>::iterator it;
+            const std::vector<unsigned long>& triangles = it->triangles;
+            for (std::size_t i=0; i<triangles.size(); i+=3) {
                 MeshCore::MeshFacet face;
-
-                // 1st vertex
-                Vertex v1(x1,y1,z1);
-                it = vertices.find(v1);
-                if (it == vertices.end()) {
-                    v1.i = vertices.size();
-                    face._aulPoints[0] = v1.i;
-                    vertices.insert(v1);
-                }
-                else {
-                    face._aulPoints[0] = it->i;
-                }
-
-                // 2nd vertex
-                Vertex v2(x2,y2,z2);
-                it = vertices.find(v2);
-                if (it == vertices.end()) {
-                    v2.i = vertices.size();
-                    face._aulPoints[1] = v2.i;
-                    vertices.insert(v2);
-                }
-                else {
-                    face._aulPoints[1] = it->i;
-                }
-
-                // 3rd vertex
-                Vertex v3(x3,y3,z3);
-                it = vertices.find(v3);
-                if (it == vertices.end()) {
-                    v3.i = vertices.size();
-                    face._aulPoints[2] = v3.i;
-                    vertices.insert(v3);
-                }
-                else {
-                    face._aulPoints[2] = it->i;
-                }
+                face._aulPoints[0] = nodeToPoint[nodeOffset + triangles[i]];
+                face._aulPoints[1] = nodeToPoint[nodeOffset + triangles[i+1]];
+                face._aulPoints[2] = nodeToPoint[nodeOffset + triangles[i+2]];
 
                 // make sure that we don't insert invalid facets
                 if (face._aulPoints[0] != face._aulPoints[1] &&
@@ -251,6 +318,8 @@ Mesh::MeshObject* Mesher::createMesh() const
                 }
             }
 
+            nodeOffset += it->numNodes;
+
             // add a segment for the face
             if (createSegm || this->segments) {
                 std::vector<unsigned long> segment(numDomainFaces);
@@ -260,11 +329,6 @@ Mesh::MeshObject* Mesher::createMesh() const
             }
         }
 
-        MeshCore::MeshPointArray verts;
-        verts.resize(vertices.size());
-        for (auto it : vertices)
-            verts[it.i] = it.toPoint();
-
         MeshCore::MeshKernel kernel;
         kernel.Adopt(verts, faces, true);
 
@@ -146,7 +146,6 @@ private:
     bool allowquad;
 #endif
     std::vector<uint32_t> colors;
-    struct Vertex;
 };
 
 class MeshingOutput : public std::streambuf
@@ -15,6 +15,7 @@
 # include <Interface_Static.hxx>
 # include <IGESControl_Controller.hxx>
 # include <STEPControl_Controller.hxx>
+# include <Standard.hxx>
 # include <Standard_Version.hxx>
 # include <OSD.hxx>
 # include <sstream>
@@ -231,6 +232,13 @@ PyMODINIT_FUNC initPart()
     OSD::SetSignal(Standard_False);
 #endif
 
+#if OCC_VERSION_HEX < 0x070000
+    // Several Python wrappers release the GIL while an algorithm runs, so
+    // OCC may be used by more than one thread. Before OCC 7 the handles and
+    // the error handlers are only thread-safe in reentrant mode.
+    Standard::SetReentrant(Standard_True);
+#endif
+
     PyObject* partModule = Part::initModule();
     Base::Console().Log("Loading Part module... done\n");
 
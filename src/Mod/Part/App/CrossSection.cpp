@@ -23,10 +23,13 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <BRep_Builder.hxx>
 # include <BRepAdaptor_Surface.hxx>
 # include <BRepAlgoAPI_Common.hxx>
 # include <BRepAlgoAPI_Cut.hxx>
 # include <BRepAlgoAPI_Section.hxx>
+# include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepBuilderAPI_MakeWire.hxx>
 # include <BRepGProp_Face.hxx>
@@ -40,36 +43,150 @@
 # include <TopTools_IndexedMapOfShape.hxx>
 # include <TopTools_HSequenceOfShape.hxx>
 # include <TopoDS.hxx>
+# include <TopoDS_Compound.hxx>
 # include <TopoDS_Edge.hxx>
 # include <TopoDS_Wire.hxx>
 #endif
 
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include "CrossSection.h"
 
 using namespace Part;
 
 
-CrossSection::CrossSection(double a, double b, double c, const TopoDS_Shape& s)
-  : a(a), b(b), c(c), s(s)
+namespace Part {
+struct SliceRange {
+    double a,b,c;
+    const TopoDS_Shape* shape;
+    std::vector<double>::const_iterator first, last;
+    std::vector< std::list<TopoDS_Wire> >::iterator result;
+};
+}
+
+static void sliceRange(SliceRange& range)
 {
+    // Boolean operations may modify their input shapes, so each thread
+    // needs its own copy
+    BRepBuilderAPI_Copy copy(*range.shape);
+    TopoDS_Shape shape = copy.Shape();
+    CrossSection cs(range.a, range.b, range.c, shape);
+    std::vector< std::list<TopoDS_Wire> >::iterator jt = range.result;
+    for (std::vector<double>::const_iterator it = range.first; it != range.last; ++it, ++jt)
+        *jt = cs.slice(*it);
 }
 
-std::list<TopoDS_Wire> CrossSection::slice(double d) const
+CrossSection::CrossSection(double a, double b, double c, const TopoDS_Shape& s)
+  : a(a), b(b), c(c), s(s)
 {
-    std::list<TopoDS_Wire> wires;
     // Fixes: 0001228: Cross section of Torus in Part Workbench fails or give wrong results
     // Fixes: 0001137: Incomplete slices when using Part.slice on a torus
     TopExp_Explorer xp;
     for (xp.Init(s, TopAbs_SOLID); xp.More(); xp.Next()) {
-        sliceSolid(d, xp.Current(), wires);
+        addComponent(xp.Current(), true);
     }
     for (xp.Init(s, TopAbs_SHELL, TopAbs_SOLID); xp.More(); xp.Next()) {
-        sliceNonSolid(d, xp.Current(), wires);
+        addComponent(xp.Current(), false);
     }
     for (xp.Init(s, TopAbs_FACE, TopAbs_SHELL); xp.More(); xp.Next()) {
-        sliceNonSolid(d, xp.Current(), wires);
+        addComponent(xp.Current(), false);
+    }
+}
+
+void CrossSection::addComponent(const TopoDS_Shape& shape, bool solid)
+{
+    // the bounding boxes are used to skip the shapes and faces that are
+    // not hit by a plane
+    Component comp;
+    comp.shape = shape;
+    comp.solid = solid;
+    TopTools_IndexedMapOfShape mapOfFaces;
+    TopExp::MapShapes(shape, TopAbs_FACE, mapOfFaces);
+    for (int i=1; i<=mapOfFaces.Extent(); i++) {
+        Bnd_Box box;
+        BRepBndLib::Add(mapOfFaces(i), box, Standard_False);
+        box.Enlarge(Precision::Confusion());
+        comp.faces.push_back(TopoDS::Face(mapOfFaces(i)));
+        comp.faceBoxes.push_back(box);
+        comp.box.Add(box);
+    }
+    components.push_back(comp);
+}
+
+std::list<TopoDS_Wire> CrossSection::slice(double d) const
+{
+    std::list<TopoDS_Wire> wires;
+    gp_Pln slicePlane(a,b,c,-d);
+    for (std::vector<Component>::const_iterator it = components.begin(); it != components.end(); ++it) {
+        if (it->box.IsOut(slicePlane))
+            continue;
+
+        std::vector<std::size_t> hit;
+        for (std::size_t i = 0; i < it->faceBoxes.size(); i++) {
+            if (!it->faceBoxes[i].IsOut(slicePlane))
+                hit.push_back(i);
+        }
+        if (hit.empty())
+            continue;
+
+        if (it->solid) {
+            // the cut with the half-space needs the closed solid to get the
+            // faces of the section
+            sliceSolid(d, it->shape, wires);
+        }
+        else if (hit.size() == it->faces.size()) {
+            sliceNonSolid(d, it->shape, wires);
+        }
+        else {
+            // only intersect the faces hit by the plane, they still share
+            // their edges so that the section edges can be connected
+            TopoDS_Compound comp;
+            BRep_Builder builder;
+            builder.MakeCompound(comp);
+            for (std::vector<std::size_t>::iterator jt = hit.begin(); jt != hit.end(); ++jt)
+                builder.Add(comp, it->faces[*jt]);
+            sliceNonSolid(d, comp, wires);
+        }
+    }
+
+    return wires;
+}
+
+std::vector< std::list<TopoDS_Wire> > CrossSection::slices(const std::vector<double>& d, int numThreads) const
+{
+    std::vector< std::list<TopoDS_Wire> > wires(d.size());
+    if (numThreads <= 0)
+        numThreads = QThread::idealThreadCount();
+    numThreads = std::min<int>(numThreads, static_cast<int>(d.size()));
+
+    if (numThreads < 2) {
+        for (std::size_t i = 0; i < d.size(); i++)
+            wires[i] = slice(d[i]);
+        return wires;
+    }
+
+    // split the distances into contiguous ranges, one per thread
+    std::vector<SliceRange> ranges(numThreads);
+    std::size_t rangeSize = d.size() / numThreads;
+    std::size_t remainder = d.size() % numThreads;
+    std::size_t pos = 0;
+    for (int i = 0; i < numThreads; i++) {
+        std::size_t count = rangeSize + (static_cast<std::size_t>(i) < remainder ? 1 : 0);
+        ranges[i].a = a;
+        ranges[i].b = b;
+        ranges[i].c = c;
+        ranges[i].shape = &s;
+        ranges[i].first = d.begin() + pos;
+        ranges[i].last = d.begin() + pos + count;
+        ranges[i].result = wires.begin() + pos;
+        pos += count;
     }
 
+    QFuture<void> future = QtConcurrent::map(ranges, &sliceRange);
+    future.waitForFinished();
+
     return wires;
 }
 
@@ -25,6 +25,10 @@
 #define PART_CROSSSECTION_H
 
 #include <list>
+#include <vector>
+#include <Bnd_Box.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Shape.hxx>
 #include <TopTools_IndexedMapOfShape.hxx>
 
 class TopoDS_Shape;
@@ -37,8 +41,22 @@ class PartExport CrossSection
 public:
     CrossSection(double a, double b, double c, const TopoDS_Shape& s);
     std::list<TopoDS_Wire> slice(double d) const;
+    /** Makes a slice for each of the distances \a d. The result has the same
+     * order as \a d. The slices are made by \a numThreads threads that work
+     * on their own copy of the shape, 0 means to use one thread per core.
+     */
+    std::vector< std::list<TopoDS_Wire> > slices(const std::vector<double>& d, int numThreads = 1) const;
 
 private:
+    struct Component {
+        TopoDS_Shape shape;
+        Bnd_Box box;
+        bool solid;
+        std::vector<TopoDS_Face> faces;
+        std::vector<Bnd_Box> faceBoxes;
+    };
+    void addComponent(const TopoDS_Shape&, bool solid);
+
     void sliceNonSolid(double d, const TopoDS_Shape&, std::list<TopoDS_Wire>& wires) const;
     void sliceSolid(double d, const TopoDS_Shape&, std::list<TopoDS_Wire>& wires) const;
     void connectEdges (const std::list<TopoDS_Edge>& edges, std::list<TopoDS_Wire>& wires) const;
@@ -47,6 +65,7 @@ private:
 private:
     double a,b,c;
     const TopoDS_Shape& s;
+    std::vector<Component> components;
 };
 
 }
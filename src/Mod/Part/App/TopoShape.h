@@ -160,7 +160,7 @@ public:
     TopoDS_Shape oldFuse(TopoDS_Shape) const;
     TopoDS_Shape section(TopoDS_Shape) const;
     std::list<TopoDS_Wire> slice(const Base::Vector3d&, double) const;
-    TopoDS_Compound slices(const Base::Vector3d&, const std::vector<double>&) const;
+    TopoDS_Compound slices(const Base::Vector3d&, const std::vector<double>&, int numThreads = 1) const;
     /**
      * @brief generalFuse: run general fuse algorithm between this and shapes
      * supplied as sOthers
@@ -64,6 +64,7 @@
 
 
 #include <Base/GeometryPyCXX.h>
+#include <Base/Interpreter.h>
 #include <Base/Matrix.h>
 #include <Base/Rotation.h>
 #include <Base/MatrixPy.h>
@@ -747,7 +748,12 @@ PyObject*  TopoShapePy::check(PyObject *args)
         return NULL;
     if (!getTopoShapePtr()->getShape().IsNull()) {
         std::stringstream str;
-        if (!getTopoShapePtr()->analyze(str)) {
+        bool valid;
+        {
+            Base::PyGILStateRelease unlock;
+            valid = getTopoShapePtr()->analyze(str);
+        }
+        if (!valid) {
             PyErr_SetString(PyExc_StandardError, str.str().c_str());
             PyErr_Print();
         }
@@ -765,7 +771,11 @@ PyObject*  TopoShapePy::fuse(PyObject *args)
     TopoDS_Shape shape = static_cast<TopoShapePy*>(pcObj)->getTopoShapePtr()->getShape();
     try {
         // Let's call algorithm computing a fuse operation:
-        TopoDS_Shape fusShape = this->getTopoShapePtr()->fuse(shape);
+        TopoDS_Shape fusShape;
+        {
+            Base::PyGILStateRelease unlock;
+            fusShape = this->getTopoShapePtr()->fuse(shape);
+        }
         return new TopoShapePy(new TopoShape(fusShape));
     }
     catch (Standard_Failure) {
@@ -798,7 +808,11 @@ PyObject*  TopoShapePy::multiFuse(PyObject *args)
        }
     }
     try {
-        TopoDS_Shape multiFusedShape = this->getTopoShapePtr()->multiFuse(shapeVec,tolerance);
+        TopoDS_Shape multiFusedShape;
+        {
+            Base::PyGILStateRelease unlock;
+            multiFusedShape = this->getTopoShapePtr()->multiFuse(shapeVec,tolerance);
+        }
         return new TopoShapePy(new TopoShape(multiFusedShape));
     }
     catch (Standard_Failure) {
@@ -821,7 +835,11 @@ PyObject*  TopoShapePy::oldFuse(PyObject *args)
     TopoDS_Shape shape = static_cast<TopoShapePy*>(pcObj)->getTopoShapePtr()->getShape();
     try {
         // Let's call algorithm computing a fuse operation:
-        TopoDS_Shape fusShape = this->getTopoShapePtr()->oldFuse(shape);
+        TopoDS_Shape fusShape;
+        {
+            Base::PyGILStateRelease unlock;
+            fusShape = this->getTopoShapePtr()->oldFuse(shape);
+        }
         return new TopoShapePy(new TopoShape(fusShape));
     }
     catch (Standard_Failure) {
@@ -844,7 +862,11 @@ PyObject*  TopoShapePy::common(PyObject *args)
     TopoDS_Shape shape = static_cast<TopoShapePy*>(pcObj)->getTopoShapePtr()->getShape();
     try {
         // Let's call algorithm computing a common operation:
-        TopoDS_Shape comShape = this->getTopoShapePtr()->common(shape);
+        TopoDS_Shape comShape;
+        {
+            Base::PyGILStateRelease unlock;
+            comShape = this->getTopoShapePtr()->common(shape);
+        }
         return new TopoShapePy(new TopoShape(comShape));
     }
     catch (Standard_Failure) {
@@ -867,7 +889,11 @@ PyObject*  TopoShapePy::section(PyObject *args)
     TopoDS_Shape shape = static_cast<TopoShapePy*>(pcObj)->getTopoShapePtr()->getShape();
     try {
         // Let's call algorithm computing a section operation:
-        TopoDS_Shape secShape = this->getTopoShapePtr()->section(shape);
+        TopoDS_Shape secShape;
+        {
+            Base::PyGILStateRelease unlock;
+            secShape = this->getTopoShapePtr()->section(shape);
+        }
         return new TopoShapePy(new TopoShape(secShape));
     }
     catch (Standard_Failure) {
@@ -890,7 +916,11 @@ PyObject*  TopoShapePy::slice(PyObject *args)
 
     try {
         Base::Vector3d vec = Py::Vector(dir, false).toVector();
-        std::list<TopoDS_Wire> slice = this->getTopoShapePtr()->slice(vec, d);
+        std::list<TopoDS_Wire> slice;
+        {
+            Base::PyGILStateRelease unlock;
+            slice = this->getTopoShapePtr()->slice(vec, d);
+        }
         Py::List wire;
         for (std::list<TopoDS_Wire>::iterator it = slice.begin(); it != slice.end(); ++it) {
             wire.append(Py::asObject(new TopoShapeWirePy(new TopoShape(*it))));
@@ -912,7 +942,8 @@ PyObject*  TopoShapePy::slice(PyObject *args)
 PyObject*  TopoShapePy::slices(PyObject *args)
 {
     PyObject *dir, *dist;
-    if (!PyArg_ParseTuple(args, "O!O", &(Base::VectorPy::Type), &dir, &dist))
+    int threads = 1;
+    if (!PyArg_ParseTuple(args, "O!O|i", &(Base::VectorPy::Type), &dir, &dist, &threads))
         return NULL;
 
     try {
@@ -922,7 +953,11 @@ PyObject*  TopoShapePy::slices(PyObject *args)
         d.reserve(list.size());
         for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it)
             d.push_back((double)Py::Float(*it));
-        TopoDS_Compound slice = this->getTopoShapePtr()->slices(vec, d);
+        TopoDS_Compound slice;
+        {
+            Base::PyGILStateRelease unlock;
+            slice = this->getTopoShapePtr()->slices(vec, d, threads);
+        }
         return new TopoShapeCompoundPy(new TopoShape(slice));
     }
     catch (Standard_Failure) {
@@ -945,7 +980,11 @@ PyObject*  TopoShapePy::cut(PyObject *args)
     TopoDS_Shape shape = static_cast<TopoShapePy*>(pcObj)->getTopoShapePtr()->getShape();
     try {
         // Let's call algorithm computing a cut operation:
-        TopoDS_Shape cutShape = this->getTopoShapePtr()->cut(shape);
+        TopoDS_Shape cutShape;
+        {
+            Base::PyGILStateRelease unlock;
+            cutShape = this->getTopoShapePtr()->cut(shape);
+        }
         return new TopoShapePy(new TopoShape(cutShape));
     }
     catch (Standard_Failure) {
@@ -979,7 +1018,11 @@ PyObject*  TopoShapePy::generalFuse(PyObject *args)
     }
     try {
         std::vector<TopTools_ListOfShape> map;
-        TopoDS_Shape gfaResultShape = this->getTopoShapePtr()->generalFuse(shapeVec,tolerance,&map);
+        TopoDS_Shape gfaResultShape;
+        {
+            Base::PyGILStateRelease unlock;
+            gfaResultShape = this->getTopoShapePtr()->generalFuse(shapeVec,tolerance,&map);
+        }
 
         Py::Object shapePy = shape2pyshape(gfaResultShape);
 
@@ -1278,7 +1321,12 @@ PyObject* TopoShapePy::makeFillet(PyObject *args)
                     }
                 }
             }
-            return new TopoShapePy(new TopoShape(mkFillet.Shape()));
+            TopoDS_Shape result;
+            {
+                Base::PyGILStateRelease unlock;
+                result = mkFillet.Shape();
+            }
+            return new TopoShapePy(new TopoShape(result));
         }
         catch (Standard_Failure) {
             Handle_Standard_Failure e = Standard_Failure::Caught();
@@ -1304,7 +1352,12 @@ PyObject* TopoShapePy::makeFillet(PyObject *args)
                     }
                 }
             }
-            return new TopoShapePy(new TopoShape(mkFillet.Shape()));
+            TopoDS_Shape result;
+            {
+                Base::PyGILStateRelease unlock;
+                result = mkFillet.Shape();
+            }
+            return new TopoShapePy(new TopoShape(result));
         }
         catch (Standard_Failure) {
             Handle_Standard_Failure e = Standard_Failure::Caught();
@@ -1343,7 +1396,12 @@ PyObject* TopoShapePy::makeChamfer(PyObject *args)
                     }
                 }
             }
-            return new TopoShapePy(new TopoShape(mkChamfer.Shape()));
+            TopoDS_Shape result;
+            {
+                Base::PyGILStateRelease unlock;
+                result = mkChamfer.Shape();
+            }
+            return new TopoShapePy(new TopoShape(result));
         }
         catch (Standard_Failure) {
             Handle_Standard_Failure e = Standard_Failure::Caught();
@@ -1374,7 +1432,12 @@ PyObject* TopoShapePy::makeChamfer(PyObject *args)
                     }
                 }
             }
-            return new TopoShapePy(new TopoShape(mkChamfer.Shape()));
+            TopoDS_Shape result;
+            {
+                Base::PyGILStateRelease unlock;
+                result = mkChamfer.Shape();
+            }
+            return new TopoShapePy(new TopoShape(result));
         }
         catch (Standard_Failure) {
             Handle_Standard_Failure e = Standard_Failure::Caught();
@@ -1414,8 +1477,14 @@ PyObject* TopoShapePy::makeThickness(PyObject *args)
             }
         }
 
-        TopoDS_Shape shape = this->getTopoShapePtr()->makeThickSolid(facesToRemove, offset, tolerance,
-            PyObject_IsTrue(inter) ? true : false, PyObject_IsTrue(self_inter) ? true : false, offsetMode, join);
+        bool isInter = PyObject_IsTrue(inter) ? true : false;
+        bool isSelfInter = PyObject_IsTrue(self_inter) ? true : false;
+        TopoDS_Shape shape;
+        {
+            Base::PyGILStateRelease unlock;
+            shape = this->getTopoShapePtr()->makeThickSolid(facesToRemove, offset, tolerance,
+                isInter, isSelfInter, offsetMode, join);
+        }
         return new TopoShapeSolidPy(new TopoShape(shape));
     }
     catch (Standard_Failure) {
@@ -1442,10 +1511,15 @@ PyObject* TopoShapePy::makeOffsetShape(PyObject *args, PyObject *keywds)
         return 0;
 
     try {
-        TopoDS_Shape shape = this->getTopoShapePtr()->makeOffsetShape(offset, tolerance,
-            PyObject_IsTrue(inter) ? true : false,
-            PyObject_IsTrue(self_inter) ? true : false, offsetMode, join,
-            PyObject_IsTrue(fill) ? true : false);
+        bool isInter = PyObject_IsTrue(inter) ? true : false;
+        bool isSelfInter = PyObject_IsTrue(self_inter) ? true : false;
+        bool isFill = PyObject_IsTrue(fill) ? true : false;
+        TopoDS_Shape shape;
+        {
+            Base::PyGILStateRelease unlock;
+            shape = this->getTopoShapePtr()->makeOffsetShape(offset, tolerance,
+                isInter, isSelfInter, offsetMode, join, isFill);
+        }
         return new TopoShapePy(new TopoShape(shape));
     }
     catch (Standard_Failure) {
@@ -1472,10 +1546,15 @@ PyObject* TopoShapePy::makeOffset2D(PyObject *args, PyObject *keywds)
         return 0;
 
     try {
-        TopoDS_Shape resultShape = this->getTopoShapePtr()->makeOffset2D(offset, join,
-            PyObject_IsTrue(fill) ? true : false,
-            PyObject_IsTrue(openResult) ? true : false,
-            PyObject_IsTrue(inter) ? true : false);
+        bool isFill = PyObject_IsTrue(fill) ? true : false;
+        bool isOpenResult = PyObject_IsTrue(openResult) ? true : false;
+        bool isInter = PyObject_IsTrue(inter) ? true : false;
+        TopoDS_Shape resultShape;
+        {
+            Base::PyGILStateRelease unlock;
+            resultShape = this->getTopoShapePtr()->makeOffset2D(offset, join,
+                isFill, isOpenResult, isInter);
+        }
         return new_reference_to(shape2pyshape(resultShape));
     }
     PY_CATCH_OCC;
@@ -1615,9 +1694,13 @@ PyObject* TopoShapePy::tessellate(PyObject *args)
             return 0;
         std::vector<Base::Vector3d> Points;
         std::vector<Data::ComplexGeoData::Facet> Facets;
-        if (PyObject_IsTrue(ok))
-            BRepTools::Clean(getTopoShapePtr()->getShape());
-        getTopoShapePtr()->getFaces(Points, Facets,tolerance);
+        bool clean = PyObject_IsTrue(ok) ? true : false;
+        {
+            Base::PyGILStateRelease unlock;
+            if (clean)
+                BRepTools::Clean(getTopoShapePtr()->getShape());
+            getTopoShapePtr()->getFaces(Points, Facets,tolerance);
+        }
         Py::Tuple tuple(2);
         Py::List vertex;
         for (std::vector<Base::Vector3d>::const_iterator it = Points.begin();
@@ -1808,7 +1891,11 @@ PyObject* TopoShapePy::removeSplitter(PyObject *args)
 
     try {
         // Remove redundant splitter
-        TopoDS_Shape shape = this->getTopoShapePtr()->removeSplitter();
+        TopoDS_Shape shape;
+        {
+            Base::PyGILStateRelease unlock;
+            shape = this->getTopoShapePtr()->removeSplitter();
+        }
         return new TopoShapePy(new TopoShape(shape));
     }
     catch (Standard_Failure) {
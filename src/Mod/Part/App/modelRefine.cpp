@@ -62,7 +62,9 @@
 #include <BRepAdaptor_Curve.hxx>
 #include <TColgp_SequenceOfPnt.hxx>
 #include <GeomAPI_ProjectPointOnSurf.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 #include <Base/Console.h>
+#include <Base/TimeInfo.h>
 #include "modelRefine.h"
 
 using namespace ModelRefine;
@@ -79,33 +81,36 @@ void ModelRefine::getFaceEdges(const TopoDS_Face &face, EdgeVectorType &edges)
 void ModelRefine::boundaryEdges(const FaceVectorType &faces, EdgeVectorType &edgesOut)
 {
     //this finds all the boundary edges. Maybe more than one boundary.
-    std::list<TopoDS_Edge> edges;
+    //an edge used an even number of times is an inner edge. The boundary
+    //edges are kept in the order of their last occurrence.
+    EdgeVectorType allEdges;
     FaceVectorType::const_iterator faceIt;
     for (faceIt = faces.begin(); faceIt != faces.end(); ++faceIt)
+        getFaceEdges(*faceIt, allEdges);
+
+    TopTools_IndexedMapOfShape edgeMap;
+    std::vector<int> useCount;
+    std::vector<std::size_t> lastUse;
+    useCount.reserve(allEdges.size());
+    lastUse.reserve(allEdges.size());
+    for (std::size_t index = 0; index < allEdges.size(); ++index)
     {
-        EdgeVectorType faceEdges;
-        EdgeVectorType::iterator faceEdgesIt;
-        getFaceEdges(*faceIt, faceEdges);
-        for (faceEdgesIt = faceEdges.begin(); faceEdgesIt != faceEdges.end(); ++faceEdgesIt)
+        std::size_t mapIndex = edgeMap.Add(allEdges[index]) - 1;
+        if (mapIndex == useCount.size())
         {
-            bool foundSignal(false);
-            std::list<TopoDS_Edge>::iterator edgesIt;
-            for (edgesIt = edges.begin(); edgesIt != edges.end(); ++edgesIt)
-            {
-                if ((*edgesIt).IsSame(*faceEdgesIt))
-                {
-                    edgesIt = edges.erase(edgesIt);
-                    foundSignal = true;
-                    break;
-                }
-            }
-            if (!foundSignal)
-                edges.push_back(*faceEdgesIt);
+            useCount.push_back(0);
+            lastUse.push_back(0);
         }
+        useCount[mapIndex]++;
+        lastUse[mapIndex] = index;
     }
 
-    edgesOut.reserve(edges.size());
-    std::copy(edges.begin(), edges.end(), back_inserter(edgesOut));
+    for (std::size_t index = 0; index < allEdges.size(); ++index)
+    {
+        std::size_t mapIndex = edgeMap.FindIndex(allEdges[index]) - 1;
+        if (useCount[mapIndex] % 2 == 1 && lastUse[mapIndex] == index)
+            edgesOut.push_back(allEdges[index]);
+    }
 }
 
 TopoDS_Shell ModelRefine::removeFaces(const TopoDS_Shell &shell, const FaceVectorType &faces)
@@ -251,26 +256,59 @@ void FaceEqualitySplitter::split(const FaceVectorType &faces, FaceTypedBase *obj
 {
     std::vector<FaceVectorType> tempVector;
     tempVector.reserve(faces.size());
+    //groups whose first face has a key, sorted by that key. A face with a key
+    //only needs to be compared with the groups in the range of its key.
+    typedef std::multimap<double, std::size_t> KeyMap;
+    KeyMap keyedGroups;
+    std::vector<std::size_t> candidates;
     FaceVectorType::const_iterator faceIt;
     for (faceIt = faces.begin(); faceIt != faces.end(); ++faceIt)
     {
-        bool foundMatch(false);
-        std::vector<FaceVectorType>::iterator tempIt;
-        for (tempIt = tempVector.begin(); tempIt != tempVector.end(); ++tempIt)
+        double key(0.0), tolerance(0.0);
+        bool hasKey = object->getEqualityKey(*faceIt, key, tolerance);
+        std::size_t match = tempVector.size();
+        if (hasKey)
         {
-            if (object->isEqual((*tempIt).front(), *faceIt))
+            //take the oldest matching group as the full search would do
+            candidates.clear();
+            KeyMap::const_iterator keyIt = keyedGroups.lower_bound(key - tolerance);
+            KeyMap::const_iterator keyEnd = keyedGroups.upper_bound(key + tolerance);
+            for (; keyIt != keyEnd; ++keyIt)
+                candidates.push_back(keyIt->second);
+            std::sort(candidates.begin(), candidates.end());
+            std::vector<std::size_t>::iterator candIt;
+            for (candIt = candidates.begin(); candIt != candidates.end(); ++candIt)
             {
-                (*tempIt).push_back(*faceIt);
-                foundMatch = true;
-                break;
+                if (object->isEqual(tempVector[*candIt].front(), *faceIt))
+                {
+                    match = *candIt;
+                    break;
+                }
             }
         }
-        if (!foundMatch)
+        else
+        {
+            for (std::size_t index = 0; index < tempVector.size(); ++index)
+            {
+                if (object->isEqual(tempVector[index].front(), *faceIt))
+                {
+                    match = index;
+                    break;
+                }
+            }
+        }
+
+        if (match < tempVector.size())
+        {
+            tempVector[match].push_back(*faceIt);
+        }
+        else
         {
             FaceVectorType another;
-            another.reserve(faces.size());
             another.push_back(*faceIt);
             tempVector.push_back(another);
+            if (hasKey)
+                keyedGroups.insert(KeyMap::value_type(key, tempVector.size() - 1));
         }
     }
     std::vector<FaceVectorType>::iterator it;
@@ -291,6 +329,11 @@ GeomAbs_SurfaceType FaceTypedBase::getFaceType(const TopoDS_Face &faceIn)
     return surfaceTest.GetType();
 }
 
+bool FaceTypedBase::getEqualityKey(const TopoDS_Face &, double &, double &) const
+{
+    return false;
+}
+
 void FaceTypedBase::boundarySplit(const FaceVectorType &facesIn, std::vector<EdgeVectorType> &boundariesOut) const
 {
     EdgeVectorType bEdges;
@@ -380,6 +423,22 @@ GeomAbs_SurfaceType FaceTypedPlane::getType() const
     return GeomAbs_Plane;
 }
 
+bool FaceTypedPlane::getEqualityKey(const TopoDS_Face &face, double &key, double &tolerance) const
+{
+    Handle(Geom_Plane) planeSurface = getGeomPlane(face);
+    if (planeSurface.IsNull())
+        return false;
+
+    //distance of the plane to the origin. For equal planes it differs by the
+    //tolerance of isEqual() plus the angular error of the normals multiplied
+    //by the distance of the plane location.
+    gp_Pln plane(planeSurface->Pln());
+    const gp_XYZ& location = plane.Position().Location().XYZ();
+    key = fabs(plane.Position().Direction().XYZ().Dot(location));
+    tolerance = Precision::Confusion() * (2.0 + location.Modulus());
+    return true;
+}
+
 TopoDS_Face FaceTypedPlane::buildFace(const FaceVectorType &faces) const
 {
     std::vector<TopoDS_Wire> wires;
@@ -476,6 +535,17 @@ GeomAbs_SurfaceType FaceTypedCylinder::getType() const
     return GeomAbs_Cylinder;
 }
 
+bool FaceTypedCylinder::getEqualityKey(const TopoDS_Face &face, double &key, double &tolerance) const
+{
+    Handle(Geom_CylindricalSurface) surface = getGeomCylinder(face);
+    if (surface.IsNull())
+        return false;
+
+    key = surface->Radius();
+    tolerance = 2.0 * Precision::Confusion();
+    return true;
+}
+
 // Auxiliary method
 const TopoDS_Face fixFace(const TopoDS_Face& f) {
     static TopoDS_Face dummy;
@@ -1005,7 +1075,7 @@ bool FaceUniter::process()
 
     for(typeIt = typeObjects.begin(); typeIt != typeObjects.end(); ++typeIt)
     {
-        ModelRefine::FaceVectorType typedFaces = splitter.getTypedFaceVector((*typeIt)->getType());
+        const ModelRefine::FaceVectorType &typedFaces = splitter.getTypedFaceVector((*typeIt)->getType());
         ModelRefine::FaceEqualitySplitter equalitySplitter;
         equalitySplitter.split(typedFaces, *typeIt);
         for (std::size_t indexEquality(0); indexEquality < equalitySplitter.getGroupCount(); ++indexEquality)
@@ -1021,7 +1091,7 @@ bool FaceUniter::process()
                     facesToSew.push_back(newFace);
                     if (facesToRemove.capacity() <= facesToRemove.size() + adjacencySplitter.getGroup(adjacentIndex).size())
                         facesToRemove.reserve(facesToRemove.size() + adjacencySplitter.getGroup(adjacentIndex).size());
-                    FaceVectorType temp = adjacencySplitter.getGroup(adjacentIndex);
+                    const FaceVectorType &temp = adjacencySplitter.getGroup(adjacentIndex);
                     facesToRemove.insert(facesToRemove.end(), temp.begin(), temp.end());
                     // the first shape will be marked as modified, i.e. replaced by newFace, all others are marked as deleted
                     // jrheinlaender: IMHO this is not correct because references to the deleted faces will be broken, whereas they should
@@ -1030,7 +1100,7 @@ bool FaceUniter::process()
                     // by a boolean cut, where one old shape is marked as modified, producing multiple new shapes
                     if (!temp.empty())
                     {
-                        for (FaceVectorType::iterator f = temp.begin(); f != temp.end(); ++f)
+                        for (FaceVectorType::const_iterator f = temp.begin(); f != temp.end(); ++f)
                               modifiedShapes.push_back(std::make_pair(*f, newFace));
                     }
                 }
@@ -1157,6 +1227,10 @@ void Part::BRepBuilderAPI_RefineModel::Build()
     if (myShape.IsNull())
         Standard_Failure::Raise("Cannot remove splitter from empty shape");
 
+    Base::TimeInfo start;
+    TopTools_IndexedMapOfShape inputFaces;
+    TopExp::MapShapes(myShape, TopAbs_FACE, inputFaces);
+
     if (myShape.ShapeType() == TopAbs_SOLID) {
         const TopoDS_Solid &solid = TopoDS::Solid(myShape);
         BRepBuilderAPI_MakeSolid mkSolid;
@@ -1246,6 +1320,12 @@ void Part::BRepBuilderAPI_RefineModel::Build()
         myShape = comp;
     }
 
+    TopTools_IndexedMapOfShape outputFaces;
+    TopExp::MapShapes(myShape, TopAbs_FACE, outputFaces);
+    Base::Console().Log("Refine model: %d faces reduced to %d faces in %f s\n",
+        inputFaces.Extent(), outputFaces.Extent(),
+        Base::TimeInfo::diffTimeF(start, Base::TimeInfo()));
+
     Done();
 }
 
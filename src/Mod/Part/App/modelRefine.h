@@ -61,6 +61,11 @@ namespace ModelRefine
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const = 0;
         virtual GeomAbs_SurfaceType getType() const = 0;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const = 0;
+        /** Computes a key for a face so that faces considered equal by isEqual()
+         * have keys that differ by less than \a tolerance. If no key can be computed
+         * false is returned; such a face must not be equal to a face with a key.
+         */
+        virtual bool getEqualityKey(const TopoDS_Face &face, double &key, double &tolerance) const;
 
         static GeomAbs_SurfaceType getFaceType(const TopoDS_Face &faceIn);
 
@@ -77,6 +82,7 @@ namespace ModelRefine
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const;
         virtual GeomAbs_SurfaceType getType() const;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const;
+        virtual bool getEqualityKey(const TopoDS_Face &face, double &key, double &tolerance) const;
         friend FaceTypedPlane& getPlaneObject();
     };
     FaceTypedPlane& getPlaneObject();
@@ -89,6 +95,7 @@ namespace ModelRefine
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const;
         virtual GeomAbs_SurfaceType getType() const;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const;
+        virtual bool getEqualityKey(const TopoDS_Face &face, double &key, double &tolerance) const;
         friend FaceTypedCylinder& getCylinderObject();
 
     protected:
@@ -41,6 +41,7 @@
 # include <Inventor/actions/SoGetPrimitiveCountAction.h>
 # include <Inventor/actions/SoGLRenderAction.h>
 # include <Inventor/actions/SoPickAction.h>
+# include <Inventor/actions/SoRayPickAction.h>
 # include <Inventor/actions/SoWriteAction.h>
 # include <Inventor/bundles/SoMaterialBundle.h>
 # include <Inventor/bundles/SoTextureCoordinateBundle.h>
@@ -54,6 +55,8 @@
 # include <Inventor/errors/SoReadError.h>
 # include <Inventor/details/SoFaceDetail.h>
 # include <Inventor/details/SoLineDetail.h>
+# include <Inventor/details/SoPointDetail.h>
+# include <Inventor/misc/SoNotification.h>
 # include <Inventor/misc/SoState.h>
 #endif
 
@@ -72,6 +75,7 @@ void SoBrepEdgeSet::initClass()
 }
 
 SoBrepEdgeSet::SoBrepEdgeSet()
+    : pickTreeValid(false), pickTreeCoordId(0)
 {
     SO_NODE_CONSTRUCTOR(SoBrepEdgeSet);
     SO_NODE_ADD_FIELD(highlightIndex, (-1));
@@ -353,3 +357,101 @@ SoDetail * SoBrepEdgeSet::createLineSegmentDetail(SoRayPickAction * action,
     line_detail->setPartIndex(index);
     return detail;
 }
+
+void SoBrepEdgeSet::notify(SoNotList * list)
+{
+    SoField *f = list->getLastField();
+    if (f == &this->coordIndex) {
+        this->pickTree.clear();
+        this->pickTreeValid = false;
+    }
+    inherited::notify(list);
+}
+
+/**
+ * Builds the tree of the bounding boxes of all line segments.
+ */
+void SoBrepEdgeSet::buildPickTree(const SoCoordinateElement* coords)
+{
+    this->pickTree.clear();
+    this->pickSegments.clear();
+    this->pickLines.clear();
+
+    const int32_t* cindices = this->coordIndex.getValues(0);
+    int numindices = this->coordIndex.getNum();
+    int numcoords = coords->getNum();
+
+    std::vector<SbBox3f> boxes;
+    int line = 0;
+    for (int i = 0; i < numindices; i++) {
+        if (cindices[i] < 0) {
+            line++;
+            continue;
+        }
+        if (i + 1 >= numindices || cindices[i+1] < 0)
+            continue;
+        if (cindices[i] >= numcoords || cindices[i+1] >= numcoords)
+            continue;
+
+        SbBox3f box;
+        box.extendBy(coords->get3(cindices[i]));
+        box.extendBy(coords->get3(cindices[i+1]));
+        boxes.push_back(box);
+        this->pickSegments.push_back(i);
+        this->pickLines.push_back(line);
+    }
+
+    this->pickTree.build(boxes);
+}
+
+/**
+ * Instead of going through all line segments with generatePrimitives() only the segments are
+ * tested against the pick ray whose bounding box is hit.
+ */
+void SoBrepEdgeSet::rayPick(SoRayPickAction *action)
+{
+    if (this->vertexProperty.getValue()) {
+        inherited::rayPick(action);
+        return;
+    }
+
+    if (!this->shouldRayPick(action))
+        return;
+
+    SoState* state = action->getState();
+    const SoCoordinateElement* coords = SoCoordinateElement::getInstance(state);
+    if (!this->pickTreeValid || this->pickTreeCoordId != coords->getNodeId()) {
+        this->pickTreeValid = true;
+        this->pickTreeCoordId = coords->getNodeId();
+        buildPickTree(coords);
+    }
+
+    this->computeObjectSpaceRay(action);
+
+    std::vector<int> segments;
+    this->pickTree.intersect(action, segments);
+
+    const int32_t* cindices = this->coordIndex.getValues(0);
+    for (std::vector<int>::iterator it = segments.begin(); it != segments.end(); ++it) {
+        int32_t start = this->pickSegments[*it];
+        const SbVec3f& p1 = coords->get3(cindices[start]);
+        const SbVec3f& p2 = coords->get3(cindices[start+1]);
+
+        SbVec3f isect;
+        if (!action->intersect(p1, p2, isect) || !action->isBetweenPlanes(isect))
+            continue;
+
+        SoPickedPoint* pp = action->addIntersection(isect);
+        if (pp) {
+            SoLineDetail* detail = new SoLineDetail();
+            detail->setLineIndex(this->pickLines[*it]);
+            detail->setPartIndex(this->pickLines[*it]);
+            SoPointDetail point;
+            point.setCoordinateIndex(cindices[start]);
+            detail->setPoint0(&point);
+            point.setCoordinateIndex(cindices[start+1]);
+            detail->setPoint1(&point);
+            pp->setDetail(detail, this);
+        }
+    }
+}
@@ -32,6 +32,7 @@
 #include <Inventor/elements/SoLazyElement.h>
 #include <Inventor/elements/SoReplacedElement.h>
 #include <vector>
+#include <Gui/SoFCRayPickTree.h>
 
 class SoCoordinateElement;
 class SoGLCoordinateElement;
@@ -61,6 +62,8 @@ protected:
         const SoPrimitiveVertex *v1,
         const SoPrimitiveVertex *v2,
         SoPickedPoint *pp);
+    virtual void rayPick(SoRayPickAction *action);
+    virtual void notify(SoNotList * list);
 private:
     void renderShape(const SoGLCoordinateElement * const vertexlist,
                      const int32_t *vertexindices,
@@ -68,6 +71,7 @@ private:
     void renderHighlight(SoGLRenderAction *action);
     void renderSelection(SoGLRenderAction *action);
     bool validIndexes(const SoCoordinateElement*, const std::vector<int32_t>&) const;
+    void buildPickTree(const SoCoordinateElement* coords);
 
 private:
     std::vector<int32_t> hl, sl;
@@ -77,6 +81,13 @@ private:
     //To solve this we need a seprate color packer for highlighting and selection
     SoColorPacker colorpacker1;
     SoColorPacker colorpacker2;
+
+    // line segments sorted into a tree to speed up picking
+    Gui::SoFCRayPickTree pickTree;
+    std::vector<int32_t> pickSegments; // index of the first point of a segment in coordIndex
+    std::vector<int32_t> pickLines;    // index of the polyline of a segment
+    bool pickTreeValid;
+    uint32_t pickTreeCoordId;
 };
 
 } // namespace PartGui
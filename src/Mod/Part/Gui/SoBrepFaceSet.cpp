@@ -41,6 +41,7 @@
 # include <Inventor/actions/SoGetPrimitiveCountAction.h>
 # include <Inventor/actions/SoGLRenderAction.h>
 # include <Inventor/actions/SoPickAction.h>
+# include <Inventor/actions/SoRayPickAction.h>
 # include <Inventor/actions/SoWriteAction.h>
 # include <Inventor/bundles/SoMaterialBundle.h>
 # include <Inventor/bundles/SoTextureCoordinateBundle.h>
@@ -55,6 +56,8 @@
 # include <Inventor/errors/SoReadError.h>
 # include <Inventor/details/SoFaceDetail.h>
 # include <Inventor/details/SoLineDetail.h>
+# include <Inventor/details/SoPointDetail.h>
+# include <Inventor/misc/SoNotification.h>
 # include <Inventor/misc/SoState.h>
 #endif
 
@@ -74,6 +77,7 @@ void SoBrepFaceSet::initClass()
 }
 
 SoBrepFaceSet::SoBrepFaceSet()
+    : pickTreeValid(false), pickTreeCoordId(0)
 {
     SO_NODE_CONSTRUCTOR(SoBrepFaceSet);
     SO_NODE_ADD_FIELD(partIndex, (-1));
@@ -1011,21 +1015,140 @@ SoDetail * SoBrepFaceSet::createTriangleDetail(SoRayPickAction * action,
                                                SoPickedPoint * pp)
 {
     SoDetail* detail = inherited::createTriangleDetail(action, v1, v2, v3, pp);
+    SoFaceDetail* face_detail = static_cast<SoFaceDetail*>(detail);
+    int part = findPartIndex(face_detail->getFaceIndex());
+    if (part >= 0)
+        face_detail->setPartIndex(part);
+    return detail;
+}
+
+int SoBrepFaceSet::findPartIndex(int faceIndex) const
+{
     const int32_t * indices = this->partIndex.getValues(0);
     int num = this->partIndex.getNum();
     if (indices) {
-        SoFaceDetail* face_detail = static_cast<SoFaceDetail*>(detail);
-        int index = face_detail->getFaceIndex();
         int count = 0;
         for (int i=0; i<num; i++) {
             count += indices[i];
-            if (index < count) {
-                face_detail->setPartIndex(i);
-                break;
+            if (faceIndex < count)
+                return i;
+        }
+    }
+    return -1;
+}
+
+void SoBrepFaceSet::notify(SoNotList * list)
+{
+    SoField *f = list->getLastField();
+    if (f == &this->coordIndex) {
+        this->pickTree.clear();
+        this->pickTreeValid = false;
+    }
+    inherited::notify(list);
+}
+
+/**
+ * Builds the tree of the bounding boxes of all triangles. Returns false if the
+ * face set contains other polygons than triangles.
+ */
+bool SoBrepFaceSet::buildPickTree(const SoCoordinateElement* coords)
+{
+    this->pickTree.clear();
+
+    const int32_t* cindices = this->coordIndex.getValues(0);
+    int numindices = this->coordIndex.getNum();
+    int numcoords = coords->getNum();
+
+    std::vector<SbBox3f> boxes;
+    boxes.reserve(numindices / 4);
+    for (int i = 0; i + 2 < numindices; i += 4) {
+        int32_t v1 = cindices[i];
+        int32_t v2 = cindices[i+1];
+        int32_t v3 = cindices[i+2];
+        if (v1 < 0 || v2 < 0 || v3 < 0)
+            break;
+        if (i + 3 < numindices && cindices[i+3] >= 0)
+            return false; // not a triangle
+        if (v1 >= numcoords || v2 >= numcoords || v3 >= numcoords)
+            return false;
+
+        SbBox3f box;
+        box.extendBy(coords->get3(v1));
+        box.extendBy(coords->get3(v2));
+        box.extendBy(coords->get3(v3));
+        boxes.push_back(box);
+    }
+
+    this->pickTree.build(boxes);
+    return true;
+}
+
+/**
+ * Instead of going through all triangles with generatePrimitives() only the triangles are
+ * tested against the pick ray whose bounding box is hit. If the face set contains other
+ * polygons than triangles the default implementation is used.
+ */
+void SoBrepFaceSet::rayPick(SoRayPickAction *action)
+{
+    if (this->vertexProperty.getValue()) {
+        inherited::rayPick(action);
+        return;
+    }
+
+    if (!this->shouldRayPick(action))
+        return;
+
+    SoState* state = action->getState();
+    const SoCoordinateElement* coords = SoCoordinateElement::getInstance(state);
+    if (!this->pickTreeValid || this->pickTreeCoordId != coords->getNodeId()) {
+        this->pickTreeValid = true;
+        this->pickTreeCoordId = coords->getNodeId();
+        if (!buildPickTree(coords))
+            this->pickTree.clear();
+    }
+
+    if (this->pickTree.isEmpty()) {
+        inherited::rayPick(action);
+        return;
+    }
+
+    this->computeObjectSpaceRay(action);
+
+    std::vector<int> triangles;
+    this->pickTree.intersect(action, triangles);
+
+    const int32_t* cindices = this->coordIndex.getValues(0);
+    for (std::vector<int>::iterator it = triangles.begin(); it != triangles.end(); ++it) {
+        const int32_t* tria = cindices + 4 * (*it);
+        const SbVec3f& p1 = coords->get3(tria[0]);
+        const SbVec3f& p2 = coords->get3(tria[1]);
+        const SbVec3f& p3 = coords->get3(tria[2]);
+
+        SbVec3f isect, bary;
+        SbBool front;
+        if (!action->intersect(p1, p2, p3, isect, bary, front) || !action->isBetweenPlanes(isect))
+            continue;
+
+        SoPickedPoint* pp = action->addIntersection(isect);
+        if (pp) {
+            SbVec3f normal = (p2 - p1).cross(p3 - p1);
+            normal.normalize();
+            pp->setObjectNormal(normal);
+
+            SoFaceDetail* detail = new SoFaceDetail();
+            detail->setFaceIndex(*it);
+            int part = findPartIndex(*it);
+            if (part >= 0)
+                detail->setPartIndex(part);
+            detail->setNumPoints(3);
+            SoPointDetail point;
+            for (int i = 0; i < 3; i++) {
+                point.setCoordinateIndex(tria[i]);
+                detail->setPoint(i, &point);
             }
+            pp->setDetail(detail, this);
         }
     }
-    return detail;
 }
 
 SoBrepFaceSet::Binding
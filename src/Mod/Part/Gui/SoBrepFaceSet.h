@@ -32,7 +32,9 @@
 #include <Inventor/elements/SoLazyElement.h>
 #include <Inventor/elements/SoReplacedElement.h>
 #include <vector>
+#include <Gui/SoFCRayPickTree.h>
 
+class SoCoordinateElement;
 class SoGLCoordinateElement;
 class SoTextureCoordinateBundle;
 
@@ -100,6 +102,8 @@ protected:
         const SoPrimitiveVertex * v3,
         SoPickedPoint * pp);
     virtual void generatePrimitives(SoAction * action);
+    virtual void rayPick(SoRayPickAction *action);
+    virtual void notify(SoNotList * list);
 
 private:
     enum Binding {
@@ -130,6 +134,8 @@ private:
                      const int texture);
     void renderHighlight(SoGLRenderAction *action);
     void renderSelection(SoGLRenderAction *action);
+    int findPartIndex(int faceIndex) const;
+    bool buildPickTree(const SoCoordinateElement* coords);
 
 #ifdef RENDER_GLARRAYS
     void renderSimpleArray();
@@ -144,6 +150,11 @@ private:
     SbColor selectionColor;
     SbColor highlightColor;
     SoColorPacker colorpacker;
+
+    // triangles sorted into a tree to speed up picking
+    Gui::SoFCRayPickTree pickTree;
+    bool pickTreeValid;
+    uint32_t pickTreeCoordId;
 };
 
 } // namespace PartGui
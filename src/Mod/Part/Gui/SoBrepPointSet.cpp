@@ -41,6 +41,7 @@
 # include <Inventor/actions/SoGetPrimitiveCountAction.h>
 # include <Inventor/actions/SoGLRenderAction.h>
 # include <Inventor/actions/SoPickAction.h>
+# include <Inventor/actions/SoRayPickAction.h>
 # include <Inventor/actions/SoWriteAction.h>
 # include <Inventor/bundles/SoMaterialBundle.h>
 # include <Inventor/bundles/SoTextureCoordinateBundle.h>
@@ -54,6 +55,8 @@
 # include <Inventor/errors/SoReadError.h>
 # include <Inventor/details/SoFaceDetail.h>
 # include <Inventor/details/SoLineDetail.h>
+# include <Inventor/details/SoPointDetail.h>
+# include <Inventor/misc/SoNotification.h>
 # include <Inventor/misc/SoState.h>
 #endif
 
@@ -72,6 +75,7 @@ void SoBrepPointSet::initClass()
 }
 
 SoBrepPointSet::SoBrepPointSet()
+    : pickTreeStart(0), pickTreeValid(false), pickTreeCoordId(0)
 {
     SO_NODE_CONSTRUCTOR(SoBrepPointSet);
     SO_NODE_ADD_FIELD(highlightIndex, (-1));
@@ -270,3 +274,75 @@ void SoBrepPointSet::doAction(SoAction* action)
 
     inherited::doAction(action);
 }
+
+void SoBrepPointSet::notify(SoNotList * list)
+{
+    SoField *f = list->getLastField();
+    if (f == &this->startIndex || f == &this->numPoints) {
+        this->pickTree.clear();
+        this->pickTreeValid = false;
+    }
+    inherited::notify(list);
+}
+
+/**
+ * Builds the tree of all points.
+ */
+void SoBrepPointSet::buildPickTree(const SoCoordinateElement* coords)
+{
+    int32_t start = std::max<int32_t>(this->startIndex.getValue(), 0);
+    int32_t end = coords->getNum();
+    if (this->numPoints.getValue() >= 0)
+        end = std::min<int32_t>(end, start + this->numPoints.getValue());
+
+    std::vector<SbBox3f> boxes;
+    for (int32_t i = start; i < end; i++) {
+        const SbVec3f& pnt = coords->get3(i);
+        boxes.push_back(SbBox3f(pnt, pnt));
+    }
+
+    this->pickTreeStart = start;
+    this->pickTree.build(boxes);
+}
+
+/**
+ * Instead of going through all points with generatePrimitives() only the points are
+ * tested against the pick ray that are close to it.
+ */
+void SoBrepPointSet::rayPick(SoRayPickAction *action)
+{
+    if (this->vertexProperty.getValue()) {
+        inherited::rayPick(action);
+        return;
+    }
+
+    if (!this->shouldRayPick(action))
+        return;
+
+    SoState* state = action->getState();
+    const SoCoordinateElement* coords = SoCoordinateElement::getInstance(state);
+    if (!this->pickTreeValid || this->pickTreeCoordId != coords->getNodeId()) {
+        this->pickTreeValid = true;
+        this->pickTreeCoordId = coords->getNodeId();
+        buildPickTree(coords);
+    }
+
+    this->computeObjectSpaceRay(action);
+
+    std::vector<int> points;
+    this->pickTree.intersect(action, points);
+
+    for (std::vector<int>::iterator it = points.begin(); it != points.end(); ++it) {
+        int32_t index = this->pickTreeStart + *it;
+        const SbVec3f& pnt = coords->get3(index);
+        if (!action->intersect(pnt) || !action->isBetweenPlanes(pnt))
+            continue;
+
+        SoPickedPoint* pp = action->addIntersection(pnt);
+        if (pp) {
+            SoPointDetail* detail = new SoPointDetail();
+            detail->setCoordinateIndex(index);
+            pp->setDetail(detail, this);
+        }
+    }
+}
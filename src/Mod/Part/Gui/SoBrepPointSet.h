@@ -32,6 +32,7 @@
 #include <Inventor/elements/SoLazyElement.h>
 #include <Inventor/elements/SoReplacedElement.h>
 #include <vector>
+#include <Gui/SoFCRayPickTree.h>
 
 class SoCoordinateElement;
 class SoGLCoordinateElement;
@@ -56,6 +57,8 @@ protected:
     virtual void GLRender(SoGLRenderAction *action);
     virtual void GLRenderBelowPath(SoGLRenderAction * action);
     virtual void doAction(SoAction* action); 
+    virtual void rayPick(SoRayPickAction *action);
+    virtual void notify(SoNotList * list);
 
 private:
     void renderShape(const SoGLCoordinateElement * const vertexlist,
@@ -64,11 +67,18 @@ private:
     void renderHighlight(SoGLRenderAction *action);
     void renderSelection(SoGLRenderAction *action);
     bool validIndexes(const SoCoordinateElement*, int32_t, const int32_t *, int) const;
+    void buildPickTree(const SoCoordinateElement* coords);
 
 private:
     SbColor selectionColor;
     SbColor highlightColor;
     SoColorPacker colorpacker;
+
+    // points sorted into a tree to speed up picking
+    Gui::SoFCRayPickTree pickTree;
+    int32_t pickTreeStart;
+    bool pickTreeValid;
+    uint32_t pickTreeCoordId;
 };
 
 } // namespace PartGui
@@ -25,6 +25,7 @@
 
 #ifndef _PreComp_
 # include <sstream>
+# include <algorithm>
 # include <Bnd_Box.hxx>
 # include <Poly_Polygon3D.hxx>
 # include <BRepBndLib.hxx>
@@ -125,6 +126,185 @@ using namespace PartGui;
 
 PROPERTY_SOURCE(PartGui::ViewProviderPartExt, Gui::ViewProviderGeometryObject)
 
+/**
+ * Remembers where the faces of the last update are stored in the Inventor
+ * nodes. When a feature is recomputed most of its faces usually keep their
+ * TShape, placement and triangulation so that their points, normals and
+ * triangles can be copied from the last update instead of evaluating the
+ * surface normals again.
+ * Only the offsets are kept between two updates. The old node data is
+ * copied once at the beginning of an update because the nodes are refilled
+ * in place, and released when the update is done.
+ */
+class ViewProviderPartExt::FaceCache
+{
+public:
+    struct Entry
+    {
+        TopoDS_Face face;
+        Handle(Poly_Triangulation) mesh;
+        int nodeOffset;
+        int triaOffset;
+    };
+    typedef std::multimap<int, Entry> EntryMap;
+
+    FaceCache() : numReused(0)
+    {
+    }
+
+    /// Starts a new update, entries not used until the call of finish() are dropped
+    void begin(const SoCoordinate3* coords, const SoNormal* norm, const SoIndexedFaceSet* faceset)
+    {
+        used.clear();
+        numReused = 0;
+        if (!entries.empty()) {
+            const SbVec3f* p = coords->point.getValues(0);
+            points.assign(p, p + coords->point.getNum());
+            const SbVec3f* n = norm->vector.getValues(0);
+            normals.assign(n, n + norm->vector.getNum());
+            const int32_t* i = faceset->coordIndex.getValues(0);
+            index.assign(i, i + faceset->coordIndex.getNum());
+        }
+    }
+    void finish()
+    {
+        entries.swap(used);
+        clearData();
+    }
+    /// Drops all entries, must be called if the nodes are changed otherwise
+    void clear()
+    {
+        entries.clear();
+        clearData();
+    }
+    int countReused() const
+    {
+        return numReused;
+    }
+    /// Writes all nodes and the triangles of the face at the given offsets
+    void write(ViewProviderPartExt* vp, const TopoDS_Face& face,
+               const TopLoc_Location& loc,
+               const Handle(Poly_Triangulation)& mesh,
+               int nodeOffset, int triaOffset,
+               SbVec3f* verts, SbVec3f* norms, int32_t* faceIndex)
+    {
+        int hash = face.HashCode(INT_MAX);
+        Entry entry;
+        entry.face = face;
+        entry.mesh = mesh;
+        entry.nodeOffset = nodeOffset;
+        entry.triaOffset = triaOffset;
+
+        bool found = false;
+        std::pair<EntryMap::iterator, EntryMap::iterator> range = entries.equal_range(hash);
+        for (EntryMap::iterator it = range.first; it != range.second; ++it) {
+            // same TShape, location and orientation and the face hasn't been re-meshed
+            if (it->second.face.IsEqual(face) && it->second.mesh == mesh) {
+                reuse(it->second, entry, verts, norms, faceIndex);
+                entries.erase(it);
+                numReused++;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+            fill(vp, face, loc, mesh, entry, verts, norms, faceIndex);
+        used.insert(std::make_pair(hash, entry));
+    }
+
+private:
+    void clearData()
+    {
+        used.clear();
+        std::vector<SbVec3f>().swap(points);
+        std::vector<SbVec3f>().swap(normals);
+        std::vector<int32_t>().swap(index);
+    }
+    void reuse(const Entry& from, const Entry& to,
+              SbVec3f* verts, SbVec3f* norms, int32_t* faceIndex)
+    {
+        int nbNodes = to.mesh->NbNodes();
+        std::copy(points.begin() + from.nodeOffset,
+                  points.begin() + from.nodeOffset + nbNodes, verts + to.nodeOffset);
+        std::copy(normals.begin() + from.nodeOffset,
+                  normals.begin() + from.nodeOffset + nbNodes, norms + to.nodeOffset);
+
+        int nbTriInFace = to.mesh->NbTriangles();
+        if (nbTriInFace == 0)
+            return;
+        const int32_t* src = &index[4*from.triaOffset];
+        int32_t* dst = faceIndex + 4*to.triaOffset;
+        int shift = to.nodeOffset - from.nodeOffset;
+        for (int g=0;g<nbTriInFace;g++) {
+            dst[4*g]   = src[4*g]   + shift;
+            dst[4*g+1] = src[4*g+1] + shift;
+            dst[4*g+2] = src[4*g+2] + shift;
+            dst[4*g+3] = SO_END_FACE_INDEX;
+        }
+    }
+    void fill(ViewProviderPartExt* vp, const TopoDS_Face& face,
+              const TopLoc_Location& loc,
+              const Handle(Poly_Triangulation)& mesh, const Entry& entry,
+              SbVec3f* verts, SbVec3f* norms, int32_t* faceIndex)
+    {
+        // getting the transformation of the shape/face
+        gp_Trsf myTransf;
+        Standard_Boolean identity = true;
+        if (!loc.IsIdentity()) {
+            identity = false;
+            myTransf = loc.Transformation();
+        }
+
+        const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
+        const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
+        TColgp_Array1OfDir Normals (Nodes.Lower(), Nodes.Upper());
+        vp->GetNormals(face, mesh, Normals);
+
+        // all nodes are taken because some of them may only be referenced
+        // by the polygon of an edge but not by any triangle
+        SbVec3f* v = verts + entry.nodeOffset;
+        SbVec3f* n = norms + entry.nodeOffset;
+        for (Standard_Integer i=Nodes.Lower(); i<=Nodes.Upper(); i++, v++, n++) {
+            gp_Pnt V(Nodes(i));
+            gp_Dir NV(Normals(i));
+            if (!identity) {
+                V.Transform(myTransf);
+                NV.Transform(myTransf);
+            }
+            v->setValue((float)(V.X()),(float)(V.Y()),(float)(V.Z()));
+            n->setValue((float)(NV.X()),(float)(NV.Y()),(float)(NV.Z()));
+            n->normalize();
+        }
+
+        // set the index vector with the 3 point indexes and the end delimiter,
+        // change orientation of the triangles if the face is reversed
+        bool reversed = (face.Orientation() != TopAbs_FORWARD);
+        int nbTriInFace = mesh->NbTriangles();
+        int32_t* dst = faceIndex + 4*entry.triaOffset;
+        int offset = entry.nodeOffset - Nodes.Lower();
+        for (int g=1;g<=nbTriInFace;g++, dst+=4) {
+            Standard_Integer N1,N2,N3;
+            Triangles(g).Get(N1,N2,N3);
+            if (reversed)
+                std::swap(N1,N2);
+            dst[0] = offset+N1;
+            dst[1] = offset+N2;
+            dst[2] = offset+N3;
+            dst[3] = SO_END_FACE_INDEX;
+        }
+    }
+
+private:
+    EntryMap entries;
+    EntryMap used;
+    // data of the last update, only kept while an update is running
+    std::vector<SbVec3f> points;
+    std::vector<SbVec3f> normals;
+    std::vector<int32_t> index;
+    int numReused;
+};
+
 
 void ViewProviderPartExt::GetNormals(const TopoDS_Face&  theFace,
              const Handle(Poly_Triangulation)& aPolyTri,
@@ -224,6 +404,7 @@ const char* ViewProviderPartExt::LightingEnums[]= {"One side","Two side",NULL};
 const char* ViewProviderPartExt::DrawStyleEnums[]= {"Solid","Dashed","Dotted","Dashdot",NULL};
 
 ViewProviderPartExt::ViewProviderPartExt() 
+  : faceCache(new FaceCache())
 {
     VisualTouched = true;
 
@@ -320,6 +501,7 @@ ViewProviderPartExt::~ViewProviderPartExt()
     normb->unref();
     lineset->unref();
     nodeset->unref();
+    delete faceCache;
 }
 
 void ViewProviderPartExt::onChanged(const App::Property* prop)
@@ -872,6 +1054,7 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
 
     TopoDS_Shape cShape(inputShape);
     if (cShape.IsNull()) {
+        faceCache->clear();
         coords  ->point      .setNum(0);
         norm    ->vector     .setNum(0);
         faceset ->coordIndex .setNum(0);
@@ -885,6 +1068,7 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
     // time measurement and book keeping
     Base::TimeInfo start_time;
     int numTriangles=0,numNodes=0,numNorms=0,numFaces=0,numEdges=0,numLines=0;
+    int numReusedFaces=0;
     std::set<int> faceEdges;
 
     try {
@@ -967,6 +1151,9 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
         TopExp::MapShapes(cShape, TopAbs_VERTEX, vertexMap);
         numNodes += vertexMap.Extent();
 
+        // the data of the last update is needed for the unchanged faces
+        faceCache->begin(coords, norm, faceset);
+
         // create memory for the nodes and indexes
         coords  ->point      .setNum(numNodes);
         norm    ->vector     .setNum(numNorms);
@@ -978,10 +1165,6 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
         int32_t* index = faceset ->coordIndex  .startEditing();
         int32_t* parts = faceset ->partIndex   .startEditing();
 
-        // preset the normal vector with null vector
-        for (int i=0;i < numNorms;i++)
-            norms[i]= SbVec3f(0.0,0.0,0.0);
-
         int ii = 0,faceNodeOffset=0,faceTriaOffset=0;
         for (int i=1; i <= faceMap.Extent(); i++, ii++) {
             TopLoc_Location aLoc;
@@ -990,71 +1173,14 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
             Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace,aLoc);
             if (mesh.IsNull()) continue;
 
-            // getting the transformation of the shape/face
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
-                identity = false;
-                myTransf = aLoc.Transformation();
-            }
-
             // getting size of node and triangle array of this face
             int nbNodesInFace = mesh->NbNodes();
             int nbTriInFace   = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
 
-            // cycling through the poly mesh
-            const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
-            const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
-            TColgp_Array1OfDir Normals (Nodes.Lower(), Nodes.Upper());
-            GetNormals(actFace, mesh, Normals);
-            
-            for (int g=1;g<=nbTriInFace;g++) {
-                // Get the triangle
-                Standard_Integer N1,N2,N3;
-                Triangles(g).Get(N1,N2,N3);
-
-                // change orientation of the triangle if the face is reversed
-                if ( orient != TopAbs_FORWARD ) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-
-                // get the 3 points of this triangle
-                gp_Pnt V1(Nodes(N1)), V2(Nodes(N2)), V3(Nodes(N3));
-
-                // get the 3 normals of this triangle
-                gp_Dir NV1(Normals(N1)), NV2(Normals(N2)), NV3(Normals(N3));                
-
-                // transform the vertices and normals to the place of the face
-                if(!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                    NV1.Transform(myTransf);
-                    NV2.Transform(myTransf);
-                    NV3.Transform(myTransf);
-                }
-
-                // add the normals for all points of this triangle
-                norms[faceNodeOffset+N1-1] += SbVec3f(NV1.X(),NV1.Y(),NV1.Z());
-                norms[faceNodeOffset+N2-1] += SbVec3f(NV2.X(),NV2.Y(),NV2.Z());
-                norms[faceNodeOffset+N3-1] += SbVec3f(NV3.X(),NV3.Y(),NV3.Z());
-
-                // set the vertices
-                verts[faceNodeOffset+N1-1].setValue((float)(V1.X()),(float)(V1.Y()),(float)(V1.Z()));
-                verts[faceNodeOffset+N2-1].setValue((float)(V2.X()),(float)(V2.Y()),(float)(V2.Z()));
-                verts[faceNodeOffset+N3-1].setValue((float)(V3.X()),(float)(V3.Y()),(float)(V3.Z()));
-
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[faceTriaOffset*4+4*(g-1)]   = faceNodeOffset+N1-1;
-                index[faceTriaOffset*4+4*(g-1)+1] = faceNodeOffset+N2-1;
-                index[faceTriaOffset*4+4*(g-1)+2] = faceNodeOffset+N3-1;
-                index[faceTriaOffset*4+4*(g-1)+3] = SO_END_FACE_INDEX;
-            }
+            // the points, normals and triangles are copied from the last
+            // update if the face hasn't changed since then
+            faceCache->write(this, actFace, aLoc, mesh, faceNodeOffset, faceTriaOffset,
+                             verts, norms, index);
 
             parts[ii] = nbTriInFace; // new part
 
@@ -1079,16 +1205,6 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
                         int nodeIndex = indices(i);
                         int index = faceNodeOffset+nodeIndex-1;
                         lineSetMap[edgeIndex].push_back(index);
-
-                        // usually the coordinates for this edge are already set by the
-                        // triangles of the face this edge belongs to. However, there are
-                        // rare cases where some points are only referenced by the polygon
-                        // but not by any triangle. Thus, we must apply the coordinates to
-                        // make sure that everything is properly set.
-                        gp_Pnt p(Nodes(nodeIndex));
-                        if (!identity)
-                            p.Transform(myTransf);
-                        verts[index].setValue((float)(p.X()),(float)(p.Y()),(float)(p.Z()));
                     }
 
                     // remove the handled edge index from the set
@@ -1103,6 +1219,9 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
             faceTriaOffset += nbTriInFace;
         }
 
+        numReusedFaces = faceCache->countReused();
+        faceCache->finish();
+
         // handling of the free edges
         for (int i=1; i <= edgeMap.Extent(); i++) {
             const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
@@ -1145,10 +1264,6 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
             verts[faceNodeOffset+i].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
         }
 
-        // normalize all normals 
-        for (int i = 0; i< numNorms ;i++)
-            norms[i].normalize();
-        
         std::vector<int32_t> lineSetCoords;
         for (std::map<int, std::vector<int32_t> >::iterator it = lineSetMap.begin(); it != lineSetMap.end(); ++it) {
             lineSetCoords.insert(lineSetCoords.end(), it->second.begin(), it->second.end());
@@ -1172,13 +1287,17 @@ void ViewProviderPartExt::updateVisual(const TopoDS_Shape& inputShape)
         lineset ->coordIndex  .finishEditing();
     }
     catch (...) {
+        faceCache->clear();
         Base::Console().Error("Cannot compute Inventor representation for the shape of %s.\n",pcObject->getNameInDocument());
     }
 
 #   ifdef FC_DEBUG
         // printing some informations
-        Base::Console().Log("ViewProvider update time: %f s\n",Base::TimeInfo::diffTimeF(start_time,Base::TimeInfo()));
         Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",numFaces,numEdges,numNodes,numTriangles,numLines);
 #   endif
+    const char* name = pcObject ? pcObject->getNameInDocument() : 0;
+    Base::Console().Log("Shape tria update of %s: %d of %d faces reused (%f s)\n",
+        name ? name : "", numReusedFaces, numFaces,
+        Base::TimeInfo::diffTimeF(start_time,Base::TimeInfo()));
     VisualTouched = false;
 }
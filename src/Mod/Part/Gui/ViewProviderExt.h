@@ -166,6 +166,9 @@ private:
     // settings stuff
     bool noPerVertexNormals;
     bool qualityNormals;
+    // where the faces of the last update are stored, see updateVisual()
+    class FaceCache;
+    FaceCache* faceCache;
     static App::PropertyFloatConstraint::Constraints sizeRange;
     static App::PropertyFloatConstraint::Constraints tessRange;
     static App::PropertyQuantityConstraint::Constraints angDeflectionRange;
@@ -35,7 +35,52 @@ class PartTestCases(unittest.TestCase):
 		self.Box = App.ActiveDocument.addObject("Part::Box","Box")
 		self.Doc.recompute()
 		self.failUnless(len(self.Box.Shape.Faces)==6)
-		
+
+	def testRemoveSplitter(self):
+		box1 = Part.makeBox(10,10,10)
+		box2 = Part.makeBox(10,10,10,App.Vector(10,0,0))
+		box3 = Part.makeBox(10,10,10,App.Vector(0,10,0))
+		fusion = box1.fuse(box2).fuse(box3)
+		refined = fusion.removeSplitter()
+		self.failUnless(len(refined.Faces)==8)
+		self.failUnless(refined.isValid())
+		self.assertAlmostEqual(refined.Volume, 3000.0, 6)
+
+		cyl1 = Part.makeCylinder(2,5)
+		cyl2 = Part.makeCylinder(2,5,App.Vector(0,0,5))
+		cyl3 = Part.makeCylinder(3,5,App.Vector(0,0,10))
+		refined = cyl1.fuse(cyl2).fuse(cyl3).removeSplitter()
+		self.failUnless(len(refined.Faces)==5)
+		self.failUnless(refined.isValid())
+
+	def testSlices(self):
+		shape = Part.makeTorus(10,2).fuse(Part.makeBox(5,5,5))
+		heights = [-3.0 + 0.25*i for i in range(25)]
+		serial = shape.slices(App.Vector(0,0,1), heights)
+		parallel = shape.slices(App.Vector(0,0,1), heights, 4)
+		self.failUnless(len(serial.Wires) > 0)
+		self.failUnless(len(serial.Wires) == len(parallel.Wires))
+		for w1, w2 in zip(serial.Wires, parallel.Wires):
+			self.assertAlmostEqual(w1.Length, w2.Length, 6)
+			self.assertAlmostEqual(w1.BoundBox.ZMin, w2.BoundBox.ZMin, 6)
+
+	def testBooleansInThreads(self):
+		import threading
+		shapes = [Part.makeBox(10,10,10,App.Vector(5*i,0,0)) for i in range(8)]
+		# every thread works on its own shapes
+		tools = [Part.makeCylinder(3,20,App.Vector(5*i+5,5,-5)) for i in range(8)]
+		serial = [s.cut(t).fuse(t).Volume for s, t in zip(shapes, tools)]
+		results = [None] * len(shapes)
+		def run(i):
+			results[i] = shapes[i].cut(tools[i]).fuse(tools[i]).Volume
+		threads = [threading.Thread(target=run, args=(i,)) for i in range(len(shapes))]
+		for t in threads:
+			t.start()
+		for t in threads:
+			t.join()
+		for v1, v2 in zip(serial, results):
+			self.assertAlmostEqual(v1, v2, 6)
+
 	def tearDown(self):
 		#closing doc
 		FreeCAD.closeDocument("PartTest")
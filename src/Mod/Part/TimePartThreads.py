@@ -0,0 +1,65 @@
+#   (c) FreeCAD Developers 2017                               LGPL        *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+# Times the Part booleans run from several Python threads at once. The
+# wrappers release the GIL while OCC computes, so the wall time for the same
+# set of jobs should drop with the number of threads up to the number of
+# cores. Run it with FreeCADCmd TimePartThreads.py or import it and call
+# timeThreads() from the Python console.
+
+import FreeCAD, Part, threading, time
+App = FreeCAD
+
+
+def makeJobs(count):
+	# every job gets its own shapes so that no shape is shared by threads
+	jobs = []
+	for i in range(count):
+		shape = Part.makeSphere(10, App.Vector(5*i,0,0)).fuse(Part.makeBox(12,12,12,App.Vector(5*i,0,0)))
+		tool = Part.makeCylinder(4,30,App.Vector(5*i+3,3,-15))
+		jobs.append((shape, tool))
+	return jobs
+
+def runJobs(jobs, numThreads):
+	chunks = [jobs[i::numThreads] for i in range(numThreads)]
+	def work(chunk):
+		for shape, tool in chunk:
+			shape.cut(tool).fuse(tool).common(shape)
+	threads = [threading.Thread(target=work, args=(c,)) for c in chunks]
+	start = time.time()
+	for t in threads:
+		t.start()
+	for t in threads:
+		t.join()
+	return time.time() - start
+
+def timeThreads(count=32, numThreads=(1,2,4,8)):
+	jobs = makeJobs(count)
+	runJobs(jobs[:1], 1) # warm up
+	serial = None
+	for n in numThreads:
+		elapsed = runJobs(jobs, n)
+		if serial is None:
+			serial = elapsed
+		App.Console.PrintMessage("%d jobs, %d threads: %.3f s, speedup %.2f\n" % (count, n, elapsed, serial / elapsed))
+
+if __name__ == "__main__":
+	timeThreads()
@@ -23,6 +23,7 @@
 
 #include "PreCompiled.h"
 
+#include <Base/Interpreter.h>
 #include "Mod/Path/App/Path.h"
 
 // inclusion of the generated files (generated out of PathPy.xml)
@@ -177,7 +178,11 @@ PyObject* PathPy::deleteCommand(PyObject * args)
 PyObject* PathPy::toGCode(PyObject * args)
 {
     if (PyArg_ParseTuple(args, "")) {
-        std::string result = getToolpathPtr()->toGCode();
+        std::string result;
+        {
+            Base::PyGILStateRelease unlock;
+            result = getToolpathPtr()->toGCode();
+        }
         return PyString_FromString(result.c_str());
     }
     throw Py::Exception("This method accepts no argument");
@@ -188,7 +193,10 @@ PyObject* PathPy::setFromGCode(PyObject * args)
     char *pstr=0;
     if (PyArg_ParseTuple(args, "s", &pstr)) {
         std::string gcode(pstr);
-        getToolpathPtr()->setFromGCode(gcode);
+        {
+            Base::PyGILStateRelease unlock;
+            getToolpathPtr()->setFromGCode(gcode);
+        }
         Py_INCREF(Py_None);
         return Py_None;
     }
@@ -29,6 +29,7 @@
 
 #include <boost/math/special_functions/fpclassify.hpp>
 
+#include <Base/BatchTransform.h>
 #include <Base/Exception.h>
 #include <Base/Matrix.h>
 #include <Base/Persistence.h>
@@ -72,9 +73,7 @@ Data::Segment* PointKernel::getSubElement(const char* /*Type*/, unsigned long /*
 
 void PointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
-    std::vector<value_type>& kernel = getBasicPoints();
-    for (std::vector<value_type>::iterator it = kernel.begin(); it != kernel.end(); ++it)
-        *it = rclMat * (*it);
+    Base::BatchTransform(rclMat).apply(getBasicPoints());
 }
 
 Base::BoundBox3d PointKernel::getBoundBox(void)const
@@ -0,0 +1,233 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+#endif
+
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+#include <Eigen/Eigenvalues>
+
+#include "Points.h"
+#include "PointsAnalysis.h"
+#include "PointsKdTree.h"
+
+using namespace Points;
+
+namespace Points {
+struct NormalEstimation::Range
+{
+    unsigned long begin, end;
+    const PointsKdTree* tree;
+    std::vector<Base::Vector3d>* normals;
+};
+
+struct OutlierRemoval::Range
+{
+    unsigned long begin, end;
+    const PointsKdTree* tree;
+    std::vector<double>* meanDist;
+};
+
+template <class RangeT>
+static std::vector<RangeT> splitPointRange(unsigned long count, bool parallel)
+{
+    unsigned long numChunks = 1;
+    if (parallel && count > 1000)
+        numChunks = std::min<unsigned long>(count / 500, 8 * std::max(QThread::idealThreadCount(), 1));
+
+    std::vector<RangeT> ranges(numChunks);
+    unsigned long chunk = count / numChunks;
+    for (unsigned long i = 0; i < numChunks; i++) {
+        ranges[i].begin = i * chunk;
+        ranges[i].end = (i + 1 == numChunks) ? count : (i + 1) * chunk;
+    }
+    return ranges;
+}
+}
+
+NormalEstimation::NormalEstimation(const PointKernel& pts)
+  : myPoints(pts)
+  , kSearch(10)
+  , searchRadius(0)
+{
+}
+
+NormalEstimation::~NormalEstimation()
+{
+}
+
+void NormalEstimation::computeRange(Range& range) const
+{
+    const std::vector<Base::Vector3f>& pts = myPoints.getBasicPoints();
+    std::vector<unsigned long> indices;
+    std::vector<float> sqrDist;
+    unsigned long k = static_cast<unsigned long>(std::max(kSearch, 3));
+
+    for (unsigned long i = range.begin; i < range.end; i++) {
+        if (searchRadius > 0)
+            range.tree->RadiusSearch(pts[i], static_cast<float>(searchRadius), indices);
+        else
+            range.tree->NearestNeighbours(pts[i], k, indices, sqrDist);
+
+        Base::Vector3d& normal = (*range.normals)[i];
+        if (indices.size() < 3) {
+            normal.Set(0.0, 0.0, 0.0);
+            continue;
+        }
+
+        // covariance matrix of the neighbourhood
+        Eigen::Vector3d mean(0.0, 0.0, 0.0);
+        for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+            const Base::Vector3f& p = pts[*it];
+            mean += Eigen::Vector3d(p.x, p.y, p.z);
+        }
+        mean /= static_cast<double>(indices.size());
+
+        Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+        for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+            const Base::Vector3f& p = pts[*it];
+            Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - mean;
+            cov += d * d.transpose();
+        }
+
+        // the eigenvalues are sorted in increasing order
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(cov);
+        Eigen::Vector3d n = eig.eigenvectors().col(0);
+        normal.Set(n[0], n[1], n[2]);
+    }
+}
+
+void NormalEstimation::perform(std::vector<Base::Vector3d>& normals, bool parallel)
+{
+    const std::vector<Base::Vector3f>& pts = myPoints.getBasicPoints();
+    normals.clear();
+    normals.resize(pts.size());
+    if (pts.empty())
+        return;
+
+    PointsKdTree tree(pts);
+    std::vector<Range> ranges = splitPointRange<Range>(pts.size(), parallel);
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        it->tree = &tree;
+        it->normals = &normals;
+    }
+
+    if (ranges.size() == 1) {
+        computeRange(ranges.front());
+    }
+    else {
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&NormalEstimation::computeRange, this, _1));
+        future.waitForFinished();
+    }
+
+    // the points are stored untransformed, so the normals must be rotated
+    Base::Matrix4D mat = myPoints.getTransform();
+    if (mat != Base::Matrix4D()) {
+        Base::Vector3d base = mat * Base::Vector3d(0.0, 0.0, 0.0);
+        for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it) {
+            if (it->Sqr() > 0.0) {
+                *it = mat * (*it) - base;
+                it->Normalize();
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+OutlierRemoval::OutlierRemoval(const PointKernel& pts)
+  : myPoints(pts)
+  , kSearch(8)
+  , stdDevMult(1.0)
+{
+}
+
+OutlierRemoval::~OutlierRemoval()
+{
+}
+
+void OutlierRemoval::computeRange(Range& range) const
+{
+    const std::vector<Base::Vector3f>& pts = myPoints.getBasicPoints();
+    std::vector<unsigned long> indices;
+    std::vector<float> sqrDist;
+    // the query point itself is always the first neighbour
+    unsigned long k = static_cast<unsigned long>(std::max(kSearch, 1)) + 1;
+
+    for (unsigned long i = range.begin; i < range.end; i++) {
+        range.tree->NearestNeighbours(pts[i], k, indices, sqrDist);
+        double sum = 0.0;
+        for (std::size_t j = 1; j < sqrDist.size(); j++)
+            sum += std::sqrt(sqrDist[j]);
+        (*range.meanDist)[i] = sqrDist.size() > 1 ? sum / (sqrDist.size() - 1) : 0.0;
+    }
+}
+
+void OutlierRemoval::perform(std::vector<unsigned long>& outliers, bool parallel)
+{
+    const std::vector<Base::Vector3f>& pts = myPoints.getBasicPoints();
+    outliers.clear();
+    if (pts.size() < 2)
+        return;
+
+    PointsKdTree tree(pts);
+    std::vector<double> meanDist(pts.size());
+    std::vector<Range> ranges = splitPointRange<Range>(pts.size(), parallel);
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        it->tree = &tree;
+        it->meanDist = &meanDist;
+    }
+
+    if (ranges.size() == 1) {
+        computeRange(ranges.front());
+    }
+    else {
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&OutlierRemoval::computeRange, this, _1));
+        future.waitForFinished();
+    }
+
+    double sum = 0.0, sqrSum = 0.0;
+    for (std::vector<double>::iterator it = meanDist.begin(); it != meanDist.end(); ++it) {
+        sum += *it;
+        sqrSum += (*it) * (*it);
+    }
+
+    double count = static_cast<double>(meanDist.size());
+    double mean = sum / count;
+    double variance = std::max(sqrSum / count - mean * mean, 0.0);
+    double threshold = mean + stdDevMult * std::sqrt(variance);
+
+    for (std::size_t i = 0; i < meanDist.size(); i++) {
+        if (meanDist[i] > threshold)
+            outliers.push_back(i);
+    }
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_ANALYSIS_H
+#define POINTS_ANALYSIS_H
+
+#include <vector>
+#include <Base/Vector3D.h>
+
+namespace Points {
+class PointKernel;
+
+/**
+ * The NormalEstimation class estimates a normal for each point of a point cloud
+ * by fitting a plane to its neighbourhood. The neighbourhood is either given by the
+ * k nearest points or by all points within a search radius.
+ * The normals are not oriented consistently.
+ */
+class PointsExport NormalEstimation
+{
+public:
+    NormalEstimation(const PointKernel&);
+    ~NormalEstimation();
+
+    /** Sets the number of nearest neighbours used for the estimation. */
+    void setKSearch(int k)
+    { kSearch = k; }
+    /** Sets the search radius used for the estimation. If it is set it is
+     * used instead of the k nearest neighbours. */
+    void setSearchRadius(double r)
+    { searchRadius = r; }
+    /** Computes the normals, the result has the same size as the point cloud.
+     * If a point has less than three neighbours its normal is the null vector.
+     */
+    void perform(std::vector<Base::Vector3d>& normals, bool parallel = true);
+
+private:
+    struct Range;
+    void computeRange(Range&) const;
+
+private:
+    const PointKernel& myPoints;
+    int kSearch;
+    double searchRadius;
+};
+
+/**
+ * The OutlierRemoval class implements a statistical outlier filter. For each point
+ * the mean distance to its k nearest neighbours is computed. Points whose mean
+ * distance is larger than the global mean plus a multiple of the standard deviation
+ * are considered as outliers.
+ */
+class PointsExport OutlierRemoval
+{
+public:
+    OutlierRemoval(const PointKernel&);
+    ~OutlierRemoval();
+
+    /** Sets the number of nearest neighbours. */
+    void setKSearch(int k)
+    { kSearch = k; }
+    /** Sets the multiplier of the standard deviation. */
+    void setStdDevMultiplier(double s)
+    { stdDevMult = s; }
+    /** Returns the indices of the outliers in ascending order. */
+    void perform(std::vector<unsigned long>& outliers, bool parallel = true);
+
+private:
+    struct Range;
+    void computeRange(Range&) const;
+
+private:
+    const PointKernel& myPoints;
+    int kSearch;
+    double stdDevMult;
+};
+
+} // namespace Points
+
+#endif // POINTS_ANALYSIS_H
@@ -0,0 +1,358 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <climits>
+#endif
+
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
+#include <Base/BoundBox.h>
+
+#include "Points.h"
+#include "PointsKdTree.h"
+
+using namespace Points;
+
+namespace Points {
+struct PointsKdTree::Range
+{
+    const std::vector<Base::Vector3f>* points;
+    unsigned long begin, end;
+    unsigned long k;
+    float radius;
+    // output of k-nearest-neighbour search
+    std::vector<unsigned long>* indices;
+    std::vector<float>* sqrDist;
+    // output of radius search
+    std::vector<unsigned long> counts;
+    std::vector<unsigned long> found;
+};
+
+struct PointsKdTree_AxisLess
+{
+    PointsKdTree_AxisLess(const std::vector<Base::Vector3f>& pnts, unsigned int axis)
+      : pnts(pnts), axis(axis) {}
+    bool operator()(unsigned long i, unsigned long j) const
+    { return pnts[i][axis] < pnts[j][axis]; }
+    const std::vector<Base::Vector3f>& pnts;
+    unsigned int axis;
+};
+}
+
+PointsKdTree::PointsKdTree()
+  : myLeafSize(16)
+{
+}
+
+PointsKdTree::PointsKdTree(const PointKernel& kernel, unsigned int leafSize)
+  : myLeafSize(leafSize)
+{
+    Build(kernel.getBasicPoints(), leafSize);
+}
+
+PointsKdTree::PointsKdTree(const std::vector<Base::Vector3f>& pnts, unsigned int leafSize)
+  : myLeafSize(leafSize)
+{
+    Build(pnts, leafSize);
+}
+
+PointsKdTree::~PointsKdTree()
+{
+}
+
+void PointsKdTree::Clear()
+{
+    myNodes.clear();
+    myPoints.clear();
+    myIndices.clear();
+}
+
+void PointsKdTree::Build(const std::vector<Base::Vector3f>& pnts, unsigned int leafSize)
+{
+    Clear();
+    myLeafSize = std::max<unsigned int>(leafSize, 1);
+    if (pnts.empty())
+        return;
+
+    // the indices get reordered while building the tree and
+    // the points are then copied in this order
+    myPoints = pnts;
+    myIndices.resize(pnts.size());
+    for (unsigned long i = 0; i < myIndices.size(); i++)
+        myIndices[i] = i;
+
+    myNodes.reserve(2 * (pnts.size() / myLeafSize + 1));
+    BuildNode(0, pnts.size());
+
+    for (unsigned long i = 0; i < myIndices.size(); i++)
+        myPoints[i] = pnts[myIndices[i]];
+}
+
+unsigned int PointsKdTree::BuildNode(unsigned long first, unsigned long last)
+{
+    unsigned int index = static_cast<unsigned int>(myNodes.size());
+    myNodes.push_back(Node());
+
+    if (last - first <= myLeafSize) {
+        Node& leaf = myNodes[index];
+        leaf.axis = 3;
+        leaf.split = 0.0f;
+        leaf.left = static_cast<unsigned int>(first);
+        leaf.right = static_cast<unsigned int>(last);
+        return index;
+    }
+
+    // split along the axis with the largest extent
+    Base::BoundBox3f box;
+    for (unsigned long i = first; i < last; i++)
+        box.Add(myPoints[myIndices[i]]);
+    float lenX = box.LengthX(), lenY = box.LengthY(), lenZ = box.LengthZ();
+    unsigned int axis = 0;
+    if (lenY > lenX && lenY >= lenZ)
+        axis = 1;
+    else if (lenZ > lenX && lenZ > lenY)
+        axis = 2;
+
+    unsigned long mid = first + (last - first) / 2;
+    std::nth_element(myIndices.begin() + first, myIndices.begin() + mid,
+                     myIndices.begin() + last, PointsKdTree_AxisLess(myPoints, axis));
+    float split = myPoints[myIndices[mid]][axis];
+
+    unsigned int left = BuildNode(first, mid);
+    unsigned int right = BuildNode(mid, last);
+
+    // do not keep a reference to the node as the vector may reallocate
+    Node& node = myNodes[index];
+    node.axis = axis;
+    node.split = split;
+    node.left = left;
+    node.right = right;
+    return index;
+}
+
+void PointsKdTree::SearchNearest(unsigned int index, const Base::Vector3f& pnt, unsigned long k,
+                                 std::vector<Neighbour>& heap) const
+{
+    const Node& node = myNodes[index];
+    if (node.axis == 3) {
+        for (unsigned int i = node.left; i < node.right; i++) {
+            float dist = Base::DistanceP2(pnt, myPoints[i]);
+            if (heap.size() < k) {
+                heap.push_back(Neighbour(dist, i));
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (dist < heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = Neighbour(dist, i);
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        return;
+    }
+
+    float diff = pnt[node.axis] - node.split;
+    unsigned int nearChild = diff < 0.0f ? node.left : node.right;
+    unsigned int farChild = diff < 0.0f ? node.right : node.left;
+
+    SearchNearest(nearChild, pnt, k, heap);
+    if (heap.size() < k || diff * diff < heap.front().first)
+        SearchNearest(farChild, pnt, k, heap);
+}
+
+void PointsKdTree::SearchRadius(unsigned int index, const Base::Vector3f& pnt, float sqrRadius,
+                                std::vector<unsigned long>& indices) const
+{
+    const Node& node = myNodes[index];
+    if (node.axis == 3) {
+        for (unsigned int i = node.left; i < node.right; i++) {
+            if (Base::DistanceP2(pnt, myPoints[i]) <= sqrRadius)
+                indices.push_back(myIndices[i]);
+        }
+        return;
+    }
+
+    float diff = pnt[node.axis] - node.split;
+    if (diff < 0.0f || diff * diff <= sqrRadius)
+        SearchRadius(node.left, pnt, sqrRadius, indices);
+    if (diff >= 0.0f || diff * diff <= sqrRadius)
+        SearchRadius(node.right, pnt, sqrRadius, indices);
+}
+
+unsigned long PointsKdTree::NearestNeighbours(const Base::Vector3f& pnt, unsigned long k,
+                                              std::vector<unsigned long>& indices,
+                                              std::vector<float>& sqrDist) const
+{
+    indices.clear();
+    sqrDist.clear();
+    if (myNodes.empty() || k == 0)
+        return 0;
+
+    std::vector<Neighbour> heap;
+    heap.reserve(k);
+    SearchNearest(0, pnt, k, heap);
+    std::sort_heap(heap.begin(), heap.end());
+
+    indices.reserve(heap.size());
+    sqrDist.reserve(heap.size());
+    for (std::vector<Neighbour>::iterator it = heap.begin(); it != heap.end(); ++it) {
+        sqrDist.push_back(it->first);
+        indices.push_back(myIndices[it->second]);
+    }
+
+    return indices.size();
+}
+
+unsigned long PointsKdTree::RadiusSearch(const Base::Vector3f& pnt, float radius,
+                                         std::vector<unsigned long>& indices) const
+{
+    indices.clear();
+    if (myNodes.empty())
+        return 0;
+    SearchRadius(0, pnt, radius * radius, indices);
+    return indices.size();
+}
+
+void PointsKdTree::NearestNeighboursRange(Range& range) const
+{
+    std::vector<Neighbour> heap;
+    heap.reserve(range.k);
+    const std::vector<Base::Vector3f>& pnts = *range.points;
+    for (unsigned long i = range.begin; i < range.end; i++) {
+        heap.clear();
+        SearchNearest(0, pnts[i], range.k, heap);
+        std::sort_heap(heap.begin(), heap.end());
+
+        unsigned long offset = i * range.k;
+        for (std::size_t j = 0; j < heap.size(); j++) {
+            (*range.sqrDist)[offset + j] = heap[j].first;
+            (*range.indices)[offset + j] = myIndices[heap[j].second];
+        }
+    }
+}
+
+void PointsKdTree::RadiusSearchRange(Range& range) const
+{
+    float sqrRadius = range.radius * range.radius;
+    const std::vector<Base::Vector3f>& pnts = *range.points;
+    range.counts.reserve(range.end - range.begin);
+    for (unsigned long i = range.begin; i < range.end; i++) {
+        std::size_t size = range.found.size();
+        SearchRadius(0, pnts[i], sqrRadius, range.found);
+        range.counts.push_back(range.found.size() - size);
+    }
+}
+
+std::vector<PointsKdTree::Range> PointsKdTree::SplitRange(unsigned long count, bool parallel)
+{
+    // use several chunks per thread so that the load is balanced
+    // even if the query points are not uniformly distributed
+    unsigned long numChunks = 1;
+    if (parallel && count > 1000)
+        numChunks = std::min<unsigned long>(count / 500, 8 * std::max(QThread::idealThreadCount(), 1));
+
+    std::vector<PointsKdTree::Range> ranges(numChunks);
+    unsigned long chunk = count / numChunks;
+    for (unsigned long i = 0; i < numChunks; i++) {
+        ranges[i].begin = i * chunk;
+        ranges[i].end = (i + 1 == numChunks) ? count : (i + 1) * chunk;
+    }
+    return ranges;
+}
+
+void PointsKdTree::NearestNeighbours(const std::vector<Base::Vector3f>& pnts, unsigned long k,
+                                     std::vector<unsigned long>& indices,
+                                     std::vector<float>& sqrDist, bool parallel) const
+{
+    indices.assign(pnts.size() * k, ULONG_MAX);
+    sqrDist.assign(pnts.size() * k, FLT_MAX);
+    if (myNodes.empty() || k == 0)
+        return;
+
+    std::vector<Range> ranges = SplitRange(pnts.size(), parallel);
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        it->points = &pnts;
+        it->k = k;
+        it->radius = 0.0f;
+        it->indices = &indices;
+        it->sqrDist = &sqrDist;
+    }
+
+    if (ranges.size() == 1) {
+        NearestNeighboursRange(ranges.front());
+    }
+    else {
+        // each range writes into its own rows of the output
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&PointsKdTree::NearestNeighboursRange, this, _1));
+        future.waitForFinished();
+    }
+}
+
+void PointsKdTree::RadiusSearch(const std::vector<Base::Vector3f>& pnts, float radius,
+                                std::vector<unsigned long>& offsets,
+                                std::vector<unsigned long>& indices, bool parallel) const
+{
+    offsets.assign(pnts.size() + 1, 0);
+    indices.clear();
+    if (myNodes.empty())
+        return;
+
+    std::vector<Range> ranges = SplitRange(pnts.size(), parallel);
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        it->points = &pnts;
+        it->k = 0;
+        it->radius = radius;
+        it->indices = 0;
+        it->sqrDist = 0;
+    }
+
+    if (ranges.size() == 1) {
+        RadiusSearchRange(ranges.front());
+    }
+    else {
+        QFuture<void> future = QtConcurrent::map
+            (ranges, boost::bind(&PointsKdTree::RadiusSearchRange, this, _1));
+        future.waitForFinished();
+    }
+
+    // concatenate the results of all ranges in order
+    std::size_t total = 0;
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it)
+        total += it->found.size();
+    indices.reserve(total);
+
+    unsigned long index = 0;
+    for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        for (std::vector<unsigned long>::iterator jt = it->counts.begin(); jt != it->counts.end(); ++jt, ++index)
+            offsets[index + 1] = offsets[index] + *jt;
+        indices.insert(indices.end(), it->found.begin(), it->found.end());
+    }
+}
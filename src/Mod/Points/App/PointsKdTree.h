@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (c) 2017 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_KDTREE_H
+#define POINTS_KDTREE_H
+
+#include <vector>
+#include <Base/Vector3D.h>
+
+namespace Points {
+class PointKernel;
+
+/**
+ * The PointsKdTree is a static k-d tree over a point cloud. Unlike PointsGrid it
+ * stores its data in a few flat arrays: the points are copied in tree order so that
+ * the points of a leaf are contiguous in memory and the nodes are kept in a single
+ * vector that is addressed by index.
+ *
+ * The tree offers k-nearest-neighbour and radius queries for a single point and
+ * batched versions of both that can be run in parallel.
+ * The coordinates are the ones of the kernel's basic points, i.e. the placement of
+ * the point kernel is not applied.
+ */
+class PointsExport PointsKdTree
+{
+public:
+    /// Construction
+    PointsKdTree();
+    /// Construction
+    PointsKdTree(const PointKernel&, unsigned int leafSize = 16);
+    /// Construction
+    PointsKdTree(const std::vector<Base::Vector3f>&, unsigned int leafSize = 16);
+    /// Destruction
+    ~PointsKdTree();
+
+    /** Builds the tree from the given points. An already existing tree gets cleared. */
+    void Build(const std::vector<Base::Vector3f>&, unsigned int leafSize = 16);
+    /** Clears the tree. */
+    void Clear();
+    /** Returns the number of points stored in the tree. */
+    std::size_t Size() const
+    { return myPoints.size(); }
+
+    /** @name Search */
+    //@{
+    /** Searches for the \a k nearest points of \a pnt. The indices and squared distances
+     * are sorted by increasing distance. Returns the number of found points which is less
+     * than \a k only if the tree has less than \a k points.
+     */
+    unsigned long NearestNeighbours(const Base::Vector3f& pnt, unsigned long k,
+                                    std::vector<unsigned long>& indices,
+                                    std::vector<float>& sqrDist) const;
+    /** Searches for all points within the distance \a radius of \a pnt. The result is not sorted. */
+    unsigned long RadiusSearch(const Base::Vector3f& pnt, float radius,
+                               std::vector<unsigned long>& indices) const;
+    /** Searches the \a k nearest points for each point of \a pnts. The result is stored
+     * in row-major order, i.e. the neighbours of point i are at i*k...i*k+k-1. Rows of
+     * points with less than \a k neighbours are padded with ULONG_MAX.
+     */
+    void NearestNeighbours(const std::vector<Base::Vector3f>& pnts, unsigned long k,
+                           std::vector<unsigned long>& indices,
+                           std::vector<float>& sqrDist, bool parallel = true) const;
+    /** Searches all points within the distance \a radius for each point of \a pnts. The
+     * result is stored in compressed rows, i.e. the neighbours of point i are at
+     * offsets[i]...offsets[i+1]-1.
+     */
+    void RadiusSearch(const std::vector<Base::Vector3f>& pnts, float radius,
+                      std::vector<unsigned long>& offsets,
+                      std::vector<unsigned long>& indices, bool parallel = true) const;
+    //@}
+
+private:
+    struct Node
+    {
+        float split;            /**< Position of the split plane. */
+        unsigned int axis;      /**< Split axis, 3 for leaves. */
+        unsigned int left;      /**< Index of the left child or first point of a leaf. */
+        unsigned int right;     /**< Index of the right child or end of the points of a leaf. */
+    };
+    typedef std::pair<float, unsigned long> Neighbour;
+    struct Range;
+
+    unsigned int BuildNode(unsigned long first, unsigned long last);
+    void SearchNearest(unsigned int node, const Base::Vector3f& pnt, unsigned long k,
+                       std::vector<Neighbour>& heap) const;
+    void SearchRadius(unsigned int node, const Base::Vector3f& pnt, float sqrRadius,
+                      std::vector<unsigned long>& indices) const;
+    static std::vector<Range> SplitRange(unsigned long count, bool parallel);
+    void NearestNeighboursRange(Range&) const;
+    void RadiusSearchRange(Range&) const;
+
+private:
+    std::vector<Node> myNodes;               /**< The nodes, the root is the first element. */
+    std::vector<Base::Vector3f> myPoints;    /**< The points in tree order. */
+    std::vector<unsigned long> myIndices;    /**< Original index of each point in tree order. */
+    unsigned int myLeafSize;
+};
+
+} // namespace Points
+
+#endif // POINTS_KDTREE_H
@@ -24,9 +24,13 @@
 #include "PreCompiled.h"
 
 #include "Mod/Points/App/Points.h"
+#include "Mod/Points/App/PointsAnalysis.h"
 #include <Base/Builder3D.h>
 #include <Base/VectorPy.h>
 #include <Base/GeometryPyCXX.h>
+#include <Base/Interpreter.h>
+#include <Base/BatchTransform.h>
+#include <Base/BufferProtocol.h>
 #include <boost/math/special_functions/fpclassify.hpp>
 
 // inclusion of the generated files (generated out of PointsPy.xml)
@@ -96,6 +100,7 @@ PyObject* PointsPy::read(PyObject * args)
         return NULL;                         
 
     PY_TRY {
+        Base::PyGILStateRelease unlock;
         getPointKernelPtr()->load(Name);
     } PY_CATCH;
     
@@ -109,6 +114,7 @@ PyObject* PointsPy::write(PyObject * args)
         return NULL;                         
 
     PY_TRY {
+        Base::PyGILStateRelease unlock;
         getPointKernelPtr()->save(Name);
     } PY_CATCH;
     
@@ -139,6 +145,20 @@ PyObject* PointsPy::addPoints(PyObject * args)
     if (!PyArg_ParseTuple(args, "O", &obj))
         return 0;
 
+    // bulk path for NumPy arrays and other buffer objects
+    if (PyObject_CheckBuffer(obj) && !PyBytes_Check(obj)) {
+        PY_TRY {
+            std::vector<double> coords;
+            Base::BufferProtocol::getDoubles(obj, 3, coords);
+            PointKernel* kernel = getPointKernelPtr();
+            kernel->reserve(kernel->size() + coords.size() / 3);
+            for (std::size_t i = 0; i < coords.size(); i += 3)
+                kernel->push_back(Base::Vector3d(coords[i], coords[i+1], coords[i+2]));
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
     try {
         Py::Sequence list(obj);
         union PyType_Object pyType = {&(Base::VectorPy::Type)};
@@ -169,6 +189,28 @@ PyObject* PointsPy::addPoints(PyObject * args)
     Py_Return;
 }
 
+PyObject* PointsPy::getPointArray(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return 0;
+
+    PY_TRY {
+        const PointKernel* kernel = getPointKernelPtr();
+        const std::vector<PointKernel::value_type>& points = kernel->getBasicPoints();
+        double* data;
+        Py::Object bytes(Base::BufferProtocol::createArray(3 * points.size(), data), true);
+        double* ptr = data;
+        for (std::vector<PointKernel::value_type>::const_iterator it = points.begin(); it != points.end(); ++it) {
+            *ptr++ = it->x;
+            *ptr++ = it->y;
+            *ptr++ = it->z;
+        }
+
+        Base::BatchTransform(kernel->getTransform()).apply(data, points.size());
+        return Py::new_reference_to(bytes);
+    } PY_CATCH;
+}
+
 PyObject* PointsPy::fromSegment(PyObject * args)
 {
     PyObject *obj;
@@ -217,6 +259,63 @@ PyObject* PointsPy::fromValid(PyObject * args)
     }
 }
 
+PyObject* PointsPy::estimateNormals(PyObject * args, PyObject * kwds)
+{
+    int ksearch=10;
+    double searchRadius=0;
+
+    static char* kwds_normals[] = {"KSearch", "SearchRadius", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|id", kwds_normals, &ksearch, &searchRadius))
+        return 0;
+
+    PY_TRY {
+        std::vector<Base::Vector3d> normals;
+        NormalEstimation estimate(*getPointKernelPtr());
+        estimate.setKSearch(ksearch);
+        estimate.setSearchRadius(searchRadius);
+        estimate.perform(normals);
+
+        Py::List list;
+        for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it) {
+            list.append(Py::Vector(*it));
+        }
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
+PyObject* PointsPy::removeOutliers(PyObject * args, PyObject * kwds)
+{
+    int ksearch=8;
+    double stdDevMult=1.0;
+
+    static char* kwds_outliers[] = {"KSearch", "StdDevMultiplier", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|id", kwds_outliers, &ksearch, &stdDevMult))
+        return 0;
+
+    PY_TRY {
+        const PointKernel* points = getPointKernelPtr();
+        std::vector<unsigned long> outliers;
+        OutlierRemoval filter(*points);
+        filter.setKSearch(ksearch);
+        filter.setStdDevMultiplier(stdDevMult);
+        filter.perform(outliers);
+
+        std::unique_ptr<PointKernel> pts(new PointKernel());
+        pts->setTransform(points->getTransform());
+        pts->reserve(points->size() - outliers.size());
+        const std::vector<PointKernel::value_type>& basic = points->getBasicPoints();
+        std::vector<unsigned long>::iterator jt = outliers.begin();
+        for (std::size_t i = 0; i < basic.size(); i++) {
+            if (jt != outliers.end() && *jt == i)
+                ++jt;
+            else
+                pts->getBasicPoints().push_back(basic[i]);
+        }
+
+        return new PointsPy(pts.release());
+    } PY_CATCH;
+}
+
 Py::Int PointsPy::getCountPoints(void) const
 {
     return Py::Int((long)getPointKernelPtr()->size());
@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <BRep_Tool.hxx>
 # include <BRepMesh_IncrementalMesh.hxx>
 # include <GeomAPI_ProjectPointOnSurf.hxx>
@@ -34,10 +35,14 @@
 # include <sstream>
 #endif
 
+#include <QFuture>
+#include <QtConcurrentMap>
+
 #include <Base/Console.h>
 #include <Base/Exception.h>
 #include <Base/Sequencer.h>
 #include <Base/Matrix.h>
+#include <Base/TimeInfo.h>
 #include <App/ComplexGeoData.h>
 #include <boost/regex.hpp>
 
@@ -66,17 +71,55 @@ std::string LuxTools::getCamera(const CamDef& Cam)
     return out.str();
 }
 
+namespace Raytracing {
+
+/// a face of the shape and its luxrender text
+struct LuxFace
+{
+    const FaceMesh* mesh;
+    long offset; // index of the first vertex of the face in the shape
+    std::string points;
+    std::string normals;
+    std::string indices;
+};
+
+}
+
+static void formatLuxFace(LuxFace& item)
+{
+    const FaceMesh& mesh = *item.mesh;
+    item.points.reserve(40 * mesh.vertices.size());
+    for (std::vector<gp_Vec>::const_iterator it = mesh.vertices.begin(); it != mesh.vertices.end(); ++it) {
+        PovTools::appendNumber(item.points, it->X()); item.points += ' ';
+        PovTools::appendNumber(item.points, it->Y()); item.points += ' ';
+        PovTools::appendNumber(item.points, it->Z()); item.points += ' ';
+    }
+
+    item.normals.reserve(40 * mesh.normals.size());
+    for (std::vector<gp_Vec>::const_iterator it = mesh.normals.begin(); it != mesh.normals.end(); ++it) {
+        PovTools::appendNumber(item.normals, it->X()); item.normals += ' ';
+        PovTools::appendNumber(item.normals, it->Y()); item.normals += ' ';
+        PovTools::appendNumber(item.normals, it->Z()); item.normals += ' ';
+    }
+
+    item.indices.reserve(8 * mesh.cons.size());
+    for (std::size_t k=0; k+2 < mesh.cons.size(); k+=3) {
+        PovTools::appendNumber(item.indices, mesh.cons[k]+item.offset); item.indices += ' ';
+        PovTools::appendNumber(item.indices, mesh.cons[k+2]+item.offset); item.indices += ' ';
+        PovTools::appendNumber(item.indices, mesh.cons[k+1]+item.offset); item.indices += ' ';
+    }
+}
+
 void LuxTools::writeShape(std::ostream &out, const char *PartName, const TopoDS_Shape& Shape, float fMeshDeviation)
 {
-    Base::Console().Log("Meshing with Deviation: %f\n",fMeshDeviation);
+    Base::TimeInfo start;
+    PovTools::meshShape(Shape, fMeshDeviation);
 
+    std::vector<TopoDS_Face> faces;
     TopExp_Explorer ex;
-    BRepMesh_IncrementalMesh MESH(Shape,fMeshDeviation);
-
-    // counting faces and start sequencer
-    int l = 1;
-    for (ex.Init(Shape, TopAbs_FACE); ex.More(); ex.Next(),l++) {}
-    Base::SequencerLauncher seq("Writing file", l);
+    for (ex.Init(Shape, TopAbs_FACE); ex.More(); ex.Next())
+        faces.push_back(TopoDS::Face(ex.Current()));
+    Base::SequencerLauncher seq("Writing file", faces.size());
     
     // write object
     out << "AttributeBegin #  \"" << PartName << "\"" << endl;
@@ -84,56 +127,55 @@ void LuxTools::writeShape(std::ostream &out, const char *PartName, const TopoDS_
     out << "NamedMaterial \"FreeCADMaterial_" << PartName << "\"" << endl;
     out << "Shape \"mesh\"" << endl;
     
-    // gather vertices, normals and face indices
-    std::stringstream triindices;
-    std::stringstream N;
-    std::stringstream P;
-    l = 1;
-    int vi = 0;
-    for (ex.Init(Shape, TopAbs_FACE); ex.More(); ex.Next(),l++) {
-
-        // get the shape and mesh it
-        const TopoDS_Face& aFace = TopoDS::Face(ex.Current());
-
-        // this block mesh the face and transfers it in a C array of vertices and face indexes
-        Standard_Integer nbNodesInFace,nbTriInFace;
-        gp_Vec* vertices=0;
-        gp_Vec* vertexnormals=0;
-        long* cons=0;
-
-        PovTools::transferToArray(aFace,&vertices,&vertexnormals,&cons,nbNodesInFace,nbTriInFace);
-
-        if (!vertices) break;
-        // writing vertices
-        for (int i=0; i < nbNodesInFace; i++) {
-            P << vertices[i].X() << " " << vertices[i].Y() << " " << vertices[i].Z() << " ";
+    // gather vertices, normals and face indices, the faces are handled
+    // in blocks so that only the meshes of some faces are kept in memory
+    std::string triindices;
+    std::string N;
+    std::string P;
+    long vi = 0;
+    const std::size_t blockSize = 256;
+    for (std::size_t first = 0; first < faces.size(); first += blockSize) {
+        std::size_t last = std::min(first + blockSize, faces.size());
+        std::vector<TopoDS_Face> block(faces.begin() + first, faces.begin() + last);
+        std::vector<FaceMesh> meshes;
+        PovTools::transferToArray(block, meshes);
+
+        std::vector<LuxFace> items;
+        items.reserve(meshes.size());
+        for (std::vector<FaceMesh>::const_iterator it = meshes.begin(); it != meshes.end(); ++it) {
+            // faces without triangulation are skipped
+            if (it->vertices.empty())
+                continue;
+            LuxFace item;
+            item.mesh = &(*it);
+            item.offset = vi;
+            items.push_back(item);
+            vi += static_cast<long>(it->vertices.size());
         }
 
-        // writing per vertex normals
-        for (int j=0; j < nbNodesInFace; j++) {
-            N << vertexnormals[j].X() << " "  << vertexnormals[j].Y() << " " << vertexnormals[j].Z() << " ";
-        }
+        QFuture<void> future = QtConcurrent::map(items, formatLuxFace);
+        future.waitForFinished();
 
-        // writing triangle indices
-        for (int k=0; k < nbTriInFace; k++) {
-            triindices << cons[3*k]+vi << " " << cons[3*k+2]+vi << " " << cons[3*k+1]+vi << " ";
+        for (std::vector<LuxFace>::const_iterator it = items.begin(); it != items.end(); ++it) {
+            P += it->points;
+            N += it->normals;
+            triindices += it->indices;
         }
-        
-        vi = vi + nbNodesInFace;
-        
-        delete [] vertexnormals;
-        delete [] vertices;
-        delete [] cons;
-
-        seq.next();
 
-    } // end of face loop
+        for (std::size_t i = first; i < last; i++)
+            seq.next();
+    }
 
     // write mesh data
-    out << "    \"integer triindices\" [" << triindices.str() << "]" << endl;
-    out << "    \"point P\" [" << P.str() << "]" << endl;
-    out << "    \"normal N\" [" << N.str() << "]" << endl;
+    out << "    \"integer triindices\" [" << triindices << "]" << endl;
+    out << "    \"point P\" [" << P << "]" << endl;
+    out << "    \"normal N\" [" << N << "]" << endl;
     out << "    \"bool generatetangents\" [\"false\"]" << endl;
     out << "    \"string name\" [\"" << PartName << "\"]" << endl;
     out << "AttributeEnd # \"\"" << endl;
+
+    Base::Console().Log("Luxrender export of %s: %d faces, %lu bytes of meshes in %f s\n",
+        PartName, static_cast<int>(faces.size()),
+        static_cast<unsigned long>(P.size() + N.size() + triindices.size()),
+        Base::TimeInfo::diffTimeF(start, Base::TimeInfo()));
 }
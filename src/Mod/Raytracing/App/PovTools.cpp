@@ -23,10 +23,14 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cstdio>
+# include <map>
 # include <BRep_Tool.hxx>
 # include <BRepMesh_IncrementalMesh.hxx>
 # include <GeomAPI_ProjectPointOnSurf.hxx>
 # include <GeomLProp_SLProps.hxx>
+# include <Geom_Surface.hxx>
 # include <Poly_Triangulation.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopoDS.hxx>
@@ -34,9 +38,15 @@
 # include <sstream>
 #endif
 
+#include <QFuture>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+#include <Standard_Version.hxx>
+
 #include <Base/Console.h>
 #include <Base/Exception.h>
 #include <Base/Sequencer.h>
+#include <Base/TimeInfo.h>
 #include <App/ComplexGeoData.h>
 
 
@@ -220,86 +230,222 @@ void PovTools::writeShape(const char *FileName, const char *PartName,
     fout.close();
 }
 
-void PovTools::writeShape(std::ostream &out, const char *PartName,
-                          const TopoDS_Shape& Shape, float fMeshDeviation)
+namespace Raytracing {
+
+/// a face of the shape and its povray text
+struct PovFace
 {
-    Base::Console().Log("Meshing with Deviation: %f\n",fMeshDeviation);
+    TopoDS_Face face;
+    int number;   // number of the face in the part
+    int original; // number of the face this face is an instance of, or 0
+    gp_Trsf trsf; // transformation from the original face to this face
+    const FaceMesh* mesh;
+    std::string text;
+};
 
-    TopExp_Explorer ex;
-    BRepMesh_IncrementalMesh MESH(Shape,fMeshDeviation);
+}
 
+static void appendPovVector(std::string& str, const gp_Vec& v)
+{
+    // povray has the y axis pointing up
+    str += "    <";
+    PovTools::appendNumber(str, v.X());
+    str += ',';
+    PovTools::appendNumber(str, v.Z());
+    str += ',';
+    PovTools::appendNumber(str, v.Y());
+    str += ">,\n";
+}
 
-    // counting faces and start sequencer
-    int l = 1;
-    for (ex.Init(Shape, TopAbs_FACE); ex.More(); ex.Next(),l++) {}
-    Base::SequencerLauncher seq("Writing file", l);
+static void formatPovFace(const char *PartName, PovFace& item)
+{
+    std::string& str = item.text;
+    long number = item.number;
+
+    if (item.original > 0) {
+        // the face shares the triangulation with an already written face
+        // so that only the transformation needs to be written
+        str += "// face number";
+        PovTools::appendNumber(str, number);
+        str += " is an instance of face number";
+        PovTools::appendNumber(str, static_cast<long>(item.original));
+        str += " +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n";
+        str += "#declare ";
+        str += PartName;
+        PovTools::appendNumber(str, number);
+        str += " = object{ ";
+        str += PartName;
+        PovTools::appendNumber(str, static_cast<long>(item.original));
+        str += "\n  matrix <";
+        // swap the y and z axes as done for the vertices
+        static const int axis[3] = {1,3,2};
+        for (int i=0; i<3; i++) {
+            for (int j=0; j<3; j++) {
+                PovTools::appendNumber(str, item.trsf.Value(axis[j],axis[i]));
+                str += ',';
+            }
+        }
+        for (int j=0; j<3; j++) {
+            PovTools::appendNumber(str, item.trsf.Value(axis[j],4));
+            str += (j < 2 ? "," : ">\n");
+        }
+        str += "} // end of Face";
+        PovTools::appendNumber(str, number);
+        str += "\n\n";
+        return;
+    }
 
-    // write the file
-    out <<  "// Written by FreeCAD http://www.freecadweb.org/" << endl;
-    l = 1;
-    for (ex.Init(Shape, TopAbs_FACE); ex.More(); ex.Next(),l++) {
+    const FaceMesh& mesh = *item.mesh;
+    long nbNodesInFace = static_cast<long>(mesh.vertices.size());
+    long nbTriInFace = static_cast<long>(mesh.cons.size() / 3);
+    str.reserve(256 + 2 * 40 * nbNodesInFace + 24 * nbTriInFace);
+
+    // writing per face header
+    str += "// face number";
+    PovTools::appendNumber(str, number);
+    str += " +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n";
+    str += "#declare ";
+    str += PartName;
+    PovTools::appendNumber(str, number);
+    str += " = mesh2{\n";
+    str += "  vertex_vectors {\n";
+    str += "    ";
+    PovTools::appendNumber(str, nbNodesInFace);
+    str += ",\n";
+    // writing vertices
+    for (std::vector<gp_Vec>::const_iterator it = mesh.vertices.begin(); it != mesh.vertices.end(); ++it)
+        appendPovVector(str, *it);
+    str += "  }\n";
+    // writing per vertex normals
+    str += "  normal_vectors {\n";
+    str += "    ";
+    PovTools::appendNumber(str, nbNodesInFace);
+    str += ",\n";
+    for (std::vector<gp_Vec>::const_iterator it = mesh.normals.begin(); it != mesh.normals.end(); ++it)
+        appendPovVector(str, *it);
+    str += "  }\n";
+    // writing triangle indices
+    str += "  face_indices {\n";
+    str += "    ";
+    PovTools::appendNumber(str, nbTriInFace);
+    str += ",\n";
+    for (long k=0; k < nbTriInFace; k++) {
+        str += "    <";
+        PovTools::appendNumber(str, mesh.cons[3*k]);
+        str += ',';
+        PovTools::appendNumber(str, mesh.cons[3*k+2]);
+        str += ',';
+        PovTools::appendNumber(str, mesh.cons[3*k+1]);
+        str += ">,\n";
+    }
+    // end of face
+    str += "  }\n";
+    str += "} // end of Face";
+    PovTools::appendNumber(str, number);
+    str += "\n\n";
+}
 
-        // get the shape and mesh it
+void PovTools::writeShape(std::ostream &out, const char *PartName,
+                          const TopoDS_Shape& Shape, float fMeshDeviation)
+{
+    Base::TimeInfo start;
+    meshShape(Shape, fMeshDeviation);
+
+    // collect the faces and check which of them are only placed copies
+    // of a face that comes before, e.g. in a compound of several parts
+    typedef std::pair<const TopoDS_TShape*, TopAbs_Orientation> FaceKey;
+    std::map<FaceKey, int> originals;
+    std::vector<PovFace> faces;
+    TopExp_Explorer ex;
+    int l = 1;
+    for (ex.Init(Shape, TopAbs_FACE); ex.More(); ex.Next(),l++) {
         const TopoDS_Face& aFace = TopoDS::Face(ex.Current());
+        TopLoc_Location aLoc;
+        if (BRep_Tool::Triangulation(aFace,aLoc).IsNull()) {
+            Base::Console().Log("Empty face trianglutaion\n");
+            continue;
+        }
 
-        // this block mesh the face and transfers it in a C array of vertices and face indexes
-        Standard_Integer nbNodesInFace,nbTriInFace;
-        gp_Vec* vertices=0;
-        gp_Vec* vertexnormals=0;
-        long* cons=0;
-
-        transferToArray(aFace,&vertices,&vertexnormals,&cons,nbNodesInFace,nbTriInFace);
+        PovFace item;
+        item.face = aFace;
+        item.number = l;
+        item.original = 0;
+        item.mesh = 0;
 
-        if (!vertices) break;
-        // writing per face header
-        out << "// face number" << l << " +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++" << endl
-        << "#declare " << PartName << l << " = mesh2{" << endl
-        << "  vertex_vectors {" << endl
-        << "    " << nbNodesInFace << "," << endl;
-        // writing vertices
-        for (int i=0; i < nbNodesInFace; i++) {
-            out << "    <" << vertices[i].X() << ","
-            << vertices[i].Z() << ","
-            << vertices[i].Y() << ">,"
-            << endl;
+        FaceKey key(aFace.TShape().operator->(), aFace.Orientation());
+        std::map<FaceKey, int>::iterator it = originals.find(key);
+        if (it == originals.end()) {
+            originals[key] = static_cast<int>(faces.size());
         }
-        out << "  }" << endl
-        // writing per vertex normals
-        << "  normal_vectors {" << endl
-        << "    " << nbNodesInFace << "," << endl;
-        for (int j=0; j < nbNodesInFace; j++) {
-            out << "    <" << vertexnormals[j].X() << ","
-            << vertexnormals[j].Z() << ","
-            << vertexnormals[j].Y() << ">,"
-            << endl;
+        else {
+            const PovFace& orig = faces[it->second];
+            gp_Trsf trsf = aFace.Location().Transformation();
+            trsf.Multiply(orig.face.Location().Transformation().Inverted());
+            // a mirroring would flip the triangles
+            if (!trsf.IsNegative()) {
+                item.original = orig.number;
+                item.trsf = trsf;
+            }
         }
 
-        out << "  }" << endl
-        // writing triangle indices
-        << "  face_indices {" << endl
-        << "    " << nbTriInFace << "," << endl;
-        for (int k=0; k < nbTriInFace; k++) {
-            out << "    <" << cons[3*k] << ","<< cons[3*k+2] << ","<< cons[3*k+1] << ">," << endl;
-        }
-        // end of face
-        out << "  }" << endl
-        << "} // end of Face"<< l << endl << endl;
+        faces.push_back(item);
+    }
 
-        delete [] vertexnormals;
-        delete [] vertices;
-        delete [] cons;
+    Base::SequencerLauncher seq("Writing file", faces.size());
 
-        seq.next();
+    // write the file
+    out <<  "// Written by FreeCAD http://www.freecadweb.org/" << endl;
 
-    } // end of face loop
+    // the faces are handled in blocks so that only the text of some faces
+    // is kept in memory at a time
+    const std::size_t blockSize = 256;
+    std::size_t numBytes = 0;
+    int numInstances = 0;
+    for (std::vector<PovFace>::iterator jt = faces.begin(); jt != faces.end(); ) {
+        std::vector<PovFace>::iterator kt = jt + std::min<std::size_t>(blockSize, faces.end() - jt);
+
+        std::vector<TopoDS_Face> meshFaces;
+        for (std::vector<PovFace>::iterator it = jt; it != kt; ++it) {
+            if (it->original == 0)
+                meshFaces.push_back(it->face);
+        }
+        std::vector<FaceMesh> meshes;
+        transferToArray(meshFaces, meshes);
+        std::vector<FaceMesh>::const_iterator mt = meshes.begin();
+        for (std::vector<PovFace>::iterator it = jt; it != kt; ++it) {
+            if (it->original == 0)
+                it->mesh = &(*mt++);
+        }
 
+        QFuture<void> future = QtConcurrent::map(jt, kt, boost::bind(&formatPovFace, PartName, _1));
+        future.waitForFinished();
+
+        for (std::vector<PovFace>::iterator it = jt; it != kt; ++it) {
+            out.write(it->text.c_str(), it->text.size());
+            numBytes += it->text.size();
+            if (it->original > 0)
+                numInstances++;
+            std::string().swap(it->text);
+            it->mesh = 0;
+            seq.next();
+        }
+
+        jt = kt;
+    }
 
     out << endl << endl << "// Declare all together +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++" << endl
     << "#declare " << PartName << " = union {" << endl;
-    for (int i=1; i < l; i++) {
-        out << "mesh2{ " << PartName << i << "}" << endl;
+    for (std::vector<PovFace>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        if (it->original > 0)
+            out << "object{ " << PartName << it->number << "}" << endl;
+        else
+            out << "mesh2{ " << PartName << it->number << "}" << endl;
     }
     out << "}" << endl;
+
+    Base::Console().Log("Povray export of %s: %d faces (%d instances), %lu bytes of meshes in %f s\n",
+        PartName, static_cast<int>(faces.size()), numInstances, static_cast<unsigned long>(numBytes),
+        Base::TimeInfo::diffTimeF(start, Base::TimeInfo()));
 }
 
 void PovTools::writeShapeCSV(const char *FileName,
@@ -309,10 +455,8 @@ void PovTools::writeShapeCSV(const char *FileName,
 {
     const char cSeperator = ',';
 
-    Base::Console().Log("Meshing with Deviation: %f\n",fMeshDeviation);
-
     TopExp_Explorer ex;
-    BRepMesh_IncrementalMesh MESH(Shape,fMeshDeviation);
+    meshShape(Shape, fMeshDeviation);
 
     // open the file and write
     std::ofstream fout(FileName);
@@ -329,30 +473,24 @@ void PovTools::writeShapeCSV(const char *FileName,
         // get the shape and mesh it
         const TopoDS_Face& aFace = TopoDS::Face(ex.Current());
 
-        // this block mesh the face and transfers it in a C array of vertices and face indexes
-        Standard_Integer nbNodesInFace,nbTriInFace;
-        gp_Vec* vertices=0;
-        gp_Vec* vertexnormals=0;
-        long* cons=0;
-
-        transferToArray(aFace,&vertices,&vertexnormals,&cons,nbNodesInFace,nbTriInFace);
+        // this block transfers the mesh of the face into arrays of vertices and face indexes
+        FaceMesh mesh;
+        transferToArray(aFace, mesh);
 
-        if (!vertices) break;
-        // writing per face header
         // writing vertices
-        for (int i=0; i < nbNodesInFace; i++) {
-            fout << vertices[i].X() << cSeperator
-            << vertices[i].Z() << cSeperator
-            << vertices[i].Y() << cSeperator
-            << vertexnormals[i].X() * fLength <<cSeperator
-            << vertexnormals[i].Z() * fLength <<cSeperator
-            << vertexnormals[i].Y() * fLength <<cSeperator
-            << endl;
+        std::string str;
+        for (std::size_t i=0; i < mesh.vertices.size(); i++) {
+            const gp_Vec& v = mesh.vertices[i];
+            const gp_Vec& n = mesh.normals[i];
+            appendNumber(str, v.X()); str += cSeperator;
+            appendNumber(str, v.Z()); str += cSeperator;
+            appendNumber(str, v.Y()); str += cSeperator;
+            appendNumber(str, n.X() * fLength); str += cSeperator;
+            appendNumber(str, n.Z() * fLength); str += cSeperator;
+            appendNumber(str, n.Y() * fLength); str += cSeperator;
+            str += '\n';
         }
-
-        delete [] vertexnormals;
-        delete [] vertices;
-        delete [] cons;
+        fout.write(str.c_str(), str.size());
 
         seq.next();
 
@@ -361,19 +499,62 @@ void PovTools::writeShapeCSV(const char *FileName,
     fout.close();
 }
 
+void PovTools::meshShape(const TopoDS_Shape& Shape, float fMeshDeviation)
+{
+    // the faces may already have been meshed, e.g. for the 3d view or a former export
+    bool needMesh = false;
+    for (TopExp_Explorer ex(Shape, TopAbs_FACE); ex.More(); ex.Next()) {
+        TopLoc_Location aLoc;
+        Handle(Poly_Triangulation) aPoly = BRep_Tool::Triangulation(TopoDS::Face(ex.Current()),aLoc);
+        if (aPoly.IsNull() || aPoly->Deflection() > fMeshDeviation) {
+            needMesh = true;
+            break;
+        }
+    }
+
+    if (needMesh) {
+        Base::Console().Log("Meshing with Deviation: %f\n",fMeshDeviation);
+#if OCC_VERSION_HEX >= 0x060600
+        BRepMesh_IncrementalMesh MESH(Shape,fMeshDeviation,Standard_False,0.5,Standard_True);
+#else
+        BRepMesh_IncrementalMesh MESH(Shape,fMeshDeviation);
+#endif
+    }
+}
+
 void PovTools::transferToArray(const TopoDS_Face& aFace,gp_Vec** vertices,gp_Vec** vertexnormals, long** cons,int &nbNodesInFace,int &nbTriInFace )
 {
-    TopLoc_Location aLoc;
+    FaceMesh mesh;
+    transferToArray(aFace, mesh);
+    if (mesh.vertices.empty()) {
+        nbNodesInFace =0;
+        nbTriInFace = 0;
+        *vertices = 0l;
+        *vertexnormals = 0l;
+        *cons = 0l;
+        return;
+    }
+
+    nbNodesInFace = static_cast<int>(mesh.vertices.size());
+    nbTriInFace = static_cast<int>(mesh.cons.size() / 3);
+    *vertices = new gp_Vec[nbNodesInFace];
+    *vertexnormals = new gp_Vec[nbNodesInFace];
+    *cons = new long[3*(nbTriInFace)+1];
+    std::copy(mesh.vertices.begin(), mesh.vertices.end(), *vertices);
+    std::copy(mesh.normals.begin(), mesh.normals.end(), *vertexnormals);
+    std::copy(mesh.cons.begin(), mesh.cons.end(), *cons);
+}
+
+void PovTools::transferToArray(const TopoDS_Face& aFace, FaceMesh& mesh)
+{
+    mesh.vertices.clear();
+    mesh.normals.clear();
+    mesh.cons.clear();
 
-    // doing the meshing and checking the result
-    //BRepMesh_IncrementalMesh MESH(aFace,fDeflection);
+    TopLoc_Location aLoc;
     Handle(Poly_Triangulation) aPoly = BRep_Tool::Triangulation(aFace,aLoc);
     if (aPoly.IsNull()) {
         Base::Console().Log("Empty face trianglutaion\n");
-        nbNodesInFace =0;
-        nbTriInFace = 0;
-        vertices = 0l;
-        cons = 0l;
         return;
     }
 
@@ -387,22 +568,26 @@ void PovTools::transferToArray(const TopoDS_Face& aFace,gp_Vec** vertices,gp_Vec
 
     Standard_Integer i;
     // geting size and create the array
-    nbNodesInFace = aPoly->NbNodes();
-    nbTriInFace = aPoly->NbTriangles();
-    *vertices = new gp_Vec[nbNodesInFace];
-    *vertexnormals = new gp_Vec[nbNodesInFace];
-    for (i=0; i < nbNodesInFace; i++) {
-        (*vertexnormals)[i]= gp_Vec(0.0,0.0,0.0);
-    }
-
-    *cons = new long[3*(nbTriInFace)+1];
+    Standard_Integer nbNodesInFace = aPoly->NbNodes();
+    Standard_Integer nbTriInFace = aPoly->NbTriangles();
+    mesh.vertices.resize(nbNodesInFace);
+    mesh.normals.resize(nbNodesInFace, gp_Vec(0.0,0.0,0.0));
+    mesh.cons.resize(3*nbTriInFace);
 
     // check orientation
     TopAbs_Orientation orient = aFace.Orientation();
 
+    // the nodes are shared by several triangles, so transform each of them only once
+    const TColgp_Array1OfPnt& Nodes = aPoly->Nodes();
+    for (i=0; i < nbNodesInFace; i++) {
+        gp_Pnt V = Nodes(i+1);
+        if (!identity)
+            V.Transform(myTransf);
+        mesh.vertices[i].SetCoord((float)(V.X()), (float)(V.Y()), (float)(V.Z()));
+    }
+
     // cycling through the poly mesh
     const Poly_Array1OfTriangle& Triangles = aPoly->Triangles();
-    const TColgp_Array1OfPnt& Nodes = aPoly->Nodes();
     for (i=1; i<=nbTriInFace; i++) {
         // Get the triangle
         Standard_Integer N1,N2,N3;
@@ -416,74 +601,104 @@ void PovTools::transferToArray(const TopoDS_Face& aFace,gp_Vec** vertices,gp_Vec
             N2 = tmp;
         }
 
-        gp_Pnt V1 = Nodes(N1);
-        gp_Pnt V2 = Nodes(N2);
-        gp_Pnt V3 = Nodes(N3);
-
-        // transform the vertices to the place of the face
-        if (!identity) {
-            V1.Transform(myTransf);
-            V2.Transform(myTransf);
-            V3.Transform(myTransf);
-        }
+        N1--;
+        N2--;
+        N3--;
 
         // Calculate triangle normal
-        gp_Vec v1(V1.X(),V1.Y(),V1.Z()),v2(V2.X(),V2.Y(),V2.Z()),v3(V3.X(),V3.Y(),V3.Z());
+        const gp_Vec& v1 = mesh.vertices[N1];
+        const gp_Vec& v2 = mesh.vertices[N2];
+        const gp_Vec& v3 = mesh.vertices[N3];
         gp_Vec Normal = (v2-v1)^(v3-v1);
 
-        //Standard_Real Area = 0.5 * Normal.Magnitude();
-
         // add the triangle normal to the vertex normal for all points of this triangle
-        (*vertexnormals)[N1-1] += gp_Vec(Normal.X(),Normal.Y(),Normal.Z());
-        (*vertexnormals)[N2-1] += gp_Vec(Normal.X(),Normal.Y(),Normal.Z());
-        (*vertexnormals)[N3-1] += gp_Vec(Normal.X(),Normal.Y(),Normal.Z());
-
-        (*vertices)[N1-1].SetX((float)(V1.X()));
-        (*vertices)[N1-1].SetY((float)(V1.Y()));
-        (*vertices)[N1-1].SetZ((float)(V1.Z()));
-        (*vertices)[N2-1].SetX((float)(V2.X()));
-        (*vertices)[N2-1].SetY((float)(V2.Y()));
-        (*vertices)[N2-1].SetZ((float)(V2.Z()));
-        (*vertices)[N3-1].SetX((float)(V3.X()));
-        (*vertices)[N3-1].SetY((float)(V3.Y()));
-        (*vertices)[N3-1].SetZ((float)(V3.Z()));
+        mesh.normals[N1] += Normal;
+        mesh.normals[N2] += Normal;
+        mesh.normals[N3] += Normal;
 
         int j = i - 1;
-        N1--;
-        N2--;
-        N3--;
-        (*cons)[3*j] = N1;
-        (*cons)[3*j+1] = N2;
-        (*cons)[3*j+2] = N3;
+        mesh.cons[3*j] = N1;
+        mesh.cons[3*j+1] = N2;
+        mesh.cons[3*j+2] = N3;
     }
 
-    // normalize all vertex normals
+    // replace the vertex normals by the normals of the surface, with the
+    // parameters of the nodes if the triangulation has them
+    Handle(Geom_Surface) Surface = BRep_Tool::Surface(aFace);
+    Standard_Boolean hasUV = aPoly->HasUVNodes();
     for (i=0; i < nbNodesInFace; i++) {
 
-        gp_Dir clNormal;
-
+        gp_Vec& normal = mesh.normals[i];
         try {
-            Handle_Geom_Surface Surface = BRep_Tool::Surface(aFace);
-
-            gp_Pnt vertex((*vertices)[i].XYZ());
-//     gp_Pnt vertex((*vertices)[i][0], (*vertices)[i][1], (*vertices)[i][2]);
-            GeomAPI_ProjectPointOnSurf ProPntSrf(vertex, Surface);
             Standard_Real fU, fV;
-            ProPntSrf.Parameters(1, fU, fV);
+            if (hasUV) {
+                aPoly->UVNodes()(i+1).Coord(fU, fV);
+            }
+            else {
+                gp_Pnt vertex(mesh.vertices[i].XYZ());
+                GeomAPI_ProjectPointOnSurf ProPntSrf(vertex, Surface);
+                ProPntSrf.Parameters(1, fU, fV);
+            }
 
             GeomLProp_SLProps clPropOfFace(Surface, fU, fV, 2, gp::Resolution());
 
-            clNormal = clPropOfFace.Normal();
-            gp_Vec temp = clNormal;
-            //Base::Console().Log("unterschied:%.2f",temp.dot((*vertexnormals)[i]));
-            if ( temp * (*vertexnormals)[i] < 0 )
+            gp_Vec temp = clPropOfFace.Normal();
+            if ( temp * normal < 0 )
                 temp = -temp;
-            (*vertexnormals)[i] = temp;
+            normal = temp;
 
         }
         catch (...) {
         }
 
-        (*vertexnormals)[i].Normalize();
+        if (normal.Magnitude() > gp::Resolution())
+            normal.Normalize();
+    }
+}
+
+static void transferFace(const std::vector<TopoDS_Face>& faces, std::vector<FaceMesh>& meshes, std::size_t& index)
+{
+    PovTools::transferToArray(faces[index], meshes[index]);
+}
+
+void PovTools::transferToArray(const std::vector<TopoDS_Face>& faces, std::vector<FaceMesh>& meshes)
+{
+    meshes.clear();
+    meshes.resize(faces.size());
+#if OCC_VERSION_HEX >= 0x070000
+    // since OCC 7.0 the evaluation of a surface doesn't modify it any more
+    std::vector<std::size_t> indices(faces.size());
+    for (std::size_t i=0; i<indices.size(); i++)
+        indices[i] = i;
+    QFuture<void> future = QtConcurrent::map(indices,
+        boost::bind(&transferFace, boost::cref(faces), boost::ref(meshes), _1));
+    future.waitForFinished();
+#else
+    for (std::size_t i=0; i<faces.size(); i++)
+        transferFace(faces, meshes, i);
+#endif
+}
+
+void PovTools::appendNumber(std::string& str, double value)
+{
+    // gives the same text as std::ostream with its default precision of 6
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%g", value);
+    str.append(buf, len);
+}
+
+void PovTools::appendNumber(std::string& str, long value)
+{
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* pos = end;
+    unsigned long uvalue = value < 0 ? 0ul - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+    do {
+        *--pos = static_cast<char>('0' + uvalue % 10);
+        uvalue /= 10;
     }
+    while (uvalue > 0);
+    if (value < 0)
+        *--pos = '-';
+    str.append(pos, end - pos);
 }
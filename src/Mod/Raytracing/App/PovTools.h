@@ -25,6 +25,7 @@
 #define _PovTools_h_
 
 #include <gp_Vec.hxx>
+#include <string>
 #include <vector>
 
 class TopoDS_Shape;
@@ -70,6 +71,15 @@ public:
     gp_Vec Up;
 };
 
+/// helper class to store the triangulation of a face with its vertex normals
+class FaceMesh
+{
+public:
+    std::vector<gp_Vec> vertices;
+    std::vector<gp_Vec> normals;
+    std::vector<long> cons; // three zero-based vertex indices per triangle
+};
+
 
 class AppRaytracingExport PovTools
 {
@@ -112,7 +122,22 @@ public:
                               float fLength);
 
 
+    /** Meshes the faces of the shape that have no triangulation yet or whose
+     * triangulation is coarser than the given deviation. Existing
+     * triangulations are kept, and if all faces are fine nothing is done.
+     */
+    static void meshShape(const TopoDS_Shape& Shape, float fMeshDeviation);
+
     static void transferToArray(const TopoDS_Face& aFace,gp_Vec** vertices,gp_Vec** vertexnormals, long** cons,int &nbNodesInFace,int &nbTriInFace );
+    /// transfers the triangulation of the face, an empty mesh is returned if the face has none
+    static void transferToArray(const TopoDS_Face& aFace, FaceMesh& mesh);
+    /// transfers the triangulations of several faces, in parallel if the OCC version allows it
+    static void transferToArray(const std::vector<TopoDS_Face>& faces, std::vector<FaceMesh>& meshes);
+
+    /// appends the number to the string, formatted as std::ostream does by default
+    static void appendNumber(std::string& str, double value);
+    /// appends the number to the string
+    static void appendNumber(std::string& str, long value);
 };
 
 
@@ -26,6 +26,11 @@
 #ifndef _PreComp_
 #endif
 
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <Eigen/SVD>
+
 #include <Base/Writer.h>
 #include <Base/Reader.h>
 
@@ -67,9 +72,96 @@ AxisDefinition KukaIR500[6] = {
 };
 
 
+/**
+ * Keeps the KDL solvers of a kinematic chain so that they don't need to be
+ * created for every position. The solvers have internal state, so an
+ * instance must not be used by several threads at the same time.
+ */
+class Robot6Axis::IkSolver
+{
+public:
+    IkSolver(const Chain& chain, const JntArray& min, const JntArray& max)
+      : fksolver(chain)
+      , iksolverv(chain)
+      , iksolver(chain,min,max,fksolver,iksolverv,100,1e-6) //Maximum 100 iterations, stop at accuracy 1e-6
+      , jacsolver(chain)
+      , jacobian(chain.getNrOfJoints())
+      , min(min)
+      , max(max)
+    {
+    }
+
+    bool solve(const JntArray& start, const Frame& dest, JntArray& result)
+    {
+        return iksolver.CartToJnt(start,dest,result) >= 0;
+    }
+
+    bool inLimits(const JntArray& q) const
+    {
+        for (unsigned int i=0; i<q.rows(); i++) {
+            if (q(i) < min(i) || q(i) > max(i))
+                return false;
+        }
+        return true;
+    }
+
+    bool isSingular(const JntArray& q)
+    {
+        if (jacsolver.JntToJac(q,jacobian) < 0)
+            return true;
+        // the same threshold as used by ChainIkSolverVel_pinv to
+        // consider a singular value to be zero
+        Eigen::JacobiSVD< Eigen::Matrix<double,6,Eigen::Dynamic> > svd(jacobian.data);
+        const Eigen::VectorXd& sigma = svd.singularValues();
+        return sigma.size() < 6 || sigma(sigma.size()-1) < 0.00001;
+    }
+
+    struct Range {
+        const Robot6Axis* robot;
+        std::vector<Base::Placement>::const_iterator first, last;
+        std::vector<AxisSolution>::iterator result;
+    };
+
+    static void solveRange(Range& range)
+    {
+        const Robot6Axis* rob = range.robot;
+        IkSolver solver(rob->Kinematic,rob->Min,rob->Max);
+        JntArray start = rob->Actuall;
+        JntArray result(rob->Kinematic.getNrOfJoints());
+
+        std::vector<AxisSolution>::iterator jt = range.result;
+        for (std::vector<Base::Placement>::const_iterator it = range.first; it != range.last; ++it, ++jt) {
+            AxisSolution& sol = *jt;
+            sol.Reached = solver.solve(start,toFrame(*it),result);
+            if (sol.Reached) {
+                // warm start for the next position
+                start = result;
+            }
+            else {
+                result = start;
+            }
+
+            sol.InLimits = solver.inLimits(result);
+            sol.Singular = solver.isSingular(result);
+            for (int i=0; i<6; i++)
+                sol.Axis[i] = rob->RotDir[i] * (result(i)/(M_PI/180)); // radian to degree
+        }
+    }
+
+private:
+    ChainFkSolverPos_recursive fksolver; //Forward position solver
+    ChainIkSolverVel_pinv iksolverv;     //Inverse velocity solver
+    ChainIkSolverPos_NR_JL iksolver;
+    ChainJntToJacSolver jacsolver;
+    Jacobian jacobian;
+    JntArray min;
+    JntArray max;
+};
+
 TYPESYSTEM_SOURCE(Robot::Robot6Axis , Base::Persistence);
 
 Robot6Axis::Robot6Axis()
+  : solver(0)
 {
     // create joint array for the min and max angle values of each joint
     Min = JntArray(6);
@@ -82,8 +174,46 @@ Robot6Axis::Robot6Axis()
     setKinematic(KukaIR500);
 }
 
+Robot6Axis::Robot6Axis(const Robot6Axis& rob)
+  : Base::Persistence()
+  , solver(0)
+{
+    *this = rob;
+}
+
 Robot6Axis::~Robot6Axis()
 {
+    delete solver;
+}
+
+Robot6Axis& Robot6Axis::operator = (const Robot6Axis& rob)
+{
+    if (this == &rob)
+        return *this;
+    Kinematic = rob.Kinematic;
+    Actuall = rob.Actuall;
+    Min = rob.Min;
+    Max = rob.Max;
+    Tcp = rob.Tcp;
+    for (int i=0; i<6; i++) {
+        Velocity[i] = rob.Velocity[i];
+        RotDir[i] = rob.RotDir[i];
+    }
+    resetSolver();
+    return *this;
+}
+
+Robot6Axis::IkSolver* Robot6Axis::getSolver()
+{
+    if (!solver)
+        solver = new IkSolver(Kinematic,Min,Max);
+    return solver;
+}
+
+void Robot6Axis::resetSolver()
+{
+    delete solver;
+    solver = 0;
 }
 
 
@@ -102,6 +232,7 @@ void Robot6Axis::setKinematic(const AxisDefinition KinDef[6])
 
 	// for now and testing
     Kinematic = temp;
+    resetSolver();
 
 	// get the actuall TCP out of tha axis
 	calcTcp();
@@ -225,6 +356,7 @@ void Robot6Axis::Restore(XMLReader &reader)
         Actuall(i) = reader.getAttributeAsFloat("Pos");
     }
     Kinematic = Temp;
+    resetSolver();
 
     calcTcp();
 
@@ -234,11 +366,6 @@ void Robot6Axis::Restore(XMLReader &reader)
 
 bool Robot6Axis::setTo(const Placement &To)
 {
-	//Creation of the solvers:
-	ChainFkSolverPos_recursive fksolver1(Kinematic);//Forward position solver
-	ChainIkSolverVel_pinv iksolver1v(Kinematic);//Inverse velocity solver
-	ChainIkSolverPos_NR_JL iksolver1(Kinematic,Min,Max,fksolver1,iksolver1v,100,1e-6);//Maximum 100 iterations, stop at accuracy 1e-6
-	 
 	//Creation of jntarrays:
 	JntArray result(Kinematic.getNrOfJoints());
 	 
@@ -246,7 +373,7 @@ bool Robot6Axis::setTo(const Placement &To)
 	Frame F_dest = Frame(KDL::Rotation::Quaternion(To.getRotation()[0],To.getRotation()[1],To.getRotation()[2],To.getRotation()[3]),KDL::Vector(To.getPosition()[0],To.getPosition()[1],To.getPosition()[2]));
 	 
 	// solve
-	if(iksolver1.CartToJnt(Actuall,F_dest,result) < 0)
+	if(!getSolver()->solve(Actuall,F_dest,result))
 		return false;
 	else{
 		Actuall = result;
@@ -255,6 +382,37 @@ bool Robot6Axis::setTo(const Placement &To)
 	}
 }
 
+std::vector<AxisSolution> Robot6Axis::calcAxis(const std::vector<Base::Placement> &Positions, int numThreads) const
+{
+    std::vector<AxisSolution> solutions(Positions.size());
+    if (numThreads <= 0)
+        numThreads = QThread::idealThreadCount();
+    numThreads = std::max(1, std::min<int>(numThreads, static_cast<int>(Positions.size())));
+
+    std::vector<IkSolver::Range> ranges(numThreads);
+    std::size_t rangeSize = Positions.size() / numThreads;
+    std::size_t remainder = Positions.size() % numThreads;
+    std::size_t pos = 0;
+    for (int i=0; i<numThreads; i++) {
+        std::size_t count = rangeSize + (static_cast<std::size_t>(i) < remainder ? 1 : 0);
+        ranges[i].robot = this;
+        ranges[i].first = Positions.begin() + pos;
+        ranges[i].last = Positions.begin() + pos + count;
+        ranges[i].result = solutions.begin() + pos;
+        pos += count;
+    }
+
+    if (ranges.size() == 1) {
+        IkSolver::solveRange(ranges.front());
+    }
+    else {
+        QFuture<void> future = QtConcurrent::map(ranges, &IkSolver::solveRange);
+        future.waitForFinished();
+    }
+
+    return solutions;
+}
+
 Base::Placement Robot6Axis::getTcp(void)
 {
 	double x,y,z,w;
@@ -27,6 +27,8 @@
 #include "kdl_cp/chain.hpp"
 #include "kdl_cp/jntarray.hpp"
 
+#include <vector>
+
 #include <Base/Persistence.h>
 #include <Base/Placement.h>
 
@@ -45,6 +47,14 @@ struct AxisDefinition {
     double velocity; // max vlocity of the axle in °/s
 };
 
+/// Result of the inverse kinematics for a single position
+struct AxisSolution {
+    double Axis[6];  // axis angles in °
+    bool Reached;    // the solver converged to the position
+    bool InLimits;   // all axis are within their soft ends
+    bool Singular;   // the jacobian has a (near) zero singular value
+};
+
 
 /** The representation for a 6-Axis industry grade robot
  */
@@ -54,8 +64,11 @@ class RobotExport Robot6Axis : public Base::Persistence
 
 public:
     Robot6Axis();
+    Robot6Axis(const Robot6Axis&);
     ~Robot6Axis();
 
+    Robot6Axis& operator = (const Robot6Axis&);
+
 	// from base class
     virtual unsigned int getMemSize (void) const;
 	virtual void Save (Base::Writer &/*writer*/) const;
@@ -69,6 +82,14 @@ public:
     
     /// set the robot to that position, calculates the Axis
 	bool setTo(const Base::Placement &To);
+    /** Calculates the axis for each of the positions without changing the robot.
+     * The positions are split into \a numThreads chunks which are solved in
+     * parallel, 0 means one chunk per processor core. Inside a chunk the solver
+     * starts from the solution of the previous position and the first position
+     * of a chunk from the current axis of the robot. So, with a single chunk the
+     * result is the same as calling setTo() for each position in turn.
+     */
+    std::vector<AxisSolution> calcAxis(const std::vector<Base::Placement> &Positions, int numThreads = 1) const;
 	bool setAxis(int Axis,double Value);
 	double getAxis(int Axis);
     double getMaxAngle(int Axis);
@@ -90,6 +111,12 @@ protected:
 	double Velocity[6];
 	double RotDir  [6];
 
+private:
+    // the solvers are kept as long as the kinematic doesn't change
+    class IkSolver;
+    IkSolver* getSolver();
+    void resetSolver();
+    IkSolver* solver;
 };
 
 } //namespace Part
@@ -76,6 +76,42 @@ PyObject* Robot6AxisPy::check(PyObject * /*args*/)
     return 0;
 }
 
+PyObject* Robot6AxisPy::calcAxis(PyObject * args)
+{
+    PyObject *list;
+    int threads = 1;
+    if (!PyArg_ParseTuple(args, "O|i", &list, &threads))
+        return NULL;
+
+    std::vector<Base::Placement> positions;
+    Py::Sequence seq(list);
+    positions.reserve(seq.size());
+    for (Py::Sequence::iterator it = seq.begin(); it != seq.end(); ++it) {
+        if (!PyObject_TypeCheck((*it).ptr(), &(Base::PlacementPy::Type))) {
+            PyErr_SetString(PyExc_TypeError, "list of placements expected");
+            return NULL;
+        }
+        positions.push_back(*static_cast<Base::PlacementPy*>((*it).ptr())->getPlacementPtr());
+    }
+
+    std::vector<AxisSolution> solutions = getRobot6AxisPtr()->calcAxis(positions, threads);
+
+    Py::List result;
+    for (std::vector<AxisSolution>::iterator it = solutions.begin(); it != solutions.end(); ++it) {
+        Py::Tuple axis(6);
+        for (int i=0; i<6; i++)
+            axis.setItem(i, Py::Float(it->Axis[i]));
+        Py::Tuple item(4);
+        item.setItem(0, axis);
+        item.setItem(1, Py::Boolean(it->Reached));
+        item.setItem(2, Py::Boolean(it->InLimits));
+        item.setItem(3, Py::Boolean(it->Singular));
+        result.append(item);
+    }
+
+    return Py::new_reference_to(result);
+}
+
 
 
 Py::Float Robot6AxisPy::getAxis1(void) const
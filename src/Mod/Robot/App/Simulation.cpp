@@ -97,6 +97,17 @@ void Simulation::setToTime(float t)
 
 }
 
+std::vector<AxisSolution> Simulation::calcAxis(const std::vector<double> &Times, int numThreads) const
+{
+    std::vector<Base::Placement> positions;
+    positions.reserve(Times.size());
+    Base::Placement toolInv = Tool.inverse();
+    for (std::vector<double>::const_iterator it = Times.begin(); it != Times.end(); ++it)
+        positions.push_back(Trac.getPosition(*it) * toolInv);
+
+    return Rob.calcAxis(positions, numThreads);
+}
+
 void Simulation::reset(void)
 {
     Rob.setAxis(0,startAxis[0]);
@@ -57,6 +57,8 @@ public:
     void setToTime(float t);
     // apply the start axis angles and set to time 0. Restors the exact start position
     void reset(void);
+    /// calculates the axis for the given times without moving the robot, see Robot6Axis::calcAxis()
+    std::vector<AxisSolution> calcAxis(const std::vector<double> &Times, int numThreads = 1) const;
 
 	double Pos;
 	double Axis[6];
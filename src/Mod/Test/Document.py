@@ -156,6 +156,35 @@ class DocumentBasicCases(unittest.TestCase):
   def testMem(self):
     self.Doc.MemSize
 
+  def testPropertyLookup(self):
+    obj = self.Doc.addObject("App::FeaturePython","Label_3")
+    for i in range(20):
+      obj.addProperty("App::PropertyFloat", "Float%d" % i, "Group%d" % i, "Doc%d" % i)
+    # dynamic properties
+    self.failUnless(obj.getGroupOfProperty("Float7") == "Group7")
+    self.failUnless(obj.getDocumentationOfProperty("Float7") == "Doc7")
+    self.failUnless(obj.getPropertyByName("Float7") == 0.0)
+    # static properties of the class and its base classes
+    self.failUnless(obj.getGroupOfProperty("Label") == "Base")
+    self.failUnless("Label" in obj.PropertiesList)
+    obj.removeProperty("Float7")
+    self.failUnless(not "Float7" in obj.PropertiesList)
+    self.failUnless(obj.getGroupOfProperty("Float8") == "Group8")
+
+  def testTypeHierarchy(self):
+    grp = self.Doc.addObject("App::DocumentObjectGroup","Group")
+    self.failUnless(grp.isDerivedFrom("App::DocumentObjectGroup"))
+    self.failUnless(grp.isDerivedFrom("App::DocumentObject"))
+    self.failUnless(grp.isDerivedFrom("Base::Persistence"))
+    self.failUnless(not grp.isDerivedFrom("App::DocumentObjectGroupPython"))
+    self.failUnless(not grp.isDerivedFrom("App::Property"))
+    self.failUnless(not grp.isDerivedFrom("NoSuchType"))
+    # the type itself and the types derived from it
+    types = grp.getAllDerivedFrom()
+    self.failUnless("App::DocumentObjectGroup" in types)
+    self.failUnless("App::DocumentObjectGroupPython" in types)
+    self.failUnless(not "App::DocumentObject" in types)
+
   def testAddRemove(self):
     L1 = self.Doc.addObject("App::FeatureTest","Label_1")
     # must delete object
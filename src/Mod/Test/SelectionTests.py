@@ -0,0 +1,77 @@
+# Selection test module
+# (c) 2017 FreeCAD Developers
+#
+
+#***************************************************************************
+#*   (c) FreeCAD Developers 2017                                           *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************/
+
+import FreeCAD, FreeCADGui, time, unittest
+
+class SelectionCounter:
+    def __init__(self):
+        self.added = 0
+        self.removed = 0
+    def addSelection(self, doc, obj, sub, pnt):
+        self.added += 1
+    def removeSelection(self, doc, obj, sub):
+        self.removed += 1
+
+class SelectionBatchCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("SelectionTest")
+        self.Obj = self.Doc.addObject("App::FeatureTest","Feature")
+        FreeCADGui.Selection.clearSelection()
+        self.Counter = SelectionCounter()
+        FreeCADGui.Selection.addObserver(self.Counter)
+
+    def testLargeBatch(self):
+        count = 100000
+        names = ["Face%d" % (i+1) for i in range(count)]
+
+        start = time.time()
+        FreeCADGui.Selection.addSelection(self.Obj, names)
+        added = time.time() - start
+        sel = FreeCADGui.Selection.getSelectionEx(self.Doc.Name)
+        self.failUnless(len(sel) == 1, "Selected object missing")
+        self.failUnless(len(sel[0].SubElementNames) == count, "Selected sub-elements missing")
+        # observers that do not handle the batch get one message per sub-element
+        self.failUnless(self.Counter.added == count, "Wrong number of add notifications")
+
+        # sub-elements that are already selected are skipped
+        FreeCADGui.Selection.addSelection(self.Obj, names[:10])
+        self.failUnless(self.Counter.added == count, "Selected sub-elements notified again")
+
+        start = time.time()
+        FreeCADGui.Selection.removeSelection(self.Obj, names[::2])
+        removed = time.time() - start
+        sel = FreeCADGui.Selection.getSelectionEx(self.Doc.Name)
+        self.failUnless(len(sel[0].SubElementNames) == count / 2, "Sub-elements not removed")
+        self.failUnless(sel[0].SubElementNames[0] == names[1], "Selection order not kept")
+        self.failUnless(self.Counter.removed == count / 2, "Wrong number of remove notifications")
+
+        FreeCAD.Console.PrintMessage("Selection of %d sub-elements: add %.3f s, remove %d %.3f s\n" % (count, added, count / 2, removed))
+
+    def tearDown(self):
+        FreeCADGui.Selection.removeObserver(self.Counter)
+        FreeCADGui.Selection.clearSelection()
+        FreeCAD.closeDocument("SelectionTest")
@@ -63,7 +63,8 @@ def All():
     # Base system gui test
     if (FreeCAD.GuiUp == 1):
         tests += [ "Workbench",
-                   "Menu" ]
+                   "Menu",
+                   "SelectionTests" ]
 
     # add the module tests
     tests += [ "TestFem",
@@ -72,6 +73,7 @@ def All():
                "TestPartApp",
                "TestPartDesignApp",
                "TestSpreadsheet",
+               "TestWebApp",
                "TestTechDrawApp" ]
 
     # gui tests of modules
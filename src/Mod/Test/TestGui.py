@@ -58,6 +58,7 @@ class TestCmd:
         QtUnitGui.addTest("TestArch")
         QtUnitGui.addTest("TestTechDrawApp")
         QtUnitGui.addTest("Workbench")
+        QtUnitGui.addTest("SelectionTests")
         QtUnitGui.addTest("Menu")
         QtUnitGui.addTest("Menu.MenuDeleteCases")
         QtUnitGui.addTest("Menu.MenuCreateCases")
@@ -29,6 +29,7 @@
 #endif
 
 #include <Base/Console.h>
+#include <App/Application.h>
 
 #include <CXX/Extensions.hxx>
 #include <CXX/Objects.hxx>
@@ -69,7 +70,14 @@ public:
     Module() : Py::ExtensionModule<Module>("Web")
     {
         add_varargs_method("startServer",&Module::startServer,
-            "startServer(address=127.0.0.1,port=0) -- Start a server."
+            "startServer(address=127.0.0.1,port=0,threads=0,queue=16) -- Start a server.\n"
+            "If threads is greater than 0 each request runs as a job in a pool of\n"
+            "this many threads with its own namespace and a new document 'doc'.\n"
+            "At most 'queue' jobs wait for a thread, further requests are rejected.\n"
+            "This is only supported in console mode."
+        );
+        add_varargs_method("write",&Module::write,
+            "write(string) -- Send text to the client of the server job running in this thread."
         );
         add_varargs_method("registerServerFirewall",&Module::registerServerFirewall,
             "registerServerFirewall(callable(string)) -- Register a firewall."
@@ -84,7 +92,9 @@ private:
     {
         const char* addr = "127.0.0.1";
         int port=0;
-        if (!PyArg_ParseTuple(args.ptr(), "|si",&addr,&port))
+        int threads=0;
+        int queue=16;
+        if (!PyArg_ParseTuple(args.ptr(), "|siii",&addr,&port,&threads,&queue))
             throw Py::Exception();
         if (port > USHRT_MAX) {
             throw Py::OverflowError("port number is greater than maximum");
@@ -92,8 +102,15 @@ private:
         else if (port < 0) {
             throw Py::OverflowError("port number is lower than 0");
         }
+        if (threads < 0 || queue < 0) {
+            throw Py::ValueError("number of threads and queue size must not be negative");
+        }
+        if (threads > 0 && App::Application::Config()["RunMode"] == "Gui") {
+            // the documents of the jobs would be changed outside the GUI thread
+            throw Py::RuntimeError("server jobs are not supported in GUI mode");
+        }
 
-        AppServer* server = new AppServer();
+        AppServer* server = threads > 0 ? new AppServer(threads, queue) : new AppServer();
         if (server->listen(QHostAddress(QString::fromLatin1(addr)), port)) {
             QString a = server->serverAddress().toString();
             quint16 p = server->serverPort();
@@ -110,6 +127,17 @@ private:
         }
     }
 
+    Py::Object write(const Py::Tuple& args)
+    {
+        const char* text;
+        if (!PyArg_ParseTuple(args.ptr(), "s",&text))
+            throw Py::Exception();
+
+        if (!ServerJob::write(QByteArray(text)))
+            throw Py::RuntimeError("not called from a server job");
+        return Py::None();
+    }
+
     Py::Object registerServerFirewall(const Py::Tuple& args)
     {
         PyObject* obj;
@@ -25,11 +25,15 @@
 
 #include <QCoreApplication>
 #include <QTcpSocket>
+#include <QThreadStorage>
 #include <stdexcept>
 
 #include "Server.h"
+#include <Base/Console.h>
 #include <Base/Exception.h>
 #include <Base/Interpreter.h>
+#include <App/Application.h>
+#include <App/Document.h>
 
 using namespace Web;
 
@@ -109,11 +113,144 @@ const QByteArray& ServerEvent::request() const
 
 // ----------------------------------------------------------------------------
 
+JobEvent::JobEvent(int id, const QByteArray& msg, bool finished, qint64 runTime)
+  : QEvent(EventType), id(id), text(msg), finished(finished), time(runTime)
+{
+}
+
+JobEvent::~JobEvent()
+{
+}
+
+int JobEvent::job() const
+{
+    return id;
+}
+
+const QByteArray& JobEvent::answer() const
+{
+    return text;
+}
+
+bool JobEvent::isFinished() const
+{
+    return finished;
+}
+
+qint64 JobEvent::runTime() const
+{
+    return time;
+}
+
+// ----------------------------------------------------------------------------
+
+namespace Web {
+struct CurrentJob {
+    AppServer* server;
+    int id;
+    CurrentJob() : server(0), id(0) {}
+};
+}
+
+static QThreadStorage<CurrentJob> currentJob;
+
+ServerJob::ServerJob(AppServer* server, int id, const QByteArray& request, const std::string& document)
+  : server(server), id(id), request(request), document(document)
+{
+}
+
+ServerJob::~ServerJob()
+{
+}
+
+bool ServerJob::write(const QByteArray& msg)
+{
+    const CurrentJob& job = currentJob.localData();
+    if (!job.server)
+        return false;
+    QCoreApplication::postEvent(job.server, new JobEvent(job.id, msg, false));
+    return true;
+}
+
+void ServerJob::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    CurrentJob job;
+    job.server = server;
+    job.id = id;
+    currentJob.setLocalData(job);
+
+    std::string str;
+    {
+        Base::PyGILStateLocker lock;
+        try {
+            // each job gets its own namespace so that jobs don't see
+            // the variables of each other
+            Py::Dict dict;
+            dict.setItem("__builtins__", Py::Object(PyEval_GetBuiltins()));
+            App::Document* doc = App::GetApplication().getDocument(document.c_str());
+            if (doc)
+                dict.setItem("doc", Py::asObject(doc->getPyObject()));
+
+            PyObject* presult = PyRun_String(request.constData(), Py_file_input, dict.ptr(), dict.ptr());
+            if (!presult)
+                throw Base::PyException();
+            Py::Object result = Py::asObject(presult);
+            str = (std::string)result.repr();
+        }
+        catch (Base::PyException &e) {
+            str = e.what();
+            str += "\n\n";
+            str += e.getStackTrace();
+        }
+        catch (Base::Exception &e) {
+            str = e.what();
+        }
+        catch (Py::Exception&) {
+            Base::PyException e;
+            str = e.what();
+        }
+        catch (std::exception &e) {
+            str = e.what();
+        }
+        catch (...) {
+            str = "Unknown exception thrown";
+        }
+    }
+
+    currentJob.setLocalData(CurrentJob());
+    QCoreApplication::postEvent(server, new JobEvent(id, QByteArray(str.c_str()), true, timer.elapsed()));
+}
+
+// ----------------------------------------------------------------------------
+
 AppServer::AppServer(QObject* parent)
-  : QTcpServer(parent)
+  : QTcpServer(parent), pool(0), maxQueued(0), nextJob(0)
 {
 }
 
+AppServer::AppServer(int threads, int maxQueued, QObject* parent)
+  : QTcpServer(parent), pool(0), maxQueued(maxQueued), nextJob(0)
+{
+    pool = new QThreadPool(this);
+    pool->setMaxThreadCount(threads);
+}
+
+AppServer::~AppServer()
+{
+    if (pool)
+        pool->waitForDone();
+
+    // the events of the last jobs are not delivered any more
+    if (!jobs.empty()) {
+        Base::PyGILStateLocker lock;
+        for (std::map<int, Job>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+            App::GetApplication().closeDocument(it->second.document.c_str());
+    }
+}
+
 void AppServer::incomingConnection(int socket)
 {
     QTcpSocket* s = new QTcpSocket(this);
@@ -143,10 +280,23 @@ void AppServer::discardClient()
 
 void AppServer::customEvent(QEvent* e)
 {
+    if (e->type() == JobEvent::EventType) {
+        writeJob(static_cast<JobEvent*>(e));
+        return;
+    }
+
     ServerEvent* ev = static_cast<ServerEvent*>(e);
     QByteArray msg = ev->request();
     QTcpSocket* socket = ev->socket();
 
+    if (pool)
+        queueJob(socket, msg);
+    else
+        runRequest(socket, msg);
+}
+
+void AppServer::runRequest(QTcpSocket* socket, const QByteArray& msg)
+{
     std::string str;
 
     try {
@@ -175,4 +325,91 @@ void AppServer::customEvent(QEvent* e)
     socket->close();
 }
 
+void AppServer::queueJob(QTcpSocket* socket, const QByteArray& msg)
+{
+    std::string str;
+
+    try {
+        if (static_cast<int>(jobs.size()) >= pool->maxThreadCount() + maxQueued) {
+            str = "Server busy";
+        }
+        else {
+            Firewall* fw = Firewall::getInstance();
+            if (!fw || fw->filter(msg)) {
+                // the documents are only created and closed in the main thread
+                // while holding the GIL so that this never happens while a job
+                // runs Python code
+                Base::PyGILStateLocker lock;
+                createJob(socket, msg);
+                return;
+            }
+            else {
+                str = "Command blocked";
+            }
+        }
+    }
+    catch (Base::Exception &e) {
+        str = e.what();
+    }
+    catch (std::exception &e) {
+        str = e.what();
+    }
+    catch (...) {
+        str = "Unknown exception thrown";
+    }
+
+    socket->write(str.c_str());
+    socket->close();
+}
+
+void AppServer::createJob(QTcpSocket* socket, const QByteArray& msg)
+{
+    // newDocument() makes the new document the active one, but the job
+    // document must not replace the document the user is working on
+    App::Application& app = App::GetApplication();
+    App::Document* active = app.getActiveDocument();
+    App::Document* doc = app.newDocument("WebJob");
+    std::string name = doc->getName();
+    app.setActiveDocument(active);
+
+    int id = ++nextJob;
+    try {
+        Job& job = jobs[id];
+        job.socket = socket;
+        job.document = name;
+        job.latency.start();
+        pool->start(new ServerJob(this, id, msg, name));
+    }
+    catch (...) {
+        jobs.erase(id);
+        app.closeDocument(name.c_str());
+        throw;
+    }
+}
+
+void AppServer::writeJob(const JobEvent* ev)
+{
+    std::map<int, Job>::iterator it = jobs.find(ev->job());
+    if (it == jobs.end())
+        return;
+
+    // the client may have disconnected in the meantime
+    QTcpSocket* socket = it->second.socket;
+    if (socket)
+        socket->write(ev->answer());
+
+    if (ev->isFinished()) {
+        if (socket)
+            socket->close();
+
+        qint64 latency = it->second.latency.elapsed();
+        Base::Console().Log("Web server job %d: waited %d ms, ran %d ms\n", ev->job(),
+            static_cast<int>(latency - ev->runTime()), static_cast<int>(ev->runTime()));
+
+        Base::PyGILStateLocker lock;
+        App::GetApplication().closeDocument(it->second.document.c_str());
+        jobs.erase(it);
+    }
+}
+
 #include "moc_Server.cpp"
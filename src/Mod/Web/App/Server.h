@@ -25,11 +25,17 @@
 #define WEB_SERVER_H
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QEvent>
+#include <QPointer>
+#include <QRunnable>
 #include <QTcpSocket>
 #include <QTcpServer>
+#include <QThreadPool>
 #include <CXX/Objects.hxx>
+#include <map>
+#include <string>
 
 
 namespace Web {
@@ -74,8 +80,62 @@ private:
     QByteArray text;
 };
 
+/**
+ * The JobEvent class sends a part of the answer of a server job to the
+ * main thread. The last part is sent with the finished flag set.
+ */
+class JobEvent : public QEvent
+{
+public:
+    static const QEvent::Type EventType = QEvent::Type(QEvent::User + 1);
+
+    JobEvent(int id, const QByteArray&, bool finished, qint64 runTime = 0);
+    ~JobEvent();
+
+    int job() const;
+    const QByteArray& answer() const;
+    bool isFinished() const;
+    /// the time in ms the job has been running, only set for the last part
+    qint64 runTime() const;
+
+private:
+    int id;
+    QByteArray text;
+    bool finished;
+    qint64 time;
+};
+
+class AppServer;
+
+/**
+ * The ServerJob class runs a request in a worker thread of the server.
+ * The request is executed in its own namespace where the variable 'doc'
+ * refers to a document that has been created for this job only.
+ */
+class ServerJob : public QRunnable
+{
+public:
+    ServerJob(AppServer* server, int id, const QByteArray& request, const std::string& document);
+    ~ServerJob();
+
+    void run();
+
+    /// sends text to the client of the job that runs in the calling thread
+    static bool write(const QByteArray&);
+
+private:
+    AppServer* server;
+    int id;
+    QByteArray request;
+    std::string document;
+};
+
 /** 
  * The Server class implements a simple TCP server.
+ * By default the requests are run one after another in the main thread.
+ * If a number of threads is given they are run as jobs by a pool of
+ * worker threads instead, see ServerJob. At most \a maxQueued jobs wait
+ * for a free thread, further requests are rejected until jobs are done.
  */
 class AppServer : public QTcpServer
 {
@@ -83,17 +143,35 @@ class AppServer : public QTcpServer
 
 public:
     AppServer(QObject* parent = 0);
+    AppServer(int threads, int maxQueued, QObject* parent = 0);
+    ~AppServer();
 
     void incomingConnection(int socket);
 
 protected:
     void customEvent(QEvent* e);
 
+private:
+    void runRequest(QTcpSocket* socket, const QByteArray& msg);
+    void queueJob(QTcpSocket* socket, const QByteArray& msg);
+    void createJob(QTcpSocket* socket, const QByteArray& msg);
+    void writeJob(const JobEvent* ev);
+
 private Q_SLOTS:
     void readClient();
     void discardClient();
 
 private:
+    struct Job {
+        QPointer<QTcpSocket> socket;
+        std::string document;
+        QElapsedTimer latency;
+    };
+
+    QThreadPool* pool;
+    int maxQueued;
+    int nextJob;
+    std::map<int, Job> jobs;
 };
 
 }
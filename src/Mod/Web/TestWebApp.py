@@ -0,0 +1,92 @@
+# Web server test module
+# (c) 2017 FreeCAD Developers
+#
+
+#***************************************************************************
+#*   (c) FreeCAD Developers 2017                                           *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************/
+
+import FreeCAD, socket, threading, time, unittest
+
+#---------------------------------------------------------------------------
+# define the test cases of the Web server
+#---------------------------------------------------------------------------
+
+class WebServerJobCases(unittest.TestCase):
+    def setUp(self):
+        # the server answers from the Qt event loop of the main thread
+        from PySide import QtCore
+        self.app = QtCore.QCoreApplication.instance()
+        if not self.app:
+            self.app = QtCore.QCoreApplication([])
+        self.Doc = FreeCAD.newDocument("WebTest")
+
+    def submit(self, address, port, message, answers, index):
+        sock = socket.create_connection((address, port))
+        try:
+            sock.sendall(message)
+            data = []
+            while True:
+                chunk = sock.recv(1024)
+                if not chunk:
+                    break
+                data.append(chunk)
+            answers[index] = "".join(data)
+        finally:
+            sock.close()
+
+    @unittest.skipIf(FreeCAD.GuiUp, "server jobs are only supported in console mode")
+    def testConcurrentJobs(self):
+        import Web
+        address, port = Web.startServer("127.0.0.1", 0, 4, 32)
+
+        count = 16
+        answers = [None] * count
+        clients = []
+        for i in range(count):
+            msg = "import Web\nWeb.write('{0}:' + doc.Name + ':' + str(sum(range({1}))))\n".format(i, 10000 * (i + 1))
+            client = threading.Thread(target=self.submit, args=(address, port, msg, answers, i))
+            client.start()
+            clients.append(client)
+
+        deadline = time.time() + 60
+        while any(c.is_alive() for c in clients) and time.time() < deadline:
+            self.app.processEvents()
+            time.sleep(0.01)
+        for c in clients:
+            c.join(1)
+
+        for i in range(count):
+            self.failUnless(answers[i] is not None, "No answer to job {0}".format(i))
+            # the text written by the job followed by the result of the script
+            index, name, value = answers[i].split(":")
+            self.failUnless(index == str(i))
+            self.failUnless(name.startswith("WebJob"))
+            self.failUnless(value == str(sum(range(10000 * (i + 1)))) + "None")
+
+        # the job documents are closed and never become the active document
+        self.failUnless(FreeCAD.ActiveDocument.Name == self.Doc.Name)
+        for name in FreeCAD.listDocuments().keys():
+            self.failIf(name.startswith("WebJob"))
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)